@@ -0,0 +1,724 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Constants.hpp"
+#include "FaultInjector.hpp"
+#include "LatencyHistogram.hpp"
+#include "RequestFactory.hpp"
+#include "RequestIdentity.hpp"
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "Serializer.hpp"
+#include "Socket.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @brief Load generator that drives a mix of operations against a running server.
+ *
+ * In the closed-loop mode a fixed number of requests is kept in flight, and each reply or give-up sends
+ * the next request. In the open-loop mode requests are sent at Poisson-distributed arrival times with a
+ * fixed mean rate, whether or not earlier requests have been answered, and latency is measured from the
+ * scheduled arrival time so that a slow server is not hidden by the generator falling behind.
+ *
+ * Requests are retransmitted with their original bytes, as the Client does, after a fixed timeout and given
+ * up after MAX_RETRIES attempts. Queries, updates and deletions of bookings use bookings made earlier in the
+ * run, and are replaced by bookings while there are none.
+ *
+ * With any of the impairment options, the traffic passes through a FaultInjector that impairs both
+ * directions alike, so that goodput and tail latency can be measured under loss and jitter on one machine.
+ *
+ * Usage: loadgen [--host HOST] [--port PORT] [--mode closed|open] [--concurrency N] [--rate REQ_PER_SEC]
+ *                [--duration SECONDS] [--timeout-ms MILLIS] [--mix OP=WEIGHT,...] [--facility NAME]
+ *                [--days DAY,...] [--seed SEED]
+ *                [--drop P] [--loss-burst N] [--duplicate P] [--corrupt P] [--reorder P] [--delay-ms MILLIS]
+ *                [--jitter-ms MILLIS] [--jitter-dist uniform|normal|exponential] [--fault-seed SEED]
+ *
+ * Operations of the mix: names, availability, book, query, update, delete, rate, echo.
+ */
+
+/**
+ * @enum Operation
+ * @brief Operations the load generator can send.
+ */
+enum Operation
+{
+    NAMES,
+    AVAILABILITY,
+    BOOK,
+    QUERY_BOOKING,
+    UPDATE,
+    DELETE_BOOKING,
+    RATE,
+    ECHO,
+    OPERATION_COUNT
+};
+
+/**
+ * @brief Names of the operations, as used in the mix and the report.
+ */
+const std::array<std::string, OPERATION_COUNT> OPERATION_NAMES = {
+    "names", "availability", "book", "query", "update", "delete", "rate", "echo"
+};
+
+/**
+ * @struct Options
+ * @brief Command line options of the load generator.
+ */
+struct Options
+{
+    std::string host = "127.0.0.1"; ///< Host of the server.
+    int port = 6789; ///< Port of the server.
+    bool openLoop = false; ///< Whether to send at a fixed rate instead of a fixed concurrency.
+    int concurrency = 1; ///< Requests in flight in the closed-loop mode.
+    double rate = 100; ///< Mean requests per second in the open-loop mode.
+    int durationSeconds = 10; ///< Duration of the run.
+    int timeoutMillis = 1000; ///< Time to wait for a reply before retransmitting.
+    std::array<double, OPERATION_COUNT> mix = {1, 3, 2, 2, 1, 1, 1, 1}; ///< Relative weight of each operation.
+    std::string facility = "Weekday1"; ///< Facility to query and book.
+    std::vector<DayOfWeek> days = {DayOfWeek::MONDAY, DayOfWeek::TUESDAY, DayOfWeek::WEDNESDAY}; ///< Days on which the facility is open.
+    unsigned int seed = std::random_device()(); ///< Seed of the random choices.
+    bool impaired = false; ///< Whether to pass the traffic through a FaultInjector.
+    FaultInjector::Impairment impairment; ///< Impairment of each direction.
+    uint64_t faultSeed = 1; ///< Seed of the impairment.
+};
+
+/**
+ * @class LoadGenerator
+ * @brief Sends requests from one socket and tracks them until they are answered or given up.
+ */
+class LoadGenerator
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Creates the socket and resolves the server address.
+     * @param options The options of the run.
+     */
+    explicit LoadGenerator(const Options &options)
+        : options(options), serverAddr(Socket::resolveAddress(options.host, options.port)), random(options.seed),
+          operationChoice(options.mix.begin(), options.mix.end()), nextRequestID(1), sent(0), retransmits(0),
+          unfinished(0), completed{}, serverErrors{}, timedOut{}
+    {
+        socket.create(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        socket.bind(0);
+    }
+
+    /**
+     * @brief Closes the socket.
+     */
+    ~LoadGenerator()
+    {
+        socket.closeSocket();
+    }
+
+    /**
+     * @brief Runs the load for the configured duration and prints the report.
+     */
+    void run()
+    {
+        auto start = Clock::now();
+        auto end = start + std::chrono::seconds(options.durationSeconds);
+        auto drainEnd = end + std::chrono::milliseconds(options.timeoutMillis);
+        std::exponential_distribution<double> interArrival(options.rate);
+        auto nextArrival = start;
+
+        if (!options.openLoop)
+        {
+            for (int i = 0; i < options.concurrency; ++i)
+            {
+                issue(start);
+            }
+        }
+
+        std::vector<char> recvBuffer(Constants::MAX_DATAGRAM_SIZE);
+
+        while (true)
+        {
+            auto now = Clock::now();
+            bool issuing = now < end;
+            if (!issuing && (inFlight.empty() || now >= drainEnd))
+            {
+                break;
+            }
+
+            while (options.openLoop && issuing && nextArrival <= now)
+            {
+                issue(nextArrival);
+                nextArrival += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interArrival(random)));
+            }
+
+            retransmitExpired(now, issuing);
+
+            // Sleep until the next arrival, retransmission or the end of the run, unless a reply comes first
+            auto wakeAt = issuing ? end : drainEnd;
+            if (options.openLoop && issuing)
+            {
+                wakeAt = std::min(wakeAt, nextArrival);
+            }
+            if (!deadlines.empty())
+            {
+                wakeAt = std::min(wakeAt, deadlines.top().first);
+            }
+            int waitMillis = static_cast<int>(std::max<int64_t>(0, std::chrono::ceil<std::chrono::milliseconds>(wakeAt - now).count()));
+
+            if (!socket.waitReadable(waitMillis))
+            {
+                continue;
+            }
+
+            do
+            {
+                struct sockaddr_in senderAddr;
+                int bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+                handleReply(recvBuffer.data(), bytesReceived, issuing);
+            } while (socket.waitReadable(0));
+        }
+
+        unfinished = static_cast<int64_t>(inFlight.size());
+        report(std::chrono::duration<double>(std::min(Clock::now(), end) - start).count());
+    }
+
+private:
+    /**
+     * @struct Request
+     * @brief A request in flight.
+     */
+    struct Request
+    {
+        Operation operation; ///< Operation of the request.
+        Clock::time_point intendedAt; ///< Time the request was scheduled, from which its latency is measured.
+        Clock::time_point deadline; ///< Time of the next retransmission.
+        int attempts; ///< Number of transmissions so far.
+        RequestIdentity identity; ///< Identity of the request.
+        std::vector<uint8_t> serializedData; ///< Bytes sent on every attempt.
+    };
+
+    Options options;
+    Socket socket;
+    struct sockaddr_in serverAddr;
+    std::mt19937 random;
+    std::discrete_distribution<int> operationChoice;
+    RequestIdentitySource identitySource;
+    int nextRequestID;
+    std::unordered_map<int, Request> inFlight;
+    std::priority_queue<std::pair<Clock::time_point, int>, std::vector<std::pair<Clock::time_point, int>>, std::greater<>> deadlines;
+    std::vector<ResponseParser::Booking> bookings; ///< Each booking made and not deleted, as parsed from its confirmation.
+
+    int64_t sent;
+    int64_t retransmits;
+    int64_t unfinished;
+    std::array<int64_t, OPERATION_COUNT> completed;
+    std::array<int64_t, OPERATION_COUNT> serverErrors;
+    std::array<int64_t, OPERATION_COUNT> timedOut;
+    std::array<LatencyHistogram, OPERATION_COUNT> latencies;
+
+    /**
+     * @brief Picks an operation, builds its request and sends it.
+     * @param intendedAt The time the request was scheduled.
+     */
+    void issue(Clock::time_point intendedAt)
+    {
+        Operation operation = static_cast<Operation>(operationChoice(random));
+        if ((operation == QUERY_BOOKING || operation == UPDATE || operation == DELETE_BOOKING) && bookings.empty())
+        {
+            operation = BOOK;
+        }
+
+        RequestMessage request = buildRequest(operation);
+
+        request.setRequestID(nextRequestID);
+        nextRequestID = nextRequestID == std::numeric_limits<int>::max() ? 1 : nextRequestID + 1;
+        request.setIdentity(identitySource.next());
+        request.setAckedSequence(identitySource.getAckedSequence());
+
+        Request &entry = inFlight[request.getRequestID()];
+        entry = {operation, intendedAt, Clock::now() + std::chrono::milliseconds(options.timeoutMillis), 1,
+                 request.getIdentity(), JavaSerializer::serialize(&request)};
+        deadlines.push({entry.deadline, request.getRequestID()});
+
+        socket.sendDataTo(entry.serializedData, serverAddr);
+        sent++;
+    }
+
+    /**
+     * @brief Builds the request of an operation with random arguments.
+     * @param operation The operation. Booking operations other than BOOK need a booking to act on.
+     * @return The request, without request ID and identity.
+     */
+    RequestMessage buildRequest(Operation operation)
+    {
+        DayOfWeek day = options.days[std::uniform_int_distribution<size_t>(0, options.days.size() - 1)(random)];
+
+        switch (operation)
+        {
+        case NAMES:
+            return RequestFactory::queryFacilityNames();
+        case AVAILABILITY:
+            return RequestFactory::queryAvailability(options.facility, Days::bit(day));
+        case BOOK:
+        {
+            int startHour = std::uniform_int_distribution<int>(8, 15)(random);
+            int startMinute = startHour * 60 + std::uniform_int_distribution<int>(0, 1)(random) * 30;
+            return RequestFactory::bookFacility(options.facility, day, *MinuteOfDay::fromMinutes(startMinute), *MinuteOfDay::fromMinutes(startMinute + 60));
+        }
+        case QUERY_BOOKING:
+            return RequestFactory::queryBooking(bookings[pickBooking()].bookingID);
+        case UPDATE:
+        case DELETE_BOOKING:
+        {
+            // The booking is taken out of the pool so that no other request acts on it concurrently
+            size_t index = pickBooking();
+            ResponseParser::Booking booking = std::move(bookings[index]);
+            bookings[index] = std::move(bookings.back());
+            bookings.pop_back();
+
+            if (operation == UPDATE)
+            {
+                int offsetMinutes = std::uniform_int_distribution<int>(0, 1)(random) == 0 ? -30 : 30;
+                return RequestFactory::updateBooking(booking, offsetMinutes);
+            }
+            return RequestFactory::deleteBooking(booking);
+        }
+        case RATE:
+            return RequestFactory::rateFacility(options.facility, static_cast<float>(std::uniform_int_distribution<int>(1, 5)(random)));
+        default:
+            return RequestFactory::echoMessage("loadgen");
+        }
+    }
+
+    /**
+     * @brief Picks a random booking from the pool.
+     * @return The index of the booking.
+     */
+    size_t pickBooking()
+    {
+        return std::uniform_int_distribution<size_t>(0, bookings.size() - 1)(random);
+    }
+
+    /**
+     * @brief Retransmits the requests whose deadline has passed, or gives them up after MAX_RETRIES attempts.
+     * @param now The current time.
+     * @param issuing Whether new requests may still be sent.
+     */
+    void retransmitExpired(Clock::time_point now, bool issuing)
+    {
+        while (!deadlines.empty() && deadlines.top().first <= now)
+        {
+            auto [deadline, requestID] = deadlines.top();
+            deadlines.pop();
+
+            auto it = inFlight.find(requestID);
+            if (it == inFlight.end() || it->second.deadline != deadline)
+            {
+                continue; // Answered, or rescheduled by an earlier retransmission
+            }
+
+            Request &request = it->second;
+            if (request.attempts < Constants::MAX_RETRIES)
+            {
+                request.attempts++;
+                request.deadline = now + std::chrono::milliseconds(options.timeoutMillis);
+                deadlines.push({request.deadline, requestID});
+                socket.sendDataTo(request.serializedData, serverAddr);
+                retransmits++;
+                continue;
+            }
+
+            timedOut[request.operation]++;
+            identitySource.complete(request.identity.sequence);
+            inFlight.erase(it);
+
+            if (!options.openLoop && issuing)
+            {
+                issue(now);
+            }
+        }
+    }
+
+    /**
+     * @brief Records the reply to a request in flight, and sends the next request in the closed-loop mode.
+     * @param data The received bytes.
+     * @param length The number of bytes received.
+     * @param issuing Whether new requests may still be sent.
+     */
+    void handleReply(const char *data, int length, bool issuing)
+    {
+        auto receivedAt = Clock::now();
+
+        std::shared_ptr<RequestMessage> reply;
+        try
+        {
+            reply = std::dynamic_pointer_cast<RequestMessage>(JavaDeserializer::deserialize(std::vector<uint8_t>(data, data + length)));
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error decoding reply: " << e.what() << std::endl;
+            return;
+        }
+
+        auto it = reply ? inFlight.find(reply->getRequestID()) : inFlight.end();
+        if (it == inFlight.end())
+        {
+            return; // Monitoring update, or duplicate reply to a retransmitted request
+        }
+
+        Request &request = it->second;
+        latencies[request.operation].record(std::chrono::duration_cast<std::chrono::microseconds>(receivedAt - request.intendedAt).count());
+        completed[request.operation]++;
+
+        const std::string &replyData = reply->getData();
+        if (request.operation != ECHO && ResponseParser::parseStatus(replyData).failed()) // Echo replies carry no status
+        {
+            serverErrors[request.operation]++;
+        }
+        else if (request.operation == BOOK || request.operation == UPDATE)
+        {
+            ResponseParser::Booking booking = request.operation == UPDATE ? ResponseParser::parseUpdateBookingResponse(replyData) : ResponseParser::parseBookFacilityResponse(replyData);
+            if (booking.day && booking.start && booking.end)
+            {
+                bookings.push_back(std::move(booking));
+            }
+        }
+
+        identitySource.complete(request.identity.sequence);
+        inFlight.erase(it);
+
+        if (!options.openLoop && issuing)
+        {
+            issue(receivedAt);
+        }
+    }
+
+    /**
+     * @brief Prints the totals and the latency of each operation.
+     * @param elapsedSeconds The time new requests were sent for.
+     */
+    void report(double elapsedSeconds) const
+    {
+        LatencyHistogram all;
+        int64_t totalCompleted = 0, totalErrors = 0, totalTimedOut = 0;
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+        {
+            all.merge(latencies[op]);
+            totalCompleted += completed[op];
+            totalErrors += serverErrors[op];
+            totalTimedOut += timedOut[op];
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        if (options.openLoop)
+        {
+            std::cout << "mode:        open, " << options.rate << " req/s offered\n";
+        }
+        else
+        {
+            std::cout << "mode:        closed, " << options.concurrency << " in flight\n";
+        }
+
+        std::cout << "duration:    " << elapsedSeconds << " s\n"
+                  << "sent:        " << sent << "\n"
+                  << "completed:   " << totalCompleted << " (" << std::setprecision(0) << totalCompleted / elapsedSeconds << " req/s)\n"
+                  << "retransmits: " << retransmits << "\n"
+                  << "timed out:   " << totalTimedOut << "\n"
+                  << "unfinished:  " << unfinished << "\n"
+                  << "errors:      " << totalErrors << " (replies with status:ERROR, e.g. booking conflicts)\n\n";
+
+        std::cout << std::setw(14) << "operation"
+                  << std::setw(10) << "count"
+                  << std::setw(10) << "errors"
+                  << std::setw(10) << "p50 us"
+                  << std::setw(10) << "p90 us"
+                  << std::setw(10) << "p99 us"
+                  << std::setw(11) << "p99.9 us"
+                  << std::setw(10) << "max us" << std::endl;
+
+        for (int op = 0; op < OPERATION_COUNT; ++op)
+        {
+            if (latencies[op].getCount() > 0 || timedOut[op] > 0)
+            {
+                printRow(OPERATION_NAMES[op], latencies[op], serverErrors[op]);
+            }
+        }
+        printRow("all", all, totalErrors);
+    }
+
+    /**
+     * @brief Prints the latency percentiles of one operation.
+     * @param name The name of the row.
+     * @param histogram The latencies in microseconds.
+     * @param errors The number of error replies.
+     */
+    static void printRow(const std::string &name, const LatencyHistogram &histogram, int64_t errors)
+    {
+        std::cout << std::setw(14) << name
+                  << std::setw(10) << histogram.getCount()
+                  << std::setw(10) << errors
+                  << std::setw(10) << histogram.getValueAtPercentile(50)
+                  << std::setw(10) << histogram.getValueAtPercentile(90)
+                  << std::setw(10) << histogram.getValueAtPercentile(99)
+                  << std::setw(11) << histogram.getValueAtPercentile(99.9)
+                  << std::setw(10) << histogram.getMax() << std::endl;
+    }
+};
+
+/**
+ * @brief Splits a comma-separated list.
+ * @param list The list.
+ * @return The items.
+ */
+std::vector<std::string> splitList(const std::string &list)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ','))
+    {
+        items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief Parses the command line.
+ * @param argc The number of arguments.
+ * @param argv The arguments.
+ * @return The options.
+ * @throws std::runtime_error if an argument is unknown or invalid.
+ */
+Options parseOptions(int argc, char *argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; i += 2)
+    {
+        std::string name = argv[i];
+        if (i + 1 >= argc)
+        {
+            throw std::runtime_error("Missing value for " + name);
+        }
+        std::string value = argv[i + 1];
+
+        if (name == "--host")
+        {
+            options.host = value;
+        }
+        else if (name == "--port")
+        {
+            options.port = std::stoi(value);
+        }
+        else if (name == "--mode")
+        {
+            if (value != "open" && value != "closed")
+            {
+                throw std::runtime_error("Mode must be open or closed");
+            }
+            options.openLoop = value == "open";
+        }
+        else if (name == "--concurrency")
+        {
+            options.concurrency = std::max(1, std::stoi(value));
+        }
+        else if (name == "--rate")
+        {
+            options.rate = std::stod(value);
+            if (options.rate <= 0)
+            {
+                throw std::runtime_error("Rate must be positive");
+            }
+        }
+        else if (name == "--duration")
+        {
+            options.durationSeconds = std::stoi(value);
+        }
+        else if (name == "--timeout-ms")
+        {
+            options.timeoutMillis = std::max(1, std::stoi(value));
+        }
+        else if (name == "--mix")
+        {
+            options.mix.fill(0);
+            for (const std::string &item : splitList(value))
+            {
+                size_t separator = item.find('=');
+                auto op = std::find(OPERATION_NAMES.begin(), OPERATION_NAMES.end(), item.substr(0, separator));
+                if (separator == std::string::npos || op == OPERATION_NAMES.end())
+                {
+                    throw std::runtime_error("Invalid mix entry " + item);
+                }
+                options.mix[op - OPERATION_NAMES.begin()] = std::stod(item.substr(separator + 1));
+            }
+            if (std::all_of(options.mix.begin(), options.mix.end(), [](double weight) { return weight <= 0; }))
+            {
+                throw std::runtime_error("The mix needs at least one operation with a positive weight");
+            }
+        }
+        else if (name == "--facility")
+        {
+            options.facility = value;
+        }
+        else if (name == "--days")
+        {
+            options.days.clear();
+            for (const std::string &item : splitList(value))
+            {
+                std::optional<DayOfWeek> day = Days::parse(item);
+                if (!day)
+                {
+                    throw std::runtime_error("Unknown day: " + item);
+                }
+                options.days.push_back(*day);
+            }
+            if (options.days.empty())
+            {
+                throw std::runtime_error("At least one day is needed");
+            }
+        }
+        else if (name == "--seed")
+        {
+            options.seed = static_cast<unsigned int>(std::stoul(value));
+        }
+        else if (name == "--drop")
+        {
+            options.impairment.dropProbability = std::stod(value);
+            options.impaired = true;
+        }
+        else if (name == "--loss-burst")
+        {
+            options.impairment.lossBurstLength = std::stod(value);
+            options.impaired = true;
+        }
+        else if (name == "--duplicate")
+        {
+            options.impairment.duplicateProbability = std::stod(value);
+            options.impaired = true;
+        }
+        else if (name == "--corrupt")
+        {
+            options.impairment.corruptProbability = std::stod(value);
+            options.impaired = true;
+        }
+        else if (name == "--reorder")
+        {
+            options.impairment.reorderProbability = std::stod(value);
+            options.impaired = true;
+        }
+        else if (name == "--delay-ms")
+        {
+            options.impairment.delay = std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000));
+            options.impaired = true;
+        }
+        else if (name == "--jitter-ms")
+        {
+            options.impairment.jitter = std::chrono::microseconds(static_cast<int64_t>(std::stod(value) * 1000));
+            options.impaired = true;
+        }
+        else if (name == "--jitter-dist")
+        {
+            if (value == "uniform")
+            {
+                options.impairment.distribution = FaultInjector::UNIFORM;
+            }
+            else if (value == "normal")
+            {
+                options.impairment.distribution = FaultInjector::NORMAL;
+            }
+            else if (value == "exponential")
+            {
+                options.impairment.distribution = FaultInjector::EXPONENTIAL;
+            }
+            else
+            {
+                throw std::runtime_error("Unknown jitter distribution " + value);
+            }
+        }
+        else if (name == "--fault-seed")
+        {
+            options.faultSeed = std::stoull(value);
+        }
+        else
+        {
+            throw std::runtime_error("Unknown option " + name);
+        }
+    }
+
+    return options;
+}
+
+/**
+ * @brief Prints what the fault injector did to the datagrams of one direction.
+ * @param direction The name of the direction.
+ * @param counters The counters of the direction.
+ */
+void printImpairment(const std::string &direction, const FaultInjector::Counters &counters)
+{
+    std::cout << "impaired " << direction << ": " << counters.received << " received, "
+              << counters.dropped << " dropped, " << counters.duplicated << " duplicated, "
+              << counters.corrupted << " corrupted, " << counters.reordered << " reordered" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    ObjectFactory::registerMessageClasses();
+
+    Options options;
+    try
+    {
+        options = parseOptions(argc, argv);
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n"
+                  << "Usage: loadgen [--host HOST] [--port PORT] [--mode closed|open] [--concurrency N] [--rate REQ_PER_SEC]\n"
+                  << "               [--duration SECONDS] [--timeout-ms MILLIS] [--mix OP=WEIGHT,...] [--facility NAME]\n"
+                  << "               [--days DAY,...] [--seed SEED]\n"
+                  << "               [--drop P] [--loss-burst N] [--duplicate P] [--corrupt P] [--reorder P] [--delay-ms MILLIS]\n"
+                  << "               [--jitter-ms MILLIS] [--jitter-dist uniform|normal|exponential] [--fault-seed SEED]\n"
+                  << "Operations: names, availability, book, query, update, delete, rate, echo" << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        // Route the traffic through the impairment relay, which forwards it to the real server
+        std::unique_ptr<FaultInjector> injector;
+        if (options.impaired)
+        {
+            injector = std::make_unique<FaultInjector>(options.host, options.port, options.impairment, options.impairment, options.faultSeed);
+            options.host = "127.0.0.1";
+            options.port = injector->getPort();
+        }
+
+        LoadGenerator generator(options);
+        generator.run();
+
+        if (injector)
+        {
+            printImpairment("requests", injector->getCounters(FaultInjector::TO_SERVER));
+            printImpairment("replies", injector->getCounters(FaultInjector::TO_CLIENT));
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
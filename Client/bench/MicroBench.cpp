@@ -0,0 +1,390 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+    #define BENCH_HAS_TSC 1
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #define BENCH_HAS_TSC 1
+#else
+    #define BENCH_HAS_TSC 0
+#endif
+
+#include "AvailabilityCalendar.hpp"
+#include "Constants.hpp"
+#include "Parity.hpp"
+#include "ParseMemo.hpp"
+#include "RequestFactory.hpp"
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "Serializer.hpp"
+#include "UserInterface.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @brief Microbenchmarks of the CPU hot paths of the client: the codec, the parity bit, the response parsers,
+ * the availability calendar and the formatting of parsed responses into boxes by the user interface.
+ *
+ * Each benchmark is calibrated to run for at least the minimum time per sample, and the median of
+ * SAMPLES samples is reported. Besides the time per operation, the heap bytes and allocations per operation
+ * are counted by replacing the global operator new of this program, and cycles per operation are read from
+ * the time-stamp counter where the CPU has one. The TSC ticks at a constant reference rate, so cycles are
+ * only comparable between runs on the same machine.
+ *
+ * A table is printed to stderr and the results to stdout as JSON, one benchmark per line, so that two runs
+ * can be compared with diff or a script.
+ *
+ * Usage: bench [--min-time-ms MILLIS] [--filter TEXT]
+ */
+
+/**
+ * @brief Number of heap allocations made by the program.
+ */
+std::atomic<int64_t> allocationCount(0);
+
+/**
+ * @brief Number of heap bytes allocated by the program.
+ */
+std::atomic<int64_t> allocatedBytes(0);
+
+void *operator new(std::size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    allocatedBytes.fetch_add(static_cast<int64_t>(size), std::memory_order_relaxed);
+
+    if (void *pointer = std::malloc(size == 0 ? 1 : size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+/**
+ * @brief Sink for the results of the benchmarked calls, so that the compiler cannot drop them.
+ */
+volatile size_t sink = 0;
+
+/**
+ * @brief Number of timed samples per benchmark.
+ */
+const int SAMPLES = 5;
+
+/**
+ * @struct Result
+ * @brief Measurements of one benchmark.
+ */
+struct Result
+{
+    std::string name; ///< Name of the benchmark.
+    int64_t iterations; ///< Iterations per sample.
+    double nsPerOp; ///< Median wall time per operation in nanoseconds.
+    double bytesPerOp; ///< Heap bytes allocated per operation.
+    double allocsPerOp; ///< Heap allocations per operation.
+    double cyclesPerOp; ///< Median TSC cycles per operation, or a negative value if there is no TSC.
+};
+
+/**
+ * @brief Reads the time-stamp counter.
+ * @return The counter, or 0 if the CPU has none.
+ */
+uint64_t readCycles()
+{
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Runs a benchmark.
+ * @param name The name of the benchmark.
+ * @param minTime The minimum duration of a sample.
+ * @param body The operation. Returns a value derived from its result.
+ * @return The measurements.
+ */
+Result measure(const std::string &name, std::chrono::nanoseconds minTime, const std::function<size_t()> &body)
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Calibrate: double the iterations until one run takes a tenth of a sample
+    int64_t iterations = 1;
+    while (true)
+    {
+        auto start = Clock::now();
+        for (int64_t i = 0; i < iterations; ++i)
+        {
+            sink = sink + body();
+        }
+        auto elapsed = Clock::now() - start;
+
+        if (elapsed * 10 >= minTime || iterations >= (int64_t(1) << 40))
+        {
+            double perOp = std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations);
+            iterations = std::max<int64_t>(1, static_cast<int64_t>(std::chrono::duration<double, std::nano>(minTime).count() / std::max(perOp, 0.1)));
+            break;
+        }
+        iterations *= 2;
+    }
+
+    std::vector<double> nanos, cycles;
+    int64_t allocationsBefore = allocationCount.load(std::memory_order_relaxed);
+    int64_t bytesBefore = allocatedBytes.load(std::memory_order_relaxed);
+
+    for (int sample = 0; sample < SAMPLES; ++sample)
+    {
+        auto start = Clock::now();
+        uint64_t startCycles = readCycles();
+        for (int64_t i = 0; i < iterations; ++i)
+        {
+            sink = sink + body();
+        }
+        uint64_t endCycles = readCycles();
+        auto elapsed = Clock::now() - start;
+
+        nanos.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / static_cast<double>(iterations));
+        cycles.push_back(static_cast<double>(endCycles - startCycles) / static_cast<double>(iterations));
+    }
+
+    double operations = static_cast<double>(iterations) * SAMPLES;
+    std::sort(nanos.begin(), nanos.end());
+    std::sort(cycles.begin(), cycles.end());
+
+    return {
+        name,
+        iterations,
+        nanos[SAMPLES / 2],
+        static_cast<double>(allocatedBytes.load(std::memory_order_relaxed) - bytesBefore) / operations,
+        static_cast<double>(allocationCount.load(std::memory_order_relaxed) - allocationsBefore) / operations,
+        BENCH_HAS_TSC ? cycles[SAMPLES / 2] : -1
+    };
+}
+
+/**
+ * @brief Formats a number for JSON.
+ * @param value The value. Negative values are written as null.
+ * @return The JSON number.
+ */
+std::string jsonNumber(double value)
+{
+    if (value < 0)
+    {
+        return "null";
+    }
+
+    std::ostringstream stream;
+    stream << std::fixed << std::setprecision(2) << value;
+    return stream.str();
+}
+
+// Replies captured from the server, one per parser
+const std::string NAMES_REPLY = "status:SUCCESS\nfacilityNames:Weekday1,Weekday2,Weekends,";
+const std::string AVAILABILITY_REPLY =
+    "status:SUCCESS\nfacility:Weekday1\navailableTimeslots:\n"
+    "MONDAY:0800 - 0900,1000 - 1200,1300 - 1700,\n"
+    "TUESDAY:0800 - 1700,\n"
+    "WEDNESDAY:0800 - 1130,1230 - 1500,1600 - 1700,\n";
+const std::string BOOKING_REPLY =
+    "status:SUCCESS\nbookingID:7c9e6679-7425-40de-944b-e07fc1f90ae7\nuser:/127.0.0.1:53926\n"
+    "facility:Weekday1\nday:MONDAY\nstartTime:0900\nendTime:1000";
+const std::string UPDATE_REPLY =
+    "status:SUCCESS\noldBookingID:7c9e6679-7425-40de-944b-e07fc1f90ae7\nnewBookingID:16fd2706-8baf-433b-82eb-8c7fada847da\n"
+    "user:/127.0.0.1:53926\nfacility:Weekday1\nday:MONDAY\nstartTime:0930\nendTime:1030";
+const std::string DELETE_REPLY = "status:SUCCESS\nbookingID:16fd2706-8baf-433b-82eb-8c7fada847da\nuser:/127.0.0.1:53926";
+const std::string MONITOR_REPLY = "status:SUCCESS\nfacility:Weekday1\ninterval:60";
+const std::string RATE_REPLY = "status:SUCCESS\nuser:/127.0.0.1:53926\nfacility:Weekday1\nrating:4.0";
+const std::string RATING_REPLY = "status:SUCCESS\nfacility:Weekday1\nrating:3.7";
+const std::string ERROR_REPLY = "status:ERROR\nmessage:Facility not found";
+
+int main(int argc, char *argv[])
+{
+    ObjectFactory::registerMessageClasses();
+
+    std::chrono::milliseconds minTime(200);
+    std::string filter;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string name = argv[i];
+        if (name == "--min-time-ms")
+        {
+            minTime = std::chrono::milliseconds(std::max(1, std::atoi(argv[i + 1])));
+        }
+        else if (name == "--filter")
+        {
+            filter = argv[i + 1];
+        }
+    }
+
+    // Requests as the client sends them, and a reply as the server sends it
+    RequestMessage echoRequest = RequestFactory::echoMessage("hello, server");
+    RequestMessage bookRequest = RequestFactory::bookFacility("Weekday1", DayOfWeek::MONDAY, *MinuteOfDay::parse("0900"), *MinuteOfDay::parse("1000"));
+    RequestMessage availabilityReply(RequestMessage::READ, 42, AVAILABILITY_REPLY);
+    for (RequestMessage *message : {&echoRequest, &bookRequest, &availabilityReply})
+    {
+        message->setRequestID(42);
+        message->setIdentity({0x1234567890ABCDEF, 1, 4051});
+        message->setAckedSequence(4050);
+    }
+
+    std::vector<std::pair<std::string, std::function<size_t()>>> benchmarks;
+
+    for (auto [name, message] : {std::pair{"echo", &echoRequest}, {"book", &bookRequest}, {"availability-reply", &availabilityReply}})
+    {
+        std::vector<uint8_t> serialized = JavaSerializer::serialize(message);
+
+        benchmarks.push_back({std::string("serialize/") + name, [message]()
+        {
+            return JavaSerializer::serialize(message).size();
+        }});
+        benchmarks.push_back({std::string("deserialize/") + name, [serialized]()
+        {
+            return static_cast<size_t>(JavaDeserializer::deserialize(serialized) != nullptr);
+        }});
+    }
+
+    for (size_t size : {16, 256, 1472, 65507})
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = static_cast<uint8_t>(i * 131 + 7);
+        }
+
+        benchmarks.push_back({"parity/" + std::to_string(size), [data]()
+        {
+            return static_cast<size_t>(Parity::calculateEvenParityBit(data));
+        }});
+    }
+
+    benchmarks.push_back({"parse/facility-names", []() { return ResponseParser::parseQueryFacilityNamesResponse(NAMES_REPLY).names.size(); }});
+    benchmarks.push_back({"parse/availability", []() { return static_cast<size_t>(ResponseParser::parseQueryAvailabilityResponse(AVAILABILITY_REPLY).listedDays); }});
+    benchmarks.push_back({"parse/availability-decoded", []()
+    {
+        ResponseParser::Availability availability = ResponseParser::parseQueryAvailabilityResponse(AVAILABILITY_REPLY);
+        size_t timeslots = 0;
+        for (int day = 0; day < Constants::DAYS_PER_WEEK; ++day)
+        {
+            timeslots += availability.timeslots(static_cast<DayOfWeek>(day)).size();
+        }
+        return timeslots;
+    }});
+    benchmarks.push_back({"parse/availability-one-day", []() { return ResponseParser::parseQueryAvailabilityResponse(AVAILABILITY_REPLY, Days::bit(DayOfWeek::WEDNESDAY)).timeslots(DayOfWeek::WEDNESDAY).size(); }});
+
+    auto parseMemo = std::make_shared<ParseMemo>();
+    benchmarks.push_back({"parse/availability-memo-hit", [parseMemo]() { return static_cast<size_t>(parseMemo->parseQueryAvailabilityResponse(AVAILABILITY_REPLY)->listedDays); }});
+    benchmarks.push_back({"parse/availability-hash", []() { return static_cast<size_t>(ParseMemo::hash(AVAILABILITY_REPLY, Constants::ALL_DAYS_MASK)); }});
+    benchmarks.push_back({"parse/book", []() { return ResponseParser::parseBookFacilityResponse(BOOKING_REPLY).bookingID.size(); }});
+    benchmarks.push_back({"parse/query-booking", []() { return ResponseParser::parseQueryBookingResponse(BOOKING_REPLY).bookingID.size(); }});
+    benchmarks.push_back({"parse/update-booking", []() { return ResponseParser::parseUpdateBookingResponse(UPDATE_REPLY).bookingID.size(); }});
+    benchmarks.push_back({"parse/delete-booking", []() { return ResponseParser::parseDeleteBookingResponse(DELETE_REPLY).bookingID.size(); }});
+    benchmarks.push_back({"parse/monitor", []() { return static_cast<size_t>(ResponseParser::parseMonitorAvailabilityResponse(MONITOR_REPLY).intervalSeconds); }});
+    benchmarks.push_back({"parse/rate", []() { return ResponseParser::parseRateFacilityResponse(RATE_REPLY).facility.size(); }});
+    benchmarks.push_back({"parse/query-rating", []() { return ResponseParser::parseQueryRatingResponse(RATING_REPLY).facility.size(); }});
+    benchmarks.push_back({"parse/echo", []() { return ResponseParser::parseEchoMessageResponse("hello, server").size(); }});
+    benchmarks.push_back({"parse/error", []() { return ResponseParser::parseQueryBookingResponse(ERROR_REPLY).error.message.size(); }});
+
+    ResponseParser::Booking booking = ResponseParser::parseQueryBookingResponse(BOOKING_REPLY);
+    ResponseParser::Availability availability = ResponseParser::parseQueryAvailabilityResponse(AVAILABILITY_REPLY);
+    ResponseParser::Availability filteredAvailability = ResponseParser::parseQueryAvailabilityResponse(AVAILABILITY_REPLY, Days::parseMask("MONDAY,WEDNESDAY"));
+    benchmarks.push_back({"request/book", [booking]() { return RequestFactory::bookFacility(booking.facility, *booking.day, *booking.start, *booking.end).getData().size(); }});
+    benchmarks.push_back({"request/update-booking", [booking]() { return RequestFactory::updateBooking(booking, 30).getData().size(); }});
+    benchmarks.push_back({"request/delete-booking", [booking]() { return RequestFactory::deleteBooking(booking).getData().size(); }});
+    benchmarks.push_back({"format/booking", [booking]() { return UserInterface::formatBooking(booking).size(); }});
+    benchmarks.push_back({"format/availability", [availability]() { return UserInterface::formatAvailability(availability).size(); }});
+    benchmarks.push_back({"format/availability-filtered", [filteredAvailability]() { return UserInterface::formatAvailability(filteredAvailability).size(); }});
+
+    AvailabilityCalendar calendar = AvailabilityCalendar::fromAvailability(availability);
+    AvailabilityCalendar otherCalendar = calendar;
+    otherCalendar.setFree(0, 9 * 60, 10 * 60, false);
+    benchmarks.push_back({"calendar/build", [availability]() { return static_cast<size_t>(AvailabilityCalendar::fromAvailability(availability).countFreeMinutes(0)); }});
+    benchmarks.push_back({"calendar/is-free", [calendar]() { return static_cast<size_t>(calendar.isFree(2, 12 * 60 + 30, 15 * 60)); }});
+    benchmarks.push_back({"calendar/find-window", [calendar]() { return static_cast<size_t>(calendar.findFreeWindow(0, 150)); }});
+    benchmarks.push_back({"calendar/intersect", [calendar, otherCalendar]()
+    {
+        AvailabilityCalendar common = calendar;
+        common.intersect(otherCalendar);
+        return static_cast<size_t>(common.countFreeMinutes(0));
+    }});
+
+    std::vector<std::string> bookingBox = UserInterface::formatBooking(booking);
+    std::vector<std::string> availabilityBox = UserInterface::formatAvailability(availability);
+    benchmarks.push_back({"box/booking", [bookingBox]() { return UserInterface::generateBox(bookingBox).size(); }});
+    benchmarks.push_back({"box/availability", [availabilityBox]() { return UserInterface::generateBox(availabilityBox).size(); }});
+
+    std::cerr << std::left << std::setw(30) << "benchmark" << std::right
+              << std::setw(12) << "ns/op"
+              << std::setw(12) << "cycles/op"
+              << std::setw(12) << "bytes/op"
+              << std::setw(12) << "allocs/op" << std::endl;
+
+    std::vector<Result> results;
+    for (const auto &[name, body] : benchmarks)
+    {
+        if (name.find(filter) == std::string::npos)
+        {
+            continue;
+        }
+
+        Result result = measure(name, minTime, body);
+        results.push_back(result);
+
+        std::cerr << std::left << std::setw(30) << result.name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(12) << result.nsPerOp
+                  << std::setw(12) << (result.cyclesPerOp < 0 ? std::string("n/a") : jsonNumber(result.cyclesPerOp))
+                  << std::setw(12) << result.bytesPerOp
+                  << std::setw(12) << result.allocsPerOp << std::endl;
+    }
+
+    std::cout << "{\n  \"minTimeMillis\": " << minTime.count() << ",\n  \"samples\": " << SAMPLES
+              << ",\n  \"cycleCounter\": " << (BENCH_HAS_TSC ? "\"tsc\"" : "null") << ",\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &result = results[i];
+        std::cout << "    {\"name\": \"" << result.name << "\""
+                  << ", \"iterations\": " << result.iterations
+                  << ", \"nsPerOp\": " << jsonNumber(result.nsPerOp)
+                  << ", \"cyclesPerOp\": " << jsonNumber(result.cyclesPerOp)
+                  << ", \"bytesPerOp\": " << jsonNumber(result.bytesPerOp)
+                  << ", \"allocsPerOp\": " << jsonNumber(result.allocsPerOp) << "}"
+                  << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    std::cout << "  ]\n}" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Constants.hpp"
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "Serializer.hpp"
+#include "SharedClient.hpp"
+#include "Socket.hpp"
+
+/**
+ * @brief Benchmark of a single SharedClient called from 1 to 64 threads.
+ *
+ * Each round runs the given number of threads that send echo requests through one shared client for a fixed
+ * duration, against an in-process responder on the loopback interface. Throughput and latency percentiles are
+ * printed per round.
+ *
+ * Usage: SharedClientBench [durationMillis]
+ */
+
+/**
+ * @class EchoResponder
+ * @brief Replies to every request with its own data, on a thread of its own.
+ */
+class EchoResponder
+{
+public:
+    /**
+     * @brief Binds the responder to any available port and starts its thread.
+     */
+    EchoResponder() : running(true)
+    {
+        socket.create(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        socket.bind(0);
+
+        struct sockaddr_in addr;
+        socket.getSocketName(reinterpret_cast<struct sockaddr *>(&addr));
+        port = ntohs(addr.sin_port);
+
+        thread = std::thread(&EchoResponder::serve, this);
+    }
+
+    /**
+     * @brief Stops the thread and closes the socket.
+     */
+    ~EchoResponder()
+    {
+        running.store(false);
+        thread.join();
+        socket.closeSocket();
+    }
+
+    /**
+     * @brief Gets the port the responder listens on.
+     * @return The port number.
+     */
+    int getPort() const
+    {
+        return port;
+    }
+
+private:
+    Socket socket;
+    int port;
+    std::atomic<bool> running;
+    std::thread thread;
+
+    void serve()
+    {
+        std::vector<char> recvBuffer(Constants::MAX_DATAGRAM_SIZE);
+
+        while (running.load())
+        {
+            if (!socket.waitReadable(Constants::SHARED_CLIENT_POLL_MS))
+            {
+                continue;
+            }
+
+            struct sockaddr_in senderAddr;
+            int bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+            std::vector<uint8_t> receivedData(recvBuffer.begin(), recvBuffer.begin() + bytesReceived);
+
+            auto request = std::dynamic_pointer_cast<RequestMessage>(JavaDeserializer::deserialize(receivedData));
+            RequestMessage reply(RequestMessage::ECHO, request->getRequestID(), Constants::STATUS_SUCCESS + "\nmessage:" + request->getData());
+            socket.sendDataTo(JavaSerializer::serialize(&reply), senderAddr);
+        }
+    }
+};
+
+/**
+ * @brief Runs one round of the benchmark and prints its results.
+ * @param client The client shared by all threads.
+ * @param threadCount The number of calling threads.
+ * @param duration The duration of the round.
+ */
+void runRound(SharedClient &client, int threadCount, std::chrono::milliseconds duration)
+{
+    std::vector<std::vector<long long>> latencies(threadCount);
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + duration;
+
+    for (int t = 0; t < threadCount; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            while (std::chrono::steady_clock::now() < end)
+            {
+                auto sentAt = std::chrono::steady_clock::now();
+                std::string response = client.echoMessage("bench");
+                auto receivedAt = std::chrono::steady_clock::now();
+
+                if (ResponseParser::parseStatus(response).failed())
+                {
+                    failures++;
+                }
+                latencies[t].push_back(std::chrono::duration_cast<std::chrono::microseconds>(receivedAt - sentAt).count());
+            }
+        });
+    }
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<long long> all;
+    for (const auto &threadLatencies : latencies)
+    {
+        all.insert(all.end(), threadLatencies.begin(), threadLatencies.end());
+    }
+    std::sort(all.begin(), all.end());
+
+    auto percentile = [&all](double p)
+    {
+        return all.empty() ? 0LL : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+    };
+
+    std::cout << std::setw(8) << threadCount
+              << std::setw(12) << all.size()
+              << std::setw(14) << std::fixed << std::setprecision(0) << all.size() / elapsedSeconds
+              << std::setw(10) << percentile(0.50)
+              << std::setw(10) << percentile(0.99)
+              << std::setw(10) << failures.load() << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+    ObjectFactory::registerMessageClasses();
+
+    std::chrono::milliseconds duration(argc > 1 ? std::atoi(argv[1]) : 1000);
+
+    EchoResponder responder;
+    SharedClient client("127.0.0.1", responder.getPort());
+
+    std::cout << std::setw(8) << "threads"
+              << std::setw(12) << "requests"
+              << std::setw(14) << "req/s"
+              << std::setw(10) << "p50 us"
+              << std::setw(10) << "p99 us"
+              << std::setw(10) << "failed" << std::endl;
+
+    for (int threadCount = 1; threadCount <= 64; threadCount *= 2)
+    {
+        runRound(client, threadCount, duration);
+    }
+
+    return 0;
+}
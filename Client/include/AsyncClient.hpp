@@ -0,0 +1,138 @@
+#ifndef ASYNC_CLIENT_HPP
+#define ASYNC_CLIENT_HPP
+
+#include <functional>
+#include <string>
+
+#include "EventLoop.hpp"
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "Socket.hpp"
+#include "Task.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @class AsyncClient
+ * @brief Awaitable versions of the Client operations, driven by an EventLoop.
+ *
+ * Each operation is a coroutine that sends its request through the loop's socket and suspends until the reply
+ * arrives, retransmitting on timeout like Client does. Workflows of several steps can be written as one coroutine
+ * (co_await a query, then a booking, then a check), and thousands of them can share a single loop and thread.
+ *
+ * @note The AsyncClient and its EventLoop must outlive every task started from it.
+ * @note Requests are not journaled; use a Client with a journal for requests that must survive a crash.
+ */
+class AsyncClient
+{
+public:
+    /**
+     * @brief Constructs an AsyncClient that sends requests to the given server through the loop.
+     * @param loop The event loop owning the socket.
+     * @param serverIp The IP address or hostname of the server.
+     * @param serverPort The port number of the server.
+     * @throws std::runtime_error if the server address cannot be resolved.
+     */
+    AsyncClient(EventLoop &loop, const std::string &serverIp, int serverPort);
+
+    /**
+     * @brief Queries the names of all available facilities.
+     * @return A task yielding the list of facility names or an error message.
+     */
+    Task<std::string> queryFacilityNamesAsync();
+
+    /**
+     * @brief Queries the availability of a facility for specific days.
+     * @param facilityName The name of the facility to query availability for.
+     * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+     * @return A task yielding the availability information or an error message.
+     */
+    Task<std::string> queryAvailabilityAsync(std::string facilityName, uint8_t dayMask);
+
+    /**
+     * @brief Books a facility for a specific day and time range.
+     * @param facilityName The name of the facility.
+     * @param dayOfWeek The day of the week.
+     * @param startTime The start time.
+     * @param endTime The end time.
+     * @return A task yielding the booking confirmation or an error message.
+     */
+    Task<std::string> bookFacilityAsync(std::string facilityName, DayOfWeek dayOfWeek, MinuteOfDay startTime, MinuteOfDay endTime);
+
+    /**
+     * @brief Queries the details of an existing booking.
+     * @param bookingID The ID of the booking to query.
+     * @return A task yielding the booking details or an error message.
+     */
+    Task<std::string> queryBookingAsync(std::string bookingID);
+
+    /**
+     * @brief Updates an existing booking by applying a time offset.
+     * @param oldBooking The booking to update, as parsed from its details.
+     * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+     * @return A task yielding the updated booking details or an error message.
+     */
+    Task<std::string> updateBookingAsync(ResponseParser::Booking oldBooking, int offsetMinutes);
+
+    /**
+     * @brief Deletes an existing booking.
+     * @param booking The booking to delete, as parsed from its details.
+     * @return A task yielding the deletion confirmation or an error message.
+     */
+    Task<std::string> deleteBookingAsync(ResponseParser::Booking booking);
+
+    /**
+     * @brief Registers interest in a facility without waiting for its updates.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration of the registration in seconds.
+     * @return A task yielding the registration confirmation or an error message.
+     */
+    Task<std::string> registerMonitorAsync(std::string facilityName, int durationSeconds);
+
+    /**
+     * @brief Monitors the availability of a facility for a specified duration.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration to monitor in seconds.
+     * @param onUpdate Callback function to handle the registration response and the updates.
+     * @return A task that finishes when the duration has elapsed or the registration failed.
+     */
+    Task<void> monitorAvailabilityAsync(
+        std::string facilityName,
+        int durationSeconds,
+        std::function<void(const std::string &, const bool)> onUpdate
+    );
+
+    /**
+     * @brief Rates a facility.
+     * @param facilityName The name of the facility to rate.
+     * @param rating The rating value (e.g., 4.5).
+     * @return A task yielding the rating confirmation or an error message.
+     */
+    Task<std::string> rateFacilityAsync(std::string facilityName, float rating);
+
+    /**
+     * @brief Queries the rating of a facility.
+     * @param facilityName The name of the facility to query.
+     * @return A task yielding the rating information or an error message.
+     */
+    Task<std::string> queryRatingAsync(std::string facilityName);
+
+    /**
+     * @brief Sends an echo message to the server.
+     * @param messageData The message data to send.
+     * @return A task yielding the echoed message or an error message.
+     */
+    Task<std::string> echoMessageAsync(std::string messageData);
+
+private:
+    EventLoop &loop; ///< Event loop owning the socket.
+    struct sockaddr_in serverAddr; ///< Address of the server.
+
+    /**
+     * @brief Sends a request and awaits its reply, retransmitting on timeout.
+     * @param request The request to send. Its request ID and identity are assigned by the loop.
+     * @return A task yielding the reply data or an error message.
+     */
+    Task<std::string> sendWithRetry(RequestMessage request);
+};
+
+#endif // ASYNC_CLIENT_HPP
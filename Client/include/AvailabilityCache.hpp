@@ -0,0 +1,83 @@
+#ifndef AVAILABILITY_CACHE_HPP
+#define AVAILABILITY_CACHE_HPP
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "AvailabilityCalendar.hpp"
+#include "Constants.hpp"
+#include "ResponseParser.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @class AvailabilityCache
+ * @brief The availability of facilities last received from the server, used to reject bookings that cannot succeed.
+ *
+ * Each facility has a calendar and the time each of its days was last fetched. Replies to availability queries
+ * only list the days that were requested, so days are cached independently, and a day the server omitted from a
+ * reply that covered it is stored as closed. Bookings made by the client mark their minutes busy, while updates,
+ * deletions and failed bookings invalidate the facility, as its free periods can no longer be derived locally.
+ */
+class AvailabilityCache
+{
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of the fetch times.
+
+    /**
+     * @brief Stores the requested days of a parsed availability reply.
+     * @param availability The parsed availability, parsed with the mask of the days the query asked for. Errors are not stored.
+     * @param fetchedAt The time the reply was received.
+     */
+    void store(const ResponseParser::Availability &availability, Clock::time_point fetchedAt);
+
+    /**
+     * @brief Marks a range of a cached day busy, such as after the client booked it.
+     * @param facilityName The facility name.
+     * @param day The day.
+     * @param start The start of the range.
+     * @param end The end of the range, exclusive.
+     */
+    void markBusy(const std::string &facilityName, DayOfWeek day, MinuteOfDay start, MinuteOfDay end);
+
+    /**
+     * @brief Forgets the cached availability of a facility.
+     * @param facilityName The facility name.
+     */
+    void invalidate(const std::string &facilityName);
+
+    /**
+     * @brief Forgets the cached availability of every facility.
+     */
+    void clear();
+
+    /**
+     * @brief Checks whether fresh cached availability shows that a range cannot be booked.
+     * @param facilityName The facility name.
+     * @param day The day.
+     * @param start The start of the range.
+     * @param end The end of the range, exclusive.
+     * @param maxAge The maximum age of cached days that are trusted.
+     * @param now The current time.
+     * @return True if the day is cached, no older than maxAge, and any minute of the range is not free.
+     */
+    bool isKnownUnavailable(const std::string &facilityName, DayOfWeek day, MinuteOfDay start, MinuteOfDay end, Clock::duration maxAge, Clock::time_point now) const;
+
+private:
+    /**
+     * @struct Entry
+     * @brief The cached availability of one facility.
+     */
+    struct Entry
+    {
+        AvailabilityCalendar calendar; ///< Free minutes of the cached days; other days are busy.
+        uint8_t knownDays = 0; ///< Mask of the cached days.
+        std::array<Clock::time_point, Constants::DAYS_PER_WEEK> fetchedAt; ///< Time each cached day was fetched.
+    };
+
+    std::unordered_map<std::string, Entry> entries; ///< Cached availability by facility name.
+};
+
+#endif // AVAILABILITY_CACHE_HPP
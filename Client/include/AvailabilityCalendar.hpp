@@ -0,0 +1,118 @@
+#ifndef AVAILABILITY_CALENDAR_HPP
+#define AVAILABILITY_CALENDAR_HPP
+
+#include <array>
+#include <cstdint>
+
+#include "Constants.hpp"
+#include "ResponseParser.hpp"
+
+/**
+ * @class AvailabilityCalendar
+ * @brief The free minutes of a facility in a week, one bit per minute.
+ *
+ * Each day is a fixed array of 64-bit words in which a set bit marks a free minute, so a whole week takes
+ * 1288 bytes. Range checks, window searches and intersections work on whole words: a minute range is checked
+ * with one mask per partial word, free runs are found by counting leading and trailing bits, and calendars
+ * are intersected by a plain AND loop that compilers vectorize. Days are indexed by Days::index() of their
+ * DayOfWeek and minutes count from midnight, with ranges [start, end) exclusive of their end.
+ */
+class AvailabilityCalendar
+{
+public:
+    static constexpr int WORD_BITS = 64; ///< Minutes per word.
+    static constexpr int WORDS_PER_DAY = (Constants::MINUTES_PER_DAY + WORD_BITS - 1) / WORD_BITS; ///< Words per day, the last one partly used.
+
+    /**
+     * @brief Constructs a calendar in which every minute is busy.
+     */
+    AvailabilityCalendar();
+
+    /**
+     * @brief Builds the calendar of a parsed availability response.
+     * @param availability The parsed availability. Timeslots that are not valid ranges are skipped.
+     * @return The calendar, with the minutes of the listed timeslots free and all others busy.
+     */
+    static AvailabilityCalendar fromAvailability(const ResponseParser::Availability &availability);
+
+    /**
+     * @brief Replaces the minutes of a day with those of the same day in another calendar.
+     * @param day The index of the day.
+     * @param source The calendar to copy from.
+     */
+    void copyDay(int day, const AvailabilityCalendar &source);
+
+    /**
+     * @brief Marks a range of minutes as free or busy.
+     * @param day The index of the day.
+     * @param start The first minute.
+     * @param end The minute after the last one.
+     * @param free True to mark the minutes free, false to mark them busy.
+     */
+    void setFree(int day, int start, int end, bool free = true);
+
+    /**
+     * @brief Checks whether every minute of a range is free.
+     * @param day The index of the day.
+     * @param start The first minute.
+     * @param end The minute after the last one.
+     * @return True if the range is free, false if any minute of it is busy or it is outside the day.
+     */
+    bool isFree(int day, int start, int end) const;
+
+    /**
+     * @brief Finds the earliest free window of a given length within a range of a day.
+     * @param day The index of the day.
+     * @param length The length of the window in minutes.
+     * @param from The earliest start of the window.
+     * @param until The latest end of the window.
+     * @return The first minute of the window, or -1 if there is none.
+     */
+    int findFreeWindow(int day, int length, int from = 0, int until = Constants::MINUTES_PER_DAY) const;
+
+    /**
+     * @brief Keeps only the minutes that are also free in another calendar.
+     * @param other The other calendar, such as that of another facility.
+     */
+    void intersect(const AvailabilityCalendar &other);
+
+    /**
+     * @brief Counts the free minutes of a day.
+     * @param day The index of the day.
+     * @return The number of free minutes.
+     */
+    int countFreeMinutes(int day) const;
+
+private:
+    alignas(64) std::array<uint64_t, Constants::DAYS_PER_WEEK * WORDS_PER_DAY> words; ///< Bits of all days, day after day; bit i of word w is minute w * 64 + i.
+
+    /**
+     * @brief Gets the mask of the bits of a word that lie within a range of minutes.
+     * @param word The index of the word within its day.
+     * @param start The first minute.
+     * @param end The minute after the last one.
+     * @return The mask.
+     */
+    static uint64_t rangeMask(int word, int start, int end);
+
+    /**
+     * @brief Finds the next minute at or after a given one whose bit has a given value.
+     * @param day The index of the day.
+     * @param minute The minute to start at.
+     * @param until The minute to stop at.
+     * @param free True to find a free minute, false to find a busy one.
+     * @return The minute found, or until if there is none before it.
+     */
+    int findNext(int day, int minute, int until, bool free) const;
+
+    /**
+     * @brief Checks that a day and a range of minutes are valid.
+     * @param day The index of the day.
+     * @param start The first minute.
+     * @param end The minute after the last one.
+     * @return True if the day exists and 0 <= start < end <= MINUTES_PER_DAY.
+     */
+    static bool isValidRange(int day, int start, int end);
+};
+
+#endif // AVAILABILITY_CALENDAR_HPP
@@ -0,0 +1,74 @@
+#ifndef BATCH_MESSAGE_HPP
+#define BATCH_MESSAGE_HPP
+
+#include <vector>
+
+#include "RequestMessage.hpp"
+#include "Serializer.hpp"
+
+/**
+ * @class BatchMessage
+ * @brief An envelope carrying several request messages in a single datagram.
+ *
+ * The server processes the requests of a batch in order and replies with a BatchMessage of the same
+ * batch ID, holding one reply per request. Each request keeps its own request ID, so duplicate filtering
+ * on the server works per request as for standalone messages.
+ */
+class BatchMessage : public JavaSerializable
+{
+private:
+    int batchID; ///< Unique identifier for the batch, echoed in the reply.
+    std::vector<RequestMessage> requests; ///< Requests carried by the batch, or their replies.
+
+public:
+    /**
+     * @brief Default constructor for BatchMessage.
+     */
+    BatchMessage();
+
+    /**
+     * @brief Parameterized constructor for BatchMessage.
+     * @param batchID The unique identifier for the batch.
+     * @param requests The requests carried by the batch.
+     */
+    BatchMessage(int batchID, const std::vector<RequestMessage> &requests);
+
+    /**
+     * @brief Gets the Java class name for serialization.
+     * @return The Java class name as a string.
+     */
+    std::string getJavaClassName() const override;
+
+    /**
+     * @brief Gets the metadata about the fields in the batch message.
+     * @return A vector of pairs representing field names and their types.
+     */
+    std::vector<std::pair<std::string, std::string>> getFieldMetadata() const override;
+
+    /**
+     * @brief Serializes the field values into a byte buffer.
+     * @param buffer The byte buffer to write the serialized data to.
+     */
+    void serializeFieldValues(ByteBuffer &buffer) const override;
+
+    /**
+     * @brief Deserializes the fields from a byte reader.
+     * @param reader The byte reader to read the serialized data from.
+     * @throws std::runtime_error if an element of the batch is not a RequestMessage.
+     */
+    void deserializeFields(ByteReader &reader) override;
+
+    /**
+     * @brief Gets the batch ID.
+     * @return The batch ID as an integer.
+     */
+    int getBatchID() const;
+
+    /**
+     * @brief Gets the requests carried by the batch.
+     * @return The requests in batch order.
+     */
+    const std::vector<RequestMessage> &getRequests() const;
+};
+
+#endif // BATCH_MESSAGE_HPP
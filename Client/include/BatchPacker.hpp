@@ -0,0 +1,86 @@
+#ifndef BATCH_PACKER_HPP
+#define BATCH_PACKER_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+#include "BatchMessage.hpp"
+#include "RequestMessage.hpp"
+
+/**
+ * @class BatchPacker
+ * @brief Collects request messages into a BatchMessage that fits a single datagram.
+ *
+ * The packer tracks the exact serialized size of the open batch, and refuses requests that would push it
+ * past the datagram size limit. A batch is ready to send once it has been open for the linger time, which
+ * bounds the delay added to the first request while still letting requests issued close together share
+ * a datagram.
+ */
+class BatchPacker
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Constructs a packer with no open batch.
+     * @param maxDatagramSize The maximum serialized size of a batch in bytes.
+     * @param linger The time a batch waits for more requests after its first request.
+     */
+    BatchPacker(size_t maxDatagramSize, std::chrono::microseconds linger);
+
+    /**
+     * @brief Adds a request to the open batch.
+     * @param request The request to add.
+     * @return False if the request does not fit in the open batch, which is then left unchanged.
+     * @throws std::runtime_error if the request does not fit in a batch on its own.
+     */
+    bool add(const RequestMessage &request);
+
+    /**
+     * @brief Checks whether the open batch has waited long enough for more requests.
+     * @param now The current time.
+     * @return True if the batch holds requests and has been open for at least the linger time.
+     */
+    bool isReady(Clock::time_point now) const;
+
+    /**
+     * @brief Checks whether the open batch holds no requests.
+     * @return True if there is nothing to send.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the serialized size of the open batch.
+     * @return The size in bytes, including the parity byte.
+     */
+    size_t getEncodedSize() const;
+
+    /**
+     * @brief Closes the open batch and starts a new, empty one.
+     * @param batchID The ID to give the closed batch.
+     * @return The closed batch.
+     */
+    BatchMessage take(int batchID);
+
+    /**
+     * @brief Sets the time a batch waits for more requests after its first request.
+     * @param linger The linger time.
+     */
+    void setLinger(std::chrono::microseconds linger);
+
+private:
+    size_t maxDatagramSize; ///< Maximum serialized size of a batch in bytes.
+    std::chrono::microseconds linger; ///< Time a batch waits for more requests after its first request.
+    std::vector<RequestMessage> requests; ///< Requests of the open batch.
+    size_t encodedSize; ///< Serialized size of the open batch in bytes.
+    Clock::time_point openedAt; ///< Time the first request was added to the open batch.
+
+    /**
+     * @brief Gets the serialized size of a batch without requests.
+     * @return The size in bytes, including the parity byte.
+     */
+    static size_t getEnvelopeSize();
+};
+
+#endif // BATCH_PACKER_HPP
@@ -1,12 +1,27 @@
 #ifndef CLIENT_HPP
 #define CLIENT_HPP
 
+#include <chrono>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 #include <string>
 
+#include "AvailabilityCache.hpp"
+#include "BatchPacker.hpp"
+#include "ClientStats.hpp"
+#include "Constants.hpp"
+#include "ParseMemo.hpp"
+#include "RequestIdentity.hpp"
+#include "RequestJournal.hpp"
 #include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "RttEstimator.hpp"
 #include "Socket.hpp"
+#include "Tracer.hpp"
+#include "WeekTime.hpp"
 
 /**
  * @class Client
@@ -21,15 +36,31 @@ private:
     Socket socket; ///< Socket for communication with the server.
     struct sockaddr_in clientAddr, serverAddr; ///< Local and remote socket addresses.
     std::vector<uint8_t> buffer; ///< Buffer for storing received data.
-    int requestID; ///< Unique ID for each request sent to the server.
+    int requestID; ///< Unique ID for each request sent to the server. ID 0 is reserved for server-initiated messages.
+    std::unique_ptr<RequestJournal> journal; ///< Journal of the non-idempotent requests in flight, or null if journaling is off.
+    RequestIdentitySource identitySource; ///< Globally unique identities of the requests, used by the server to detect duplicates.
+    std::function<void(const RequestMessage &)> pushHandler; ///< Receives monitoring updates that arrive while waiting for a reply.
+    RttEstimator rttEstimator; ///< Round-trip estimate used for pipelined retransmission timeouts.
+    double pipelineWindow; ///< Number of requests submitPipelined() may keep in flight, adapted to losses.
+    BatchPacker batchPacker; ///< Open batch of requests queued by queueBatched().
+    std::vector<std::string> batchResults; ///< Replies to requests queued since the last flushBatched(), in queue order.
+    std::unordered_map<int, size_t> batchTickets; ///< Request ID of each queued request to its index in batchResults.
+    std::unique_ptr<ClientStats> stats; ///< Latency and attempt statistics of the operations, or null if they are not collected.
+    std::unique_ptr<Tracer> tracer; ///< Tracer of the request lifecycle, or null if tracing is off.
+    AvailabilityCache availabilityCache; ///< Availability received from the server, used to pre-check bookings.
+    bool bookingPrecheck; ///< Whether bookings are checked against availabilityCache before they are sent.
+    std::chrono::milliseconds precheckMaxAge; ///< Maximum age of cached availability that may reject a booking.
+    int64_t precheckRejections; ///< Number of bookings rejected by the pre-check without contacting the server.
+    std::unique_ptr<ParseMemo> parseMemo; ///< Recently parsed availability replies, or null if parses are not memoized.
 
 public:
     /**
      * @brief Constructs a Client object and initializes the connection to the server.
      * @param serverIp The IP address of the server.
      * @param serverPort The port number of the server.
+     * @param journalPath The path of the request journal, or an empty string to not journal requests.
      */
-    Client(const std::string &serverIp, int serverPort);
+    Client(const std::string &serverIp, int serverPort, const std::string &journalPath = "");
 
     /**
      * @brief C;pses the socket and cleans up resources.
@@ -45,24 +76,26 @@ public:
     /**
      * @brief Queries the availability of a facility for specific days.
      * @param facilityName The name of the facility to query availability for.
-     * @param daysOfWeek A comma-separated list of days (e.g., "MONDAY,TUESDAY,WEDNESDAY").
+     * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
      * @return A string containing the availability information or error message.
      */
-    std::string queryAvailability(std::string facilityName, std::string daysOfWeek);
+    std::string queryAvailability(std::string facilityName, uint8_t dayMask);
 
     /**
      * @brief Books a facility for a specific day and time range.
      * @param facilityName The name of the facility.
-     * @param dayOfWeek The day of the week (e.g., "MONDAY").
-     * @param startTime The start time in HHMM format (e.g., "0900").
-     * @param endTime The end time in HHMM format (e.g., "1100").
+     * @param dayOfWeek The day of the week.
+     * @param startTime The start time.
+     * @param endTime The end time.
+     * @param bypassPrecheck True to send the booking even if cached availability shows it cannot succeed.
      * @return A string containing the booking confirmation or error message.
      */
     std::string bookFacility(
         const std::string facilityName,
-        const std::string dayOfWeek,
-        const std::string startTime,
-        const std::string endTime
+        const DayOfWeek dayOfWeek,
+        const MinuteOfDay startTime,
+        const MinuteOfDay endTime,
+        const bool bypassPrecheck = false
     );
 
     /**
@@ -74,24 +107,19 @@ public:
 
     /**
      * @brief Updates an existing booking by applying a time offset.
-     * @param oldBookingID The ID of the booking to update.
+     * @param oldBooking The booking to update, as parsed from its details.
      * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
-     * @param oldBookingDetails The details of the old booking to be updated.
      * @return A string containing the updated booking details or an error message.
+     * @throws std::runtime_error if the booking has no valid day, start or end time.
      */
-    std::string updateBooking(
-        std::string oldBookingID,
-        int offsetMinutes,
-        std::string oldBookingDetails
-    );
+    std::string updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes);
 
     /**
      * @brief Deletes an existing booking.
-     * @param bookingID The ID of the booking to delete.
-     * @param bookingDetails The details of the booking to delete.
+     * @param booking The booking to delete, as parsed from its details.
      * @return A string containing the deletion confirmation or an error message.
      */
-    std::string deleteBooking(std::string bookingID, std::string bookingDetails);
+    std::string deleteBooking(const ResponseParser::Booking &booking);
 
     /**
      * @brief Monitors the availability of a facility for a specified duration.
@@ -105,6 +133,132 @@ public:
         const std::function<void(const std::string &, const bool)> &onUpdate
     );
 
+    /**
+     * @brief Registers interest in a facility without blocking for its updates.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration of the registration in seconds.
+     * @return A string containing the registration confirmation or an error message.
+     */
+    std::string registerMonitor(const std::string &facilityName, int durationSeconds);
+
+    /**
+     * @brief Waits for the next monitoring update pushed by the server.
+     * @param update The message to store the received update in.
+     * @param timeoutMillis The maximum time to wait in milliseconds.
+     * @return True if an update was received before the timeout, false otherwise.
+     */
+    bool receiveMonitorUpdate(RequestMessage &update, int timeoutMillis);
+
+    /**
+     * @brief Sets the handler for monitoring updates that arrive while waiting for a reply.
+     * @param handler The handler to call with each update, or an empty function to discard them.
+     */
+    void setPushHandler(const std::function<void(const RequestMessage &)> &handler);
+
+    /**
+     * @brief Sends a batch of requests with several in flight at once and collects their replies.
+     * @param requests The requests to send. Their request IDs and identities are assigned by the client.
+     * @return The reply data of each request in submission order, or an error message for requests that failed.
+     */
+    std::vector<std::string> submitPipelined(std::vector<RequestMessage> requests);
+
+    /**
+     * @brief Gets the current pipelining window.
+     * @return The number of requests submitPipelined() may currently keep in flight.
+     */
+    int getPipelineWindow() const;
+
+    /**
+     * @brief Queues a request to be sent together with others in a batch.
+     * @param request The request to queue. Its request ID and identity are assigned by the client.
+     * @return The index of the request's reply in the result of flushBatched().
+     */
+    size_t queueBatched(RequestMessage request);
+
+    /**
+     * @brief Sends any open batch and returns the replies to all requests queued since the last flush.
+     * @return The reply data of each queued request in queue order, or an error message for requests that failed.
+     */
+    std::vector<std::string> flushBatched();
+
+    /**
+     * @brief Sends requests packed into as few datagrams as possible and collects their replies.
+     * @param requests The requests to send. Their request IDs and identities are assigned by the client.
+     * @return The reply data of each request in submission order, or an error message for requests that failed.
+     */
+    std::vector<std::string> submitBatched(const std::vector<RequestMessage> &requests);
+
+    /**
+     * @brief Sets the time a batch waits for more requests after its first request.
+     * @param linger The linger time.
+     */
+    void setBatchLinger(std::chrono::microseconds linger);
+
+    /**
+     * @brief Resends the journaled requests that had not completed when the previous run of the client ended.
+     * @return The reply data of each resent request in the order they were first sent, or an error message for requests that failed.
+     */
+    std::vector<std::string> replayJournal();
+
+    /**
+     * @brief Starts collecting latency and attempt statistics of the operations, including pipelined and batched ones.
+     */
+    void enableStats();
+
+    /**
+     * @brief Gets the collected statistics.
+     * @return The statistics, or null if they are not collected.
+     */
+    ClientStats *getStats();
+
+    /**
+     * @brief Starts tracing the lifecycle of the operations, including pipelined and batched ones.
+     */
+    void enableTracing();
+
+    /**
+     * @brief Gets the tracer.
+     * @return The tracer, or null if tracing is off.
+     */
+    Tracer *getTracer();
+
+    /**
+     * @brief Starts checking bookings against the availability last received from the server.
+     * @param maxAge The maximum age of cached availability that may reject a booking.
+     */
+    void enableBookingPrecheck(std::chrono::milliseconds maxAge = std::chrono::milliseconds(Constants::PRECHECK_MAX_AGE_MS));
+
+    /**
+     * @brief Stops checking bookings against cached availability and forgets it.
+     */
+    void disableBookingPrecheck();
+
+    /**
+     * @brief Gets the number of bookings rejected by the pre-check.
+     * @return The number of bookings rejected without contacting the server.
+     */
+    int64_t getPrecheckRejections() const;
+
+    /**
+     * @brief Starts keeping recently parsed availability replies, so that identical replies are not parsed again.
+     * @param capacity The maximum number of replies kept.
+     */
+    void enableParseMemo(size_t capacity = Constants::PARSE_MEMO_CAPACITY);
+
+    /**
+     * @brief Gets the table of parsed availability replies.
+     * @return The table, or null if parses are not memoized.
+     */
+    ParseMemo *getParseMemo();
+
+    /**
+     * @brief Parses an availability reply or monitoring update, through the parse memo if it is enabled.
+     * @param response The raw server response.
+     * @param dayMask The days to parse, with the bit of each day set.
+     * @return The availability of the listed days of the mask or the error.
+     */
+    std::shared_ptr<const ResponseParser::Availability> parseAvailability(std::string_view response, uint8_t dayMask = Constants::ALL_DAYS_MASK);
+
     /**
      * @brief Rates a facility.
      * @param facilityName The name of the facility to rate.
@@ -143,53 +297,92 @@ private:
     void makeRemoteSocketAddress(struct sockaddr_in *sa, char *hostname, int port);
 
     /**
-     * @brief Sends a request message to the server.
+     * @brief Sends a request message to the server, carrying the current acknowledged watermark.
      * @param request The request message to send.
-     * @param retry Whether this is a retry attempt.
+     * @param retry Whether this is a retry attempt, which is counted as a retry in the statistics.
      */
-    void sendRequest(const RequestMessage &request, bool retry = false);
+    void sendRequest(RequestMessage &request, bool retry = false);
 
     /**
      * @brief Receives a response from the server and verifies the request ID.
      * @param expectedRequestID The expected request ID for the response.
+     * @param requestType The request type to record statistics under, or -1 to not record any.
      * @return A string containing the response message from the server or an error message.
      */
-    std::string receiveResponse(uint32_t expectedRequestID);
+    std::string receiveResponse(uint32_t expectedRequestID, int requestType = -1);
+
+    /**
+     * @brief Records a timed phase into the statistics and the trace, whichever are on.
+     * @param requestType The request type of the operation.
+     * @param requestID The request ID of the operation.
+     * @param phase The phase.
+     * @param start The start of the phase.
+     * @param end The end of the phase.
+     */
+    void recordPhase(int requestType, int64_t requestID, ClientStats::Phase phase, ClientStats::Clock::time_point start, ClientStats::Clock::time_point end);
+
+    /**
+     * @brief Classifies a datagram that could not be decoded.
+     * @param data The received bytes.
+     * @param length The number of bytes received.
+     * @return PARITY_FAILURE if the parity check fails, DECODE_FAILURE otherwise.
+     */
+    static ClientStats::Outcome classifyUndecodable(const char *data, int length);
+
+    /**
+     * @brief Deserializes a datagram received from the server.
+     * @param data The received bytes.
+     * @param length The number of bytes received.
+     * @return The decoded request message.
+     * @throws std::runtime_error if the datagram cannot be decoded into a RequestMessage.
+     */
+    std::shared_ptr<RequestMessage> decodeMessage(const char *data, int length);
+
+    /**
+     * @brief Sends the open batch with retries and stores the replies in batchResults.
+     */
+    void sendBatch();
 
     /**
      * @brief Sends a request to the server with retries.
      * @param request The request message to send.
      * @return A string containing the response message from the server or an error message.
      */
-    std::string sendWithRetry(const RequestMessage &request);
+    std::string sendWithRetry(RequestMessage &request);
+
+    /**
+     * @brief Resends a journaled request with its original bytes and request ID until it is answered.
+     * @param entry The journaled request.
+     * @return A string containing the response message from the server or error message.
+     */
+    std::string resendJournaled(const RequestJournal::Entry &entry);
 
     /**
-     * @brief Extracts the facility name from the booking details string.
-     * @param bookingDetails The booking details string.
-     * @return The extracted facility name.
+     * @brief Opens the request journal, exiting if it cannot be opened.
+     * @param journalPath The path of the journal, or an empty string.
+     * @return The journal, or null if the path is empty.
      */
-    std::string extractFacilityName(const std::string &bookingDetails);
+    static std::unique_ptr<RequestJournal> openJournal(const std::string &journalPath);
 
     /**
-     * @brief Extracts the day of the week from the booking details string.
-     * @param bookingDetails The booking details string.
-     * @return The extracted day of the week.
+     * @brief Checks whether a request must be journaled, i.e. whether resending it could apply it twice.
+     * @param request The request.
+     * @return True for bookings, updates, ratings and deletions.
      */
-    std::string extractDayOfWeek(const std::string &bookingDetails);
+    static bool needsJournal(const RequestMessage &request);
 
     /**
-     * @brief Extracts the start time from the booking details string.
-     * @param bookingDetails The booking details string.
-     * @return The extracted start time in HHMM format.
+     * @brief Journals a request before it is first sent, if journaling is on and the request needs it.
+     * @param request The request, with its request ID and identity assigned. Its acknowledged sequence is set.
+     * @return True if the request was journaled.
      */
-    std::string extractStartTime(const std::string &bookingDetails);
+    bool journalRequest(RequestMessage &request);
 
     /**
-     * @brief Extracts the end time from the booking details string.
-     * @param bookingDetails The booking details string.
-     * @return The extracted end time in HHMM format.
+     * @brief Marks a request complete in the journal, if it was journaled.
+     * @param request The request.
      */
-    std::string extractEndTime(const std::string &bookingDetails);
+    void completeJournaled(const RequestMessage &request);
 
     /**
      * @brief Listens for monitoring updates from the server.
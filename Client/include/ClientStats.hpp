@@ -0,0 +1,159 @@
+#ifndef CLIENT_STATS_HPP
+#define CLIENT_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "LatencyHistogram.hpp"
+
+/**
+ * @class ClientStats
+ * @brief Per-operation-type latency histograms and attempt counters of a Client.
+ *
+ * Every logical operation is split into phases (serialize, send, wait for the reply, decode, parse), each
+ * recorded in nanoseconds into a histogram of its request type, and every attempt is counted by its outcome.
+ * Recording only uses relaxed atomic increments, so it is lock-free and may be done from any thread.
+ * snapshot() copies the counters into plain LatencyHistograms for reporting.
+ */
+class ClientStats
+{
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of the recorded durations.
+
+    /**
+     * @enum Phase
+     * @brief Phases of an operation.
+     */
+    enum Phase
+    {
+        SERIALIZE = 0, ///< Serializing the request.
+        SEND = 1, ///< Handing the datagram to the socket.
+        WAIT = 2, ///< Waiting from the start of the receive until the datagram of the reply arrived.
+        DECODE = 3, ///< Deserializing the reply.
+        PARSE = 4, ///< Parsing the reply data into fields for display.
+        TOTAL = 5, ///< The whole operation, over all of its attempts.
+        PHASE_COUNT = 6 ///< Number of phases.
+    };
+
+    /**
+     * @enum Outcome
+     * @brief Outcomes of a single attempt of an operation.
+     */
+    enum Outcome
+    {
+        SUCCESS = 0, ///< The reply to the attempt arrived.
+        TIMEOUT = 1, ///< No reply arrived in time.
+        ID_MISMATCH = 2, ///< A reply to another request arrived.
+        PARITY_FAILURE = 3, ///< A datagram failed the parity check.
+        DECODE_FAILURE = 4, ///< A datagram passed the parity check but could not be deserialized.
+        OUTCOME_COUNT = 5 ///< Number of outcomes.
+    };
+
+    static constexpr int REQUEST_TYPE_COUNT = 6; ///< Number of request types, from READ to ECHO.
+
+    /**
+     * @struct OperationStats
+     * @brief Statistics of the operations of one request type.
+     */
+    struct OperationStats
+    {
+        int64_t operations = 0; ///< Number of completed operations.
+        int64_t failures = 0; ///< Number of operations that gave up without a reply.
+        int64_t retries = 0; ///< Number of retransmissions.
+        int64_t inFlight = 0; ///< Number of operations in progress.
+        std::array<int64_t, OUTCOME_COUNT> attempts{}; ///< Number of attempts of each outcome.
+        std::array<LatencyHistogram, PHASE_COUNT> phases; ///< Duration of each phase in nanoseconds.
+    };
+
+    using Snapshot = std::array<OperationStats, REQUEST_TYPE_COUNT>; ///< Statistics of each request type.
+
+    /**
+     * @brief Constructs empty statistics.
+     */
+    ClientStats();
+
+    /**
+     * @brief Counts the start of an operation, which is in flight until recordOperation() is called for it.
+     * @param requestType The request type of the operation. Other values are ignored.
+     */
+    void beginOperation(int requestType);
+
+    /**
+     * @brief Counts a retransmission.
+     * @param requestType The request type of the operation. Other values are ignored.
+     */
+    void recordRetry(int requestType);
+
+    /**
+     * @brief Records the duration of a phase.
+     * @param requestType The request type of the operation. Other values are ignored.
+     * @param phase The phase.
+     * @param elapsed The duration.
+     */
+    void recordPhase(int requestType, Phase phase, Clock::duration elapsed);
+
+    /**
+     * @brief Counts an attempt.
+     * @param requestType The request type of the operation. Other values are ignored.
+     * @param outcome The outcome of the attempt.
+     */
+    void recordAttempt(int requestType, Outcome outcome);
+
+    /**
+     * @brief Counts a completed operation, no longer in flight, and records its total duration.
+     * @param requestType The request type of the operation. Other values are ignored.
+     * @param succeeded Whether a reply was received.
+     * @param elapsed The duration of the operation.
+     */
+    void recordOperation(int requestType, bool succeeded, Clock::duration elapsed);
+
+    /**
+     * @brief Copies the current statistics.
+     * @return The statistics of each request type, indexed by request type.
+     */
+    Snapshot snapshot() const;
+
+    /**
+     * @brief Gets the name of a request type.
+     * @param requestType The request type.
+     * @return The name, e.g. "READ".
+     */
+    static const char *getRequestTypeName(int requestType);
+
+    /**
+     * @brief Gets the name of a phase.
+     * @param phase The phase.
+     * @return The name, e.g. "serialize".
+     */
+    static const char *getPhaseName(Phase phase);
+
+    /**
+     * @brief Gets the name of an outcome.
+     * @param outcome The outcome.
+     * @return The name, e.g. "timeout".
+     */
+    static const char *getOutcomeName(Outcome outcome);
+
+private:
+    static constexpr int64_t MAX_NANOSECONDS = (int64_t(1) << 36) - 1; ///< Longest recorded duration, about 68 seconds. Longer ones are clamped.
+
+    size_t bucketCount; ///< Number of histogram buckets per phase, enough for MAX_NANOSECONDS.
+    std::unique_ptr<std::atomic<int64_t>[]> buckets; ///< Histogram bucket counts, indexed by request type, phase and bucket.
+    std::array<std::atomic<int64_t>, REQUEST_TYPE_COUNT> operations; ///< Completed operations of each request type.
+    std::array<std::atomic<int64_t>, REQUEST_TYPE_COUNT> failures; ///< Failed operations of each request type.
+    std::array<std::atomic<int64_t>, REQUEST_TYPE_COUNT> retries; ///< Retransmissions of each request type.
+    std::array<std::atomic<int64_t>, REQUEST_TYPE_COUNT> inFlight; ///< Operations in progress of each request type.
+    std::array<std::atomic<int64_t>, REQUEST_TYPE_COUNT * OUTCOME_COUNT> attempts; ///< Attempts, indexed by request type and outcome.
+
+    /**
+     * @brief Checks whether a request type has statistics.
+     * @param requestType The request type.
+     * @return True for READ to ECHO.
+     */
+    static bool isTracked(int requestType);
+};
+
+#endif // CLIENT_STATS_HPP
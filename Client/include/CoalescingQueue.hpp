@@ -0,0 +1,297 @@
+#ifndef COALESCING_QUEUE_HPP
+#define COALESCING_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @struct CoalescingQueueStats
+ * @brief Counters describing what happened to the values pushed into a CoalescingQueue.
+ */
+struct CoalescingQueueStats
+{
+    uint64_t enqueued; ///< Values accepted by push().
+    uint64_t delivered; ///< Values returned by pop().
+    uint64_t coalesced; ///< Values replaced by a newer value for the same key before being popped.
+    uint64_t dropped; ///< Values rejected because the queue was full.
+};
+
+/**
+ * @class CoalescingQueue
+ * @brief A bounded, lock-free single-producer single-consumer queue that keeps only the latest value per key.
+ *
+ * Each key owns a slot holding its pending value. Pushing a value for a key whose previous value has not been
+ * popped yet replaces that value (coalescing) instead of queueing a second entry. A ring of keys records the
+ * order in which keys became pending; when the ring is full, new values are dropped. The producer never blocks,
+ * so a slow consumer cannot stall it, while the consumer may block in waitPop() until a value is pushed.
+ *
+ * Values are moved into nodes allocated once at construction, one per key and two more, which is as many as
+ * can be in use at once: pending in a slot, being popped by the consumer, or kept spare by the producer after a
+ * value was replaced or dropped. Popped nodes are handed back to the producer through a second ring, so pushing
+ * and popping allocate nothing.
+ *
+ * @tparam T The type of the queued values, which must be default-constructible and move-assignable.
+ *
+ * @note push() must only be called from one thread and pop() and waitPop() from one (possibly different) thread.
+ */
+template <typename T>
+class CoalescingQueue
+{
+public:
+    /**
+     * @brief Counters describing what happened to pushed values.
+     */
+    using Stats = CoalescingQueueStats;
+
+    /**
+     * @brief Constructs a queue for keys in [0, keyCount) holding at most capacity pending keys.
+     * @param keyCount The number of distinct keys.
+     * @param capacity The maximum number of keys pending at once (rounded up to a power of two).
+     */
+    CoalescingQueue(size_t keyCount, size_t capacity)
+        : slots(keyCount), nodes(keyCount + 2), spareNode(nullptr), head(0), tail(0), freeHead(0), freeTail(0),
+          pushSignal(0), closed(false), enqueuedCount(0), deliveredCount(0), coalescedCount(0), droppedCount(0)
+    {
+        for (auto &slot : slots)
+        {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+
+        ring.resize(roundUpToPowerOfTwo(capacity));
+        mask = ring.size() - 1;
+
+        freeRing.resize(roundUpToPowerOfTwo(nodes.size()));
+        freeMask = freeRing.size() - 1;
+        for (size_t i = 0; i < nodes.size(); ++i)
+        {
+            freeRing[i] = &nodes[i];
+        }
+        freeTail.store(nodes.size(), std::memory_order_relaxed);
+    }
+
+    CoalescingQueue(const CoalescingQueue &) = delete;
+    CoalescingQueue &operator=(const CoalescingQueue &) = delete;
+
+    /**
+     * @brief Queues a value for a key, replacing the key's pending value if there is one.
+     * @param key The key of the value, less than the key count.
+     * @param value The value to queue.
+     * @return False if the value was dropped because the queue was full, true otherwise.
+     */
+    bool push(size_t key, T &&value)
+    {
+        T *item = takeNode();
+        *item = std::move(value);
+        T *previous = slots[key].exchange(item, std::memory_order_acq_rel);
+
+        if (previous != nullptr)
+        {
+            // The key is already in the ring (or being popped), the consumer will pick up the new value
+            spareNode = previous;
+            coalescedCount.fetch_add(1, std::memory_order_relaxed);
+            enqueuedCount.fetch_add(1, std::memory_order_relaxed);
+            signalPush();
+            return true;
+        }
+
+        size_t currentTail = tail.load(std::memory_order_relaxed);
+        if (currentTail - head.load(std::memory_order_acquire) >= ring.size())
+        {
+            // No ring entry refers to this slot, so the consumer cannot race us for it
+            spareNode = slots[key].exchange(nullptr, std::memory_order_acq_rel);
+            droppedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        ring[currentTail & mask] = key;
+        tail.store(currentTail + 1, std::memory_order_release);
+        enqueuedCount.fetch_add(1, std::memory_order_relaxed);
+        signalPush();
+        return true;
+    }
+
+    /**
+     * @brief Takes the oldest pending value.
+     * @param value The variable to move the value into.
+     * @return True if a value was taken, false if the queue was empty.
+     */
+    bool pop(T &value)
+    {
+        while (true)
+        {
+            size_t currentHead = head.load(std::memory_order_relaxed);
+            if (currentHead == tail.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+
+            size_t key = ring[currentHead & mask];
+            head.store(currentHead + 1, std::memory_order_release);
+
+            T *item = slots[key].exchange(nullptr, std::memory_order_acq_rel);
+            if (item == nullptr)
+            {
+                continue;
+            }
+
+            value = std::move(*item);
+            returnNode(item);
+            deliveredCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    /**
+     * @brief Takes the oldest pending value, blocking until one is pushed or the queue is closed.
+     * @param value The variable to move the value into.
+     * @return True if a value was taken, false if the queue is closed and empty.
+     */
+    bool waitPop(T &value)
+    {
+        while (true)
+        {
+            // Read before popping, so that a push after a failed pop changes it and ends the wait
+            uint32_t observed = pushSignal.load(std::memory_order_acquire);
+            if (pop(value))
+            {
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire))
+            {
+                return pop(value);
+            }
+            pushSignal.wait(observed, std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Wakes a consumer blocked in waitPop(), which returns once the queue is empty.
+     */
+    void close()
+    {
+        closed.store(true, std::memory_order_release);
+        pushSignal.fetch_add(1, std::memory_order_release);
+        pushSignal.notify_all();
+    }
+
+    /**
+     * @brief Lets waitPop() block again after close().
+     */
+    void reopen()
+    {
+        closed.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Checks whether any value is pending.
+     * @return True if no value is pending, false otherwise.
+     */
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Gets the number of distinct keys.
+     * @return The key count given at construction.
+     */
+    size_t getKeyCount() const
+    {
+        return slots.size();
+    }
+
+    /**
+     * @brief Gets a snapshot of the queue's counters.
+     * @return The current counters.
+     */
+    Stats getStats() const
+    {
+        return {
+            enqueuedCount.load(std::memory_order_relaxed),
+            deliveredCount.load(std::memory_order_relaxed),
+            coalescedCount.load(std::memory_order_relaxed),
+            droppedCount.load(std::memory_order_relaxed)
+        };
+    }
+
+private:
+    std::vector<std::atomic<T *>> slots; ///< Pending value of each key, or nullptr.
+    std::vector<T> nodes; ///< Storage of the values, one node per key and two more.
+    T *spareNode; ///< Node the producer took back from a slot, used before the free ring; producer only.
+    std::vector<size_t> ring; ///< Keys in the order they became pending.
+    size_t mask; ///< Ring size minus one, for wrapping indices.
+    std::vector<T *> freeRing; ///< Nodes not in use, handed back by the consumer.
+    size_t freeMask; ///< Free ring size minus one, for wrapping indices.
+    std::atomic<size_t> head; ///< Next ring index to pop, written by the consumer.
+    std::atomic<size_t> tail; ///< Next ring index to push, written by the producer.
+    size_t freeHead; ///< Next free ring index to take; producer only.
+    std::atomic<size_t> freeTail; ///< Next free ring index to return to, written by the consumer.
+    std::atomic<uint32_t> pushSignal; ///< Changed by every push and by close(), waited on by waitPop().
+    std::atomic<bool> closed; ///< Whether waitPop() returns instead of blocking on an empty queue.
+    std::atomic<uint64_t> enqueuedCount; ///< Values accepted by push().
+    std::atomic<uint64_t> deliveredCount; ///< Values returned by pop().
+    std::atomic<uint64_t> coalescedCount; ///< Values replaced before being popped.
+    std::atomic<uint64_t> droppedCount; ///< Values rejected because the queue was full.
+
+    /**
+     * @brief Takes a node for a pushed value, preferring the spare one.
+     * @return The node; one is always free, as at most one node per key and one being popped are in use.
+     */
+    T *takeNode()
+    {
+        if (spareNode != nullptr)
+        {
+            T *node = spareNode;
+            spareNode = nullptr;
+            return node;
+        }
+
+        // A node is free by the count above, waiting only covers its return not being visible yet
+        while (freeHead == freeTail.load(std::memory_order_acquire))
+        {
+            std::this_thread::yield();
+        }
+        return freeRing[freeHead++ & freeMask];
+    }
+
+    /**
+     * @brief Hands a popped node back to the producer.
+     * @param node The node, whose value has been moved out.
+     */
+    void returnNode(T *node)
+    {
+        size_t currentTail = freeTail.load(std::memory_order_relaxed);
+        freeRing[currentTail & freeMask] = node;
+        freeTail.store(currentTail + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Wakes a consumer blocked in waitPop().
+     */
+    void signalPush()
+    {
+        pushSignal.fetch_add(1, std::memory_order_release);
+        pushSignal.notify_one();
+    }
+
+    /**
+     * @brief Rounds a size up to a power of two.
+     * @param size The size.
+     * @return The smallest power of two not less than size, at least 1.
+     */
+    static size_t roundUpToPowerOfTwo(size_t size)
+    {
+        size_t rounded = 1;
+        while (rounded < size)
+        {
+            rounded <<= 1;
+        }
+        return rounded;
+    }
+};
+
+#endif // COALESCING_QUEUE_HPP
@@ -29,18 +29,149 @@ namespace Constants
     const int BUFFER_SIZE = 1024;
 
     /**
-     * @brief Days of the week.
-     */
-    const std::vector<std::string> DAYS_OF_WEEK = {
-        "MONDAY",
-        "TUESDAY",
-        "WEDNESDAY",
-        "THURSDAY",
-        "FRIDAY",
-        "SATURDAY",
-        "SUNDAY"
+     * @brief Largest UDP payload that fits in an IPv4 datagram, used for receive buffers that take batched replies.
+     */
+    const int MAX_DATAGRAM_SIZE = 65507;
+
+    /**
+     * @brief Largest batch request in bytes: a 1500-byte Ethernet MTU minus the IPv4 and UDP headers.
+     */
+    const int BATCH_MTU = 1472;
+
+    /**
+     * @brief Default time in microseconds a batch waits for more requests after its first request.
+     */
+    const int BATCH_LINGER_US = 50;
+
+    /**
+     * @brief Maximum number of datagrams an EventLoop receives before checking its timers again.
+     */
+    const int EVENT_LOOP_RECEIVE_BUDGET = 64;
+
+    /**
+     * @brief Lease in seconds requested for each monitoring registration made by MonitorManager.
+     */
+    const int MONITOR_LEASE_SEC = 60;
+
+    /**
+     * @brief Seconds before a monitoring lease expires at which MonitorManager re-registers it.
+     * 
+     * This has to cover the server's processing delay so that the new registration is in place before the old one lapses.
+     */
+    const int MONITOR_RENEW_MARGIN_SEC = 10;
+
+    /**
+     * @brief Maximum number of facilities a MonitorManager can watch at once.
+     */
+    const int MONITOR_MAX_FACILITIES = 256;
+
+    /**
+     * @brief Maximum number of facilities with an update waiting for delivery in a MonitorManager.
+     */
+    const int MONITOR_QUEUE_CAPACITY = 256;
+
+    /**
+     * @brief Number of requests Client::submitPipelined() keeps in flight before it has seen any reply.
+     */
+    const int PIPELINE_INITIAL_WINDOW = 2;
+
+    /**
+     * @brief Maximum number of requests Client::submitPipelined() keeps in flight.
+     */
+    const int PIPELINE_MAX_WINDOW = 16;
+
+    /**
+     * @brief Maximum number of requests a SharedClient keeps in flight across all calling threads.
+     */
+    const int SHARED_CLIENT_MAX_IN_FLIGHT = 1024;
+
+    /**
+     * @brief Interval in milliseconds at which the receive thread of a SharedClient checks for expired requests.
+     */
+    const int SHARED_CLIENT_POLL_MS = 10;
+
+    /**
+     * @brief Lower bound of the retransmission timeout derived from measured round trips, in milliseconds.
+     */
+    const int MIN_RTO_MS = 200;
+
+    /**
+     * @brief Upper bound of the retransmission timeout, including exponential backoff, in milliseconds.
+     */
+    const int MAX_RTO_MS = 60000;
+
+    /**
+     * @brief Size in bytes of the memory-mapped request journal file.
+     */
+    const int JOURNAL_CAPACITY = 1 << 20;
+
+    /**
+     * @brief Number of journal records appended between two asynchronous flushes of the mapping to disk.
+     */
+    const int JOURNAL_SYNC_BATCH = 16;
+
+    /**
+     * @brief Upper bounds in seconds of the latency histogram buckets exported to Prometheus.
+     */
+    const std::vector<double> METRICS_LATENCY_BUCKETS = {
+        0.00001, 0.00005, 0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30
     };
 
+    /**
+     * @brief Time in milliseconds the metrics endpoint waits for a scrape request before dropping the connection.
+     */
+    const int METRICS_REQUEST_TIMEOUT_MS = 1000;
+
+    /**
+     * @brief Interval in milliseconds at which the metrics endpoint checks whether it should stop.
+     */
+    const int METRICS_POLL_INTERVAL_MS = 200;
+
+    /**
+     * @brief Address the metrics endpoint listens on unless another is given, reachable only from the same host.
+     */
+    const std::string METRICS_BIND_ADDRESS = "127.0.0.1";
+
+    /**
+     * @brief Number of trace events kept per thread; older events are overwritten.
+     */
+    const int TRACE_RING_CAPACITY = 16384;
+
+    /**
+     * @brief Longest time in milliseconds the fault injector waits for a datagram before checking whether it should stop.
+     */
+    const int FAULT_POLL_INTERVAL_MS = 50;
+
+    /**
+     * @brief Default age in milliseconds up to which cached availability is trusted to reject bookings locally.
+     */
+    const int PRECHECK_MAX_AGE_MS = 2000;
+
+    /**
+     * @brief Default number of parsed availability replies kept by a ParseMemo.
+     */
+    const int PARSE_MEMO_CAPACITY = 64;
+
+    /**
+     * @brief Default maximum number of candidate slots returned by SlotFinder.
+     */
+    const int SLOT_SEARCH_MAX_CANDIDATES = 32;
+
+    /**
+     * @brief Number of days in a week.
+     */
+    const int DAYS_PER_WEEK = 7;
+
+    /**
+     * @brief Day mask of every day of the week, with bit i set for day i counted from Monday.
+     */
+    const int ALL_DAYS_MASK = (1 << DAYS_PER_WEEK) - 1;
+
+    /**
+     * @brief Number of minutes in a day, the resolution of availability calendars.
+     */
+    const int MINUTES_PER_DAY = 24 * 60;
+
     /**
      * @brief Main menu content.
      */
@@ -82,6 +213,16 @@ namespace Constants
      * @brief Status string indicating an error occurred.
      */
     const std::string STATUS_ERROR = "status:ERROR";
+
+    /**
+     * @brief Message of the server when a booking overlaps a booked or closed period, also used for bookings rejected locally.
+     */
+    const std::string SLOT_UNAVAILABLE_MESSAGE = "Facility not available at the requested time";
+
+    /**
+     * @brief Message of the error returned by the clients when a request got no reply in MAX_RETRIES attempts.
+     */
+    const std::string REQUEST_FAILED_MESSAGE = "Request failed after " + std::to_string(MAX_RETRIES) + " attempts.";
 }
 
 #endif // CONSTANTS_HPP
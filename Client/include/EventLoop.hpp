@@ -0,0 +1,221 @@
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <chrono>
+#include <coroutine>
+#include <deque>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "RequestIdentity.hpp"
+#include "RequestMessage.hpp"
+#include "Socket.hpp"
+#include "Task.hpp"
+
+/**
+ * @class EventLoop
+ * @brief Runs coroutines that talk to the server over a single socket owned by the loop.
+ *
+ * Coroutines suspend on the awaitables returned by sleep(), receiveReply() and receivePush() instead of
+ * blocking in recvfrom. The loop waits for the socket and the earliest timer at the same time, routes each
+ * received datagram to the coroutine awaiting its request ID, and resumes coroutines whose timers expired.
+ * Any number of AsyncClients can share one loop; a loop and its coroutines must stay on one thread, and
+ * several loops can run on several threads.
+ */
+class EventLoop
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+private:
+    /**
+     * @brief What a waiting coroutine is waiting for.
+     */
+    enum class WaitKind
+    {
+        SLEEP, ///< Only the timer.
+        REPLY, ///< The reply with a given request ID, or the timer.
+        PUSH ///< The next monitoring update, or the timer.
+    };
+
+    /**
+     * @struct Waiter
+     * @brief Registration of a suspended coroutine with the loop.
+     */
+    struct Waiter
+    {
+        WaitKind kind; ///< What the coroutine is waiting for.
+        int requestID; ///< Request ID of the awaited reply, for REPLY waits.
+        Clock::time_point deadline; ///< Time at which the wait ends without a message.
+        std::coroutine_handle<> handle; ///< The suspended coroutine.
+        std::multimap<Clock::time_point, Waiter *>::iterator timer; ///< Entry of the deadline in the timer queue.
+        std::shared_ptr<RequestMessage> message; ///< Message that ended the wait, or nullptr if the deadline passed.
+    };
+
+public:
+    /**
+     * @class Awaiter
+     * @brief Awaitable that suspends a coroutine until a message arrives or a deadline passes.
+     */
+    class Awaiter
+    {
+    public:
+        bool await_ready() const noexcept { return false; }
+
+        /**
+         * @brief Registers the suspended coroutine with the loop.
+         * @param handle The suspended coroutine.
+         */
+        void await_suspend(std::coroutine_handle<> handle);
+
+        /**
+         * @brief Gets the message that ended the wait.
+         * @return The received message, or nullptr if the deadline passed first.
+         */
+        std::shared_ptr<RequestMessage> await_resume() noexcept { return waiter.message; }
+
+    private:
+        friend class EventLoop;
+
+        Awaiter(EventLoop &loop, WaitKind kind, int requestID, Clock::time_point deadline);
+
+        EventLoop &loop; ///< Loop that resumes the coroutine.
+        Waiter waiter; ///< Registration of the coroutine, which stays in place while it is suspended.
+    };
+
+    /**
+     * @brief Constructs an event loop with its own UDP socket bound to any available port.
+     * @throws std::runtime_error if the socket cannot be created or bound.
+     */
+    EventLoop();
+
+    /**
+     * @brief Closes the socket.
+     */
+    ~EventLoop();
+
+    EventLoop(const EventLoop &) = delete;
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    /**
+     * @brief Schedules a task to be started by run().
+     * @param task The task to run to completion.
+     */
+    void spawn(Task<void> task);
+
+    /**
+     * @brief Runs the loop until every spawned task has finished.
+     */
+    void run();
+
+    /**
+     * @brief Suspends the awaiting coroutine for a duration.
+     * @param duration The time to sleep.
+     * @return An awaitable that always yields nullptr.
+     */
+    Awaiter sleep(std::chrono::milliseconds duration);
+
+    /**
+     * @brief Suspends the awaiting coroutine until the reply to a request arrives.
+     * @param requestID The request ID of the awaited reply.
+     * @param timeout The maximum time to wait.
+     * @return An awaitable yielding the reply, or nullptr on timeout.
+     */
+    Awaiter receiveReply(int requestID, std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Suspends the awaiting coroutine until the server pushes a monitoring update.
+     * @param timeout The maximum time to wait.
+     * @return An awaitable yielding the update, or nullptr on timeout.
+     */
+    Awaiter receivePush(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Sends a datagram from the loop's socket.
+     * @param data The serialized message.
+     * @param addr The destination address.
+     * @throws std::runtime_error if sending fails.
+     */
+    void send(const std::vector<uint8_t> &data, const struct sockaddr_in &addr);
+
+    /**
+     * @brief Allocates a request ID unique on the loop's socket.
+     * @return The request ID.
+     */
+    int nextRequestID();
+
+    /**
+     * @brief Gets the source of the identities of the requests sent through the loop.
+     * @return The identity source.
+     */
+    RequestIdentitySource &getIdentitySource();
+
+    /**
+     * @brief Gets the number of spawned tasks that have not finished.
+     * @return The number of active tasks.
+     */
+    size_t getActiveTaskCount() const;
+
+private:
+    /**
+     * @struct DetachedTask
+     * @brief Coroutine wrapping a spawned task, which destroys itself when the task finishes.
+     */
+    struct DetachedTask
+    {
+        struct promise_type
+        {
+            DetachedTask get_return_object() { return {std::coroutine_handle<promise_type>::from_promise(*this)}; }
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept {}
+        };
+
+        std::coroutine_handle<promise_type> handle; ///< The wrapping coroutine, started from the ready queue.
+    };
+
+    Socket socket; ///< Socket shared by all coroutines of the loop.
+    int requestID; ///< Next request ID to allocate. ID 0 is reserved for server-initiated messages.
+    RequestIdentitySource identitySource; ///< Identities of the requests sent through the loop.
+    size_t activeTasks; ///< Number of spawned tasks that have not finished.
+    std::deque<std::coroutine_handle<>> readyQueue; ///< Coroutines to resume in order.
+    std::multimap<Clock::time_point, Waiter *> timers; ///< Deadlines of all suspended coroutines.
+    std::unordered_map<int, Waiter *> replyWaiters; ///< Coroutines waiting for a reply, keyed by request ID.
+    std::vector<Waiter *> pushWaiters; ///< Coroutines waiting for a monitoring update.
+    std::vector<char> recvBuffer; ///< Buffer for received datagrams.
+
+    /**
+     * @brief Runs a spawned task and counts it as finished afterwards.
+     * @param task The task to run.
+     * @return The wrapping coroutine.
+     */
+    DetachedTask launch(Task<void> task);
+
+    /**
+     * @brief Registers a suspended coroutine's wait with the loop.
+     * @param waiter The registration of the coroutine.
+     */
+    void addWaiter(Waiter &waiter);
+
+    /**
+     * @brief Ends a wait and queues the coroutine to be resumed.
+     * @param waiter The registration of the coroutine.
+     * @param message The message that ended the wait, or nullptr if the deadline passed.
+     */
+    void completeWaiter(Waiter &waiter, const std::shared_ptr<RequestMessage> &message);
+
+    /**
+     * @brief Receives and routes the datagrams waiting on the socket.
+     */
+    void receiveDatagrams();
+
+    /**
+     * @brief Ends the waits whose deadline has passed.
+     */
+    void fireExpiredTimers();
+};
+
+#endif // EVENT_LOOP_HPP
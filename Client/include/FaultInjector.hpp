@@ -0,0 +1,203 @@
+#ifndef FAULT_INJECTOR_HPP
+#define FAULT_INJECTOR_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Socket.hpp"
+
+/**
+ * @class FaultInjector
+ * @brief UDP relay between a client and the server that drops, delays, duplicates, reorders and corrupts datagrams.
+ *
+ * The client sends to the relay's local port instead of the server, and the relay forwards each datagram in
+ * either direction after applying the impairment of that direction. All random choices are made on the relay
+ * thread from one generator with a fixed seed, so the same sequence of datagrams is impaired the same way in
+ * every run. As the client talks to a plain socket, any client (Client, SharedClient, AsyncClient or a load
+ * generator) can be impaired without changes.
+ *
+ * @note The relay serves one client: replies from the server go to the address that sent the last request.
+ */
+class FaultInjector
+{
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of the delays.
+
+    /**
+     * @enum Direction
+     * @brief Directions in which datagrams pass the relay.
+     */
+    enum Direction
+    {
+        TO_SERVER = 0, ///< Requests from the client to the server.
+        TO_CLIENT = 1 ///< Replies and monitoring updates from the server to the client.
+    };
+
+    /**
+     * @enum DelayDistribution
+     * @brief Distributions of the random part of the delay.
+     */
+    enum DelayDistribution
+    {
+        UNIFORM, ///< Uniform within delay - jitter and delay + jitter.
+        NORMAL, ///< Normal with mean delay and standard deviation jitter, cut off at 0.
+        EXPONENTIAL ///< delay plus an exponential tail with mean jitter.
+    };
+
+    /**
+     * @struct Impairment
+     * @brief Impairment of one direction. The default impairs nothing.
+     */
+    struct Impairment
+    {
+        double dropProbability = 0; ///< Long-run fraction of datagrams dropped.
+        double lossBurstLength = 1; ///< Mean number of consecutive drops, at least 1 / (1 - dropProbability); 1 or less drops datagrams independently.
+        double duplicateProbability = 0; ///< Probability of delivering a datagram twice, each copy delayed independently.
+        double corruptProbability = 0; ///< Probability of flipping one random bit of a datagram.
+        double reorderProbability = 0; ///< Probability of holding a datagram back by reorderDelay so that later ones overtake it.
+        std::chrono::microseconds reorderDelay{5000}; ///< Extra delay of reordered datagrams.
+        std::chrono::microseconds delay{0}; ///< Base delay of every datagram.
+        std::chrono::microseconds jitter{0}; ///< Spread of the delay, as described by distribution.
+        DelayDistribution distribution = UNIFORM; ///< Distribution of the delay.
+    };
+
+    /**
+     * @struct Counters
+     * @brief Number of datagrams of one direction by what was done to them.
+     */
+    struct Counters
+    {
+        int64_t received = 0; ///< Datagrams that entered the relay.
+        int64_t dropped = 0; ///< Datagrams dropped.
+        int64_t duplicated = 0; ///< Datagrams delivered twice.
+        int64_t corrupted = 0; ///< Datagrams with a flipped bit.
+        int64_t reordered = 0; ///< Datagrams held back to be overtaken.
+    };
+
+    /**
+     * @brief Binds the relay to a free local port and starts its thread.
+     * @param serverIp The IP address or hostname of the server.
+     * @param serverPort The port number of the server.
+     * @param toServer The impairment of requests.
+     * @param toClient The impairment of replies.
+     * @param seed The seed of the random choices.
+     * @throws std::runtime_error if the socket cannot be set up or the server address cannot be resolved.
+     */
+    FaultInjector(const std::string &serverIp, int serverPort, const Impairment &toServer, const Impairment &toClient, uint64_t seed);
+
+    /**
+     * @brief Stops the relay thread. Datagrams still held back are discarded.
+     */
+    ~FaultInjector();
+
+    FaultInjector(const FaultInjector &) = delete;
+    FaultInjector &operator=(const FaultInjector &) = delete;
+
+    /**
+     * @brief Gets the local port the client should send to instead of the server.
+     * @return The port number.
+     */
+    int getPort();
+
+    /**
+     * @brief Gets the counters of a direction.
+     * @param direction The direction.
+     * @return The counters so far.
+     */
+    Counters getCounters(Direction direction) const;
+
+private:
+    /**
+     * @struct Scheduled
+     * @brief A datagram held back until its delivery time.
+     */
+    struct Scheduled
+    {
+        Clock::time_point due; ///< Delivery time.
+        uint64_t order; ///< Order of scheduling, which breaks ties between equal delivery times.
+        Direction direction; ///< Direction of the datagram.
+        std::vector<uint8_t> data; ///< Bytes of the datagram.
+
+        /**
+         * @brief Orders datagrams so that the earliest is on top of a priority queue.
+         * @param other The other datagram.
+         * @return True if this datagram is delivered after the other.
+         */
+        bool operator>(const Scheduled &other) const;
+    };
+
+    /**
+     * @enum CounterIndex
+     * @brief Counters of a direction, in the order of the fields of Counters.
+     */
+    enum CounterIndex
+    {
+        RECEIVED = 0, ///< Datagrams that entered the relay.
+        DROPPED = 1, ///< Datagrams dropped.
+        DUPLICATED = 2, ///< Datagrams delivered twice.
+        CORRUPTED = 3, ///< Datagrams with a flipped bit.
+        REORDERED = 4, ///< Datagrams held back to be overtaken.
+        COUNTER_COUNT = 5 ///< Number of counters per direction.
+    };
+
+    Socket socket; ///< Socket shared by both directions.
+    struct sockaddr_in serverAddr; ///< Address of the server.
+    struct sockaddr_in clientAddr; ///< Address of the client, learned from its last request.
+    bool hasClient; ///< Whether a request has been received, so that clientAddr is known.
+    std::array<Impairment, 2> impairments; ///< Impairment of each direction.
+    std::array<bool, 2> inLossBurst; ///< Whether each direction is dropping a burst.
+    std::mt19937_64 random; ///< Source of all random choices.
+    std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>> pending; ///< Datagrams held back, earliest first.
+    uint64_t nextOrder; ///< Order of the next scheduled datagram.
+    std::array<std::atomic<int64_t>, 2 * COUNTER_COUNT> counters; ///< Counters, indexed by direction and counter.
+    std::atomic<bool> running; ///< Whether the relay thread should keep running.
+    std::thread relayThread; ///< Thread forwarding the datagrams.
+
+    /**
+     * @brief Receives and forwards datagrams until the relay is destroyed.
+     */
+    void relayLoop();
+
+    /**
+     * @brief Applies the impairment of a direction to a datagram and schedules the copies to deliver.
+     * @param direction The direction of the datagram.
+     * @param data The bytes of the datagram.
+     */
+    void impair(Direction direction, std::vector<uint8_t> data);
+
+    /**
+     * @brief Decides whether to drop the next datagram of a direction.
+     * @param direction The direction.
+     * @return True to drop it.
+     */
+    bool shouldDrop(Direction direction);
+
+    /**
+     * @brief Draws the delay of one copy of a datagram.
+     * @param impairment The impairment of its direction.
+     * @return The delay.
+     */
+    Clock::duration drawDelay(const Impairment &impairment);
+
+    /**
+     * @brief Sends the held-back datagrams whose delivery time has come.
+     */
+    void deliverDue();
+
+    /**
+     * @brief Increments a counter.
+     * @param direction The direction.
+     * @param counter The counter.
+     */
+    void count(Direction direction, CounterIndex counter);
+};
+
+#endif // FAULT_INJECTOR_HPP
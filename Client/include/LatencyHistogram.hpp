@@ -0,0 +1,114 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class LatencyHistogram
+ * @brief Histogram of non-negative values with a bounded relative error, in the style of HdrHistogram.
+ *
+ * Values below 2 * SUB_BUCKETS are counted exactly. Larger values fall into one of SUB_BUCKETS linear
+ * buckets per power of two, so any value up to 2^63 is recorded in constant time and space with a relative
+ * error below 1 / SUB_BUCKETS. Histograms recorded on different threads can be merged.
+ *
+ * The bucket mapping is public so that other recorders, e.g. with atomic counts, can share it and convert
+ * their counts into a LatencyHistogram.
+ */
+class LatencyHistogram
+{
+public:
+    /**
+     * @brief Constructs an empty histogram.
+     */
+    LatencyHistogram();
+
+    /**
+     * @brief Records a value.
+     * @param value The value. Negative values are recorded as 0.
+     */
+    void record(int64_t value);
+
+    /**
+     * @brief Records a value several times.
+     * @param value The value. Negative values are recorded as 0.
+     * @param count The number of times to record it.
+     */
+    void record(int64_t value, int64_t count);
+
+    /**
+     * @brief Adds the counts of another histogram to this one.
+     * @param other The histogram to add.
+     */
+    void merge(const LatencyHistogram &other);
+
+    /**
+     * @brief Removes all recorded values.
+     */
+    void reset();
+
+    /**
+     * @brief Gets the number of recorded values.
+     * @return The count.
+     */
+    int64_t getCount() const;
+
+    /**
+     * @brief Gets the smallest recorded value.
+     * @return The value, or 0 if the histogram is empty.
+     */
+    int64_t getMin() const;
+
+    /**
+     * @brief Gets the largest recorded value.
+     * @return The value, or 0 if the histogram is empty.
+     */
+    int64_t getMax() const;
+
+    /**
+     * @brief Gets the mean of the recorded values.
+     * @return The mean, or 0 if the histogram is empty.
+     */
+    double getMean() const;
+
+    /**
+     * @brief Gets the value at a percentile.
+     * @param percentile The percentile, from 0 to 100.
+     * @return The highest value equivalent to the value at the percentile, or 0 if the histogram is empty.
+     */
+    int64_t getValueAtPercentile(double percentile) const;
+
+    /**
+     * @brief Gets the number of recorded values up to a bound.
+     * @param value The bound.
+     * @return The number of values in the buckets up to the bucket of the bound.
+     */
+    int64_t getCountAtOrBelow(int64_t value) const;
+
+    /**
+     * @brief Gets the bucket of a value.
+     * @param value The non-negative value.
+     * @return The index of the bucket.
+     */
+    static size_t bucketOf(int64_t value);
+
+    /**
+     * @brief Gets the highest value that falls into a bucket.
+     * @param index The index of the bucket.
+     * @return The value.
+     */
+    static int64_t highestValueOf(size_t index);
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 7; ///< Logarithm of SUB_BUCKETS.
+    static constexpr int64_t SUB_BUCKETS = int64_t(1) << SUB_BUCKET_BITS; ///< Linear buckets per power of two.
+
+    std::vector<int64_t> counts; ///< Count of each bucket, up to the highest bucket used so far.
+    int64_t totalCount; ///< Number of recorded values.
+    int64_t minValue; ///< Smallest recorded value.
+    int64_t maxValue; ///< Largest recorded value.
+    double sum; ///< Sum of the recorded values.
+};
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,151 @@
+#ifndef METRICS_EXPORTER_HPP
+#define METRICS_EXPORTER_HPP
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ClientStats.hpp"
+#include "Constants.hpp"
+#include "Socket.hpp"
+
+/**
+ * @class MetricsExporter
+ * @brief Exposes the statistics of a client in the Prometheus text exposition format.
+ *
+ * The request, retry and attempt counters, in-flight gauges and phase latency histograms of a ClientStats
+ * are exported per request type, together with any counters and gauges registered by their owners, such as
+ * cache hit counts. The text can be served on a local HTTP endpoint from a background thread, or written to
+ * a file for a textfile collector.
+ *
+ * @note The ClientStats and the values read by registered metrics must outlive the exporter, and registered
+ * metrics must be safe to read from the thread serving the endpoint.
+ */
+class MetricsExporter
+{
+public:
+    /**
+     * @brief Constructs an exporter of a client's statistics.
+     * @param stats The statistics to export.
+     */
+    explicit MetricsExporter(const ClientStats &stats);
+
+    /**
+     * @brief Stops serving the endpoint, if it is served.
+     */
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter &) = delete;
+    MetricsExporter &operator=(const MetricsExporter &) = delete;
+
+    /**
+     * @brief Registers a counter, a value that only increases.
+     * @param name The metric name, e.g. "booking_client_cache_hits_total".
+     * @param help The description of the metric.
+     * @param value Reads the current value.
+     */
+    void addCounter(const std::string &name, const std::string &help, const std::function<double()> &value);
+
+    /**
+     * @brief Registers a gauge, a value that may go up and down.
+     * @param name The metric name, e.g. "booking_client_cache_hit_ratio".
+     * @param help The description of the metric.
+     * @param value Reads the current value.
+     */
+    void addGauge(const std::string &name, const std::string &help, const std::function<double()> &value);
+
+    /**
+     * @brief Renders all metrics.
+     * @return The metrics in the Prometheus text exposition format.
+     */
+    std::string render() const;
+
+    /**
+     * @brief Writes all metrics to a file, replacing it atomically.
+     * @param path The path of the file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeFile(const std::string &path) const;
+
+    /**
+     * @brief Starts serving the metrics over HTTP from a background thread.
+     * @param port The TCP port to listen on, or 0 for any free port.
+     * @param address The local address to listen on, e.g. "0.0.0.0" for every interface.
+     * @throws std::runtime_error if the endpoint is already served, the address cannot be resolved or the port cannot be bound.
+     */
+    void serve(int port, const std::string &address = Constants::METRICS_BIND_ADDRESS);
+
+    /**
+     * @brief Stops serving the metrics and waits for the background thread.
+     */
+    void stop();
+
+    /**
+     * @brief Gets the port the metrics are served on.
+     * @return The port number, or 0 if the endpoint is not served.
+     */
+    int getPort();
+
+private:
+    /**
+     * @struct Metric
+     * @brief A registered counter or gauge.
+     */
+    struct Metric
+    {
+        std::string name; ///< Metric name.
+        std::string help; ///< Description of the metric.
+        std::string type; ///< "counter" or "gauge".
+        std::function<double()> value; ///< Reads the current value.
+    };
+
+    const ClientStats &stats; ///< Statistics of the client.
+    mutable std::mutex metricsMutex; ///< Guards metrics.
+    std::vector<Metric> metrics; ///< Registered counters and gauges.
+    Socket listener; ///< Listening socket of the endpoint.
+    std::thread serverThread; ///< Thread serving the endpoint.
+    std::atomic<bool> running; ///< Whether the endpoint should keep serving.
+
+    /**
+     * @brief Accepts scrape connections until stop() is called.
+     */
+    void serveLoop();
+
+    /**
+     * @brief Reads an HTTP request from a connection and answers it.
+     * @param connection The accepted connection.
+     */
+    void handleConnection(Socket &connection);
+
+    /**
+     * @brief Appends the HELP and TYPE lines of a metric.
+     * @param out The text to append to.
+     * @param name The metric name.
+     * @param help The description of the metric.
+     * @param type The metric type.
+     */
+    static void appendHeader(std::string &out, const std::string &name, const std::string &help, const std::string &type);
+
+    /**
+     * @brief Appends a sample of a metric.
+     * @param out The text to append to.
+     * @param name The metric name, with any suffix.
+     * @param labels The labels without braces, e.g. type="READ", or an empty string.
+     * @param value The value.
+     */
+    static void appendSample(std::string &out, const std::string &name, const std::string &labels, double value);
+
+    /**
+     * @brief Appends the bucket, sum and count samples of a latency histogram.
+     * @param out The text to append to.
+     * @param name The metric name.
+     * @param labels The labels of the histogram without braces.
+     * @param histogram The histogram of durations in nanoseconds.
+     */
+    static void appendHistogram(std::string &out, const std::string &name, const std::string &labels, const LatencyHistogram &histogram);
+};
+
+#endif // METRICS_EXPORTER_HPP
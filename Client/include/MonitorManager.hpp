@@ -0,0 +1,205 @@
+#ifndef MONITOR_MANAGER_HPP
+#define MONITOR_MANAGER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Client.hpp"
+#include "CoalescingQueue.hpp"
+#include "Constants.hpp"
+#include "RequestMessage.hpp"
+
+/**
+ * @class MonitorManager
+ * @brief Watches any number of facilities over the socket of a single Client.
+ *
+ * The MonitorManager registers each watched facility with the server in fixed-length leases and
+ * re-registers them before they expire, so that subscriptions can outlive a single registration.
+ * Monitoring updates pushed by the server are deserialized, routed by facility name to the callbacks
+ * of the matching subscriptions, and repeated updates are delivered only once.
+ *
+ * Callbacks do not run on the receive loop. Updates are handed to a delivery thread through a bounded
+ * CoalescingQueue, so a slow callback never delays draining the socket; if several updates for a facility
+ * are waiting, only the latest one is delivered. The watches are guarded by a mutex, so that callbacks may
+ * unsubscribe while the receive loop runs.
+ */
+class MonitorManager
+{
+public:
+    /**
+     * @brief Callback invoked with the facility name and the data string of each update.
+     */
+    using UpdateCallback = std::function<void(const std::string &, const std::string &)>;
+
+    /**
+     * @brief Counters of the delivery queue between the receive loop and the callbacks.
+     */
+    using DeliveryStats = CoalescingQueueStats;
+
+    /**
+     * @brief Constructs a MonitorManager that uses the given client for registrations and updates.
+     * @param client Reference to the Client object for server communication.
+     * @param leaseSeconds The duration of each registration with the server in seconds.
+     */
+    MonitorManager(Client &client, int leaseSeconds = Constants::MONITOR_LEASE_SEC);
+
+    /**
+     * @brief Detaches the manager from the client.
+     */
+    ~MonitorManager();
+
+    /**
+     * @brief Subscribes to the availability updates of a facility.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration of the subscription in seconds.
+     * @param onUpdate Callback function to handle updates for the facility.
+     * @return The ID of the new subscription, or -1 if the facility could not be registered.
+     */
+    int subscribe(const std::string &facilityName, int durationSeconds, const UpdateCallback &onUpdate);
+
+    /**
+     * @brief Cancels a subscription.
+     * @param subscriptionID The ID returned by subscribe().
+     */
+    void unsubscribe(int subscriptionID);
+
+    /**
+     * @brief Receives and dispatches updates until the duration elapses or no subscriptions remain.
+     * @param durationSeconds The maximum duration to run in seconds.
+     * @note Callbacks run on a delivery thread while this method runs. They may unsubscribe, but must not subscribe
+     * or run the manager, as both send requests over the client the receive loop is using.
+     */
+    void run(int durationSeconds);
+
+    /**
+     * @brief Gets the number of active subscriptions.
+     * @return The number of active subscriptions.
+     */
+    size_t getSubscriptionCount() const;
+
+    /**
+     * @brief Gets the number of repeated updates that were not delivered.
+     * @return The number of suppressed duplicate updates.
+     */
+    uint64_t getDuplicateCount() const;
+
+    /**
+     * @brief Gets the counters of the delivery queue.
+     * @return The numbers of enqueued, delivered, coalesced and dropped updates.
+     */
+    DeliveryStats getDeliveryStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @struct Subscription
+     * @brief A single callback registered for a facility.
+     */
+    struct Subscription
+    {
+        int id; ///< ID returned to the subscriber.
+        UpdateCallback onUpdate; ///< Callback for updates of the facility.
+        Clock::time_point endTime; ///< Time at which the subscription ends.
+    };
+
+    /**
+     * @struct FacilityWatch
+     * @brief The registration state shared by all subscriptions of a facility.
+     */
+    struct FacilityWatch
+    {
+        std::vector<Subscription> subscriptions; ///< Subscriptions for the facility.
+        size_t queueKey = 0; ///< Key under which updates of the facility are coalesced in the delivery queue.
+        Clock::time_point leaseExpiry; ///< Time at which the current server registration expires.
+        size_t lastUpdateHash = 0; ///< Hash of the last delivered update, used to drop repeats.
+        bool hasLastUpdate = false; ///< Whether an update has been delivered yet.
+        bool renewable = true; ///< Whether the lease may be renewed; cleared when the server rejects a registration for good.
+    };
+
+    /**
+     * @struct Delivery
+     * @brief An update waiting in the delivery queue, together with the callbacks to deliver it to.
+     */
+    struct Delivery
+    {
+        std::string facilityName; ///< Name of the updated facility.
+        std::string data; ///< Data string of the update.
+        std::vector<UpdateCallback> callbacks; ///< Callbacks subscribed when the update was received.
+    };
+
+    Client &client; ///< Client used for registrations and receiving updates.
+    int leaseSeconds; ///< Duration of each registration with the server in seconds.
+    int nextSubscriptionID; ///< ID assigned to the next subscription.
+    uint64_t duplicateCount; ///< Number of suppressed duplicate updates.
+    std::unordered_map<std::string, FacilityWatch> watches; ///< Watched facilities keyed by facility name.
+    std::vector<size_t> freeQueueKeys; ///< Delivery queue keys not assigned to a facility.
+    mutable std::mutex watchesMutex; ///< Guards the watches, the free queue keys and the counters, which callbacks may change.
+    CoalescingQueue<Delivery> deliveryQueue; ///< Updates waiting for the delivery thread.
+    std::thread deliveryThread; ///< Thread invoking the callbacks while run() is active.
+
+    /**
+     * @brief Registers a facility with the server for the next lease.
+     * @param facilityName The name of the facility to register, which must be watched.
+     * @param lastEndTime The end time of the longest subscription for the facility.
+     * @return True if the registration succeeded and the facility is still watched, false otherwise.
+     */
+    bool registerLease(const std::string &facilityName, Clock::time_point lastEndTime);
+
+    /**
+     * @brief Re-registers every facility whose lease is about to expire while still subscribed.
+     */
+    void renewExpiringLeases();
+
+    /**
+     * @brief Removes subscriptions that have ended, and facilities without subscriptions.
+     */
+    void removeEndedSubscriptions();
+
+    /**
+     * @brief Gets the time at which the run loop next needs to wake up.
+     * @param runEndTime The end time of the run loop.
+     * @return The earliest of the run end time, the next subscription end and the next lease renewal.
+     */
+    Clock::time_point getNextDeadline(Clock::time_point runEndTime) const;
+
+    /**
+     * @brief Routes an update to the subscriptions of its facility.
+     * @param update The update pushed by the server.
+     */
+    void handleUpdate(const RequestMessage &update);
+
+    /**
+     * @brief Invokes callbacks for queued updates until the queue is closed and drained.
+     */
+    void deliverUpdates();
+
+    /**
+     * @brief Removes a facility's watch and returns its delivery queue key. The caller holds watchesMutex.
+     * @param it Iterator to the watch to remove.
+     * @return Iterator to the watch following the removed one.
+     */
+    std::unordered_map<std::string, FacilityWatch>::iterator removeWatch(std::unordered_map<std::string, FacilityWatch>::iterator it);
+
+    /**
+     * @brief Gets the end time of the longest subscription of a facility.
+     * @param watch The watch state of the facility.
+     * @return The latest subscription end time.
+     */
+    static Clock::time_point getLastEndTime(const FacilityWatch &watch);
+
+    /**
+     * @brief Extracts the facility name from an update's data string.
+     * @param data The data string of the update.
+     * @return The facility name, or an empty string if there is none.
+     */
+    static std::string extractFacilityName(const std::string &data);
+};
+
+#endif // MONITOR_MANAGER_HPP
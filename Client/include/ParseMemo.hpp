@@ -0,0 +1,139 @@
+#ifndef PARSE_MEMO_HPP
+#define PARSE_MEMO_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Constants.hpp"
+#include "ResponseParser.hpp"
+
+/**
+ * @class ParseMemo
+ * @brief A bounded table of parsed availability replies, so that a reply identical to a recent one is not parsed again.
+ *
+ * Polling the same facility, or monitoring it, mostly yields replies the client has already seen. Each reply is
+ * keyed by a 64-bit wyhash-style hash of its text and the day mask it is parsed with, and the parsed result is
+ * shared with every caller that receives the same text again. The text of each entry is kept and compared on a
+ * hit, so that a hash collision costs a parse rather than a wrong result. The least recently used entry is evicted
+ * once the table is full.
+ *
+ * @note The table itself must only be used from one thread; the counters may be read from any thread, e.g. by a
+ * MetricsExporter.
+ */
+class ParseMemo
+{
+public:
+    /**
+     * @struct Stats
+     * @brief Counters describing how often the table saved a parse.
+     */
+    struct Stats
+    {
+        uint64_t hits; ///< Replies found in the table.
+        uint64_t misses; ///< Replies parsed, including those whose hash collided with another reply.
+        uint64_t evictions; ///< Entries removed to make room for newer ones.
+    };
+
+    /**
+     * @brief Constructs an empty table.
+     * @param capacity The maximum number of replies kept, at least 1.
+     */
+    explicit ParseMemo(size_t capacity = Constants::PARSE_MEMO_CAPACITY);
+
+    /**
+     * @brief Parses an availability reply, or returns the result of an identical reply parsed before.
+     * @param response The raw server response.
+     * @param dayMask The days to parse, with the bit of each day set.
+     * @return The availability of the listed days of the mask or the error, shared with other callers.
+     */
+    std::shared_ptr<const ResponseParser::Availability> parseQueryAvailabilityResponse(std::string_view response, uint8_t dayMask = Constants::ALL_DAYS_MASK);
+
+    /**
+     * @brief Removes every entry. The counters are kept.
+     */
+    void clear();
+
+    /**
+     * @brief Gets the number of replies kept.
+     * @return The number of entries.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Gets the counters of the table.
+     * @return The numbers of hits, misses and evictions.
+     */
+    Stats getStats() const;
+
+    /**
+     * @brief Hashes text with a seed, in the manner of wyhash.
+     * @param data The text.
+     * @param seed The seed, which changes the hash of every text.
+     * @return The 64-bit hash.
+     */
+    static uint64_t hash(std::string_view data, uint64_t seed);
+
+private:
+    /**
+     * @struct Entry
+     * @brief A parsed reply.
+     */
+    struct Entry
+    {
+        uint64_t key; ///< Hash of the reply and the day mask.
+        std::string response; ///< Text of the reply, compared on a hit.
+        uint8_t dayMask; ///< Day mask the reply was parsed with.
+        std::shared_ptr<const ResponseParser::Availability> availability; ///< The parsed reply.
+    };
+
+    size_t capacity; ///< Maximum number of entries.
+    std::list<Entry> entries; ///< Entries, most recently used first.
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index; ///< Entry of each key.
+    std::atomic<uint64_t> hitCount; ///< Replies found in the table.
+    std::atomic<uint64_t> missCount; ///< Replies parsed.
+    std::atomic<uint64_t> evictionCount; ///< Entries evicted.
+
+    /**
+     * @brief Constants of the hash, those of wyhash.
+     */
+    static constexpr uint64_t HASH_SECRETS[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+    /**
+     * @brief Multiplies two words to 128 bits and folds the halves together.
+     * @param a The first word.
+     * @param b The second word.
+     * @return The low half of the product XOR its high half.
+     */
+    static uint64_t mix(uint64_t a, uint64_t b);
+
+    /**
+     * @brief Multiplies two words to 128 bits.
+     * @param a The first word.
+     * @param b The second word.
+     * @param high Set to the high half of the product.
+     * @return The low half of the product.
+     */
+    static uint64_t multiply(uint64_t a, uint64_t b, uint64_t &high);
+
+    /**
+     * @brief Reads 8 bytes in native byte order.
+     * @param p The bytes.
+     * @return The word.
+     */
+    static uint64_t read64(const char *p);
+
+    /**
+     * @brief Reads 4 bytes in native byte order.
+     * @param p The bytes.
+     * @return The word, zero-extended.
+     */
+    static uint64_t read32(const char *p);
+};
+
+#endif // PARSE_MEMO_HPP
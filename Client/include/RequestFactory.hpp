@@ -0,0 +1,104 @@
+#ifndef REQUEST_FACTORY_HPP
+#define REQUEST_FACTORY_HPP
+
+#include <string>
+
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @class RequestFactory
+ * @brief Builds the request messages of the client operations.
+ *
+ * The RequestFactory class contains static methods that format the data string and choose the operation
+ * of each request supported by the server, so that the blocking Client and the AsyncClient send identical
+ * requests. The returned messages have request ID 0; the caller assigns the ID before sending.
+ */
+class RequestFactory
+{
+public:
+    /**
+     * @brief Builds a request for the names of all available facilities.
+     * @return The request message.
+     */
+    static RequestMessage queryFacilityNames();
+
+    /**
+     * @brief Builds a request for the availability of a facility on specific days.
+     * @param facilityName The name of the facility to query availability for.
+     * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+     * @return The request message.
+     */
+    static RequestMessage queryAvailability(const std::string &facilityName, uint8_t dayMask);
+
+    /**
+     * @brief Builds a request to book a facility for a specific day and time range.
+     * @param facilityName The name of the facility.
+     * @param dayOfWeek The day of the week.
+     * @param startTime The start time.
+     * @param endTime The end time.
+     * @return The request message.
+     */
+    static RequestMessage bookFacility(
+        const std::string &facilityName,
+        DayOfWeek dayOfWeek,
+        MinuteOfDay startTime,
+        MinuteOfDay endTime
+    );
+
+    /**
+     * @brief Builds a request for the details of an existing booking.
+     * @param bookingID The ID of the booking to query.
+     * @return The request message.
+     */
+    static RequestMessage queryBooking(const std::string &bookingID);
+
+    /**
+     * @brief Builds a request to shift an existing booking by a time offset.
+     * @param oldBooking The booking to update, as parsed from its details.
+     * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+     * @return The request message.
+     * @throws std::runtime_error if the booking has no valid day, start or end time.
+     */
+    static RequestMessage updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes);
+
+    /**
+     * @brief Builds a request to delete an existing booking.
+     * @param booking The booking to delete, as parsed from its details.
+     * @return The request message.
+     */
+    static RequestMessage deleteBooking(const ResponseParser::Booking &booking);
+
+    /**
+     * @brief Builds a request to register for the availability updates of a facility.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration of the registration in seconds.
+     * @return The request message.
+     */
+    static RequestMessage registerMonitor(const std::string &facilityName, int durationSeconds);
+
+    /**
+     * @brief Builds a request to rate a facility.
+     * @param facilityName The name of the facility to rate.
+     * @param rating The rating value (e.g., 4.5).
+     * @return The request message.
+     */
+    static RequestMessage rateFacility(const std::string &facilityName, float rating);
+
+    /**
+     * @brief Builds a request for the rating of a facility.
+     * @param facilityName The name of the facility to query.
+     * @return The request message.
+     */
+    static RequestMessage queryRating(const std::string &facilityName);
+
+    /**
+     * @brief Builds an echo request.
+     * @param messageData The message data to be echoed.
+     * @return The request message.
+     */
+    static RequestMessage echoMessage(const std::string &messageData);
+};
+
+#endif // REQUEST_FACTORY_HPP
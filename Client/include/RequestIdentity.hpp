@@ -0,0 +1,94 @@
+#ifndef REQUEST_IDENTITY_HPP
+#define REQUEST_IDENTITY_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <set>
+
+/**
+ * @struct RequestIdentity
+ * @brief Globally unique identity of a request, used by the server to detect duplicates.
+ *
+ * The nonce identifies a client instance, the epoch a run of that instance, and the sequence a request
+ * within the run. Unlike the request ID, which only matches replies to requests on one socket, the identity
+ * does not depend on the client's address and port and does not wrap.
+ */
+struct RequestIdentity
+{
+    int64_t clientNonce = 0; ///< Random identifier of the client instance. 0 means the request carries no identity.
+    int32_t epoch = 0; ///< Run of the client instance that sent the request.
+    int64_t sequence = 0; ///< Number of the request within the epoch, starting at 1.
+};
+
+/**
+ * @class RequestIdentitySource
+ * @brief Hands out the identities of the requests of one client instance.
+ *
+ * The sequence is a 64-bit atomic counter, so one source can be shared by several threads.
+ *
+ * The source also tracks which requests have completed, i.e. received their reply or been given up, and
+ * maintains the acknowledged watermark: the highest sequence up to which every request has completed. Requests
+ * carry the watermark to the server, which can then forget its cached replies to those requests.
+ */
+class RequestIdentitySource
+{
+public:
+    /**
+     * @brief Constructs a source with a random nonce, starting at epoch 1.
+     */
+    RequestIdentitySource();
+
+    /**
+     * @brief Constructs a source that resumes a known nonce in a given epoch.
+     * @param clientNonce The nonce of the client instance. Must not be 0.
+     * @param epoch The epoch of the new run, which must be higher than that of any earlier run with the nonce.
+     */
+    RequestIdentitySource(int64_t clientNonce, int32_t epoch);
+
+    /**
+     * @brief Allocates the identity of a new request.
+     * @return The identity.
+     */
+    RequestIdentity next();
+
+    /**
+     * @brief Gets the nonce of the client instance.
+     * @return The nonce.
+     */
+    int64_t getClientNonce() const;
+
+    /**
+     * @brief Gets the current epoch.
+     * @return The epoch.
+     */
+    int32_t getEpoch() const;
+
+    /**
+     * @brief Records that a request will not be sent again, because it was answered or given up.
+     * @param sequence The sequence number of the request.
+     */
+    void complete(int64_t sequence);
+
+    /**
+     * @brief Gets the acknowledged watermark.
+     * @return The highest sequence up to which every request has completed, or 0 if there is none.
+     */
+    int64_t getAckedSequence() const;
+
+    /**
+     * @brief Generates a random non-zero nonce.
+     * @return The nonce.
+     */
+    static int64_t generateNonce();
+
+private:
+    int64_t clientNonce; ///< Random identifier of the client instance.
+    int32_t epoch; ///< Current run of the client instance.
+    std::atomic<int64_t> sequence; ///< Sequence number of the next request.
+    std::atomic<int64_t> ackedSequence; ///< Highest sequence up to which every request has completed.
+    std::mutex completionMutex; ///< Guards completedAhead and advancing ackedSequence.
+    std::set<int64_t> completedAhead; ///< Completed sequences above the watermark, waiting for the gap below them to close.
+};
+
+#endif // REQUEST_IDENTITY_HPP
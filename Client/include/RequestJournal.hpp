@@ -0,0 +1,216 @@
+#ifndef REQUEST_JOURNAL_HPP
+#define REQUEST_JOURNAL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "RequestIdentity.hpp"
+
+/**
+ * @class RequestJournal
+ * @brief Memory-mapped, append-only journal of the non-idempotent requests a client has in flight.
+ *
+ * Each request is recorded with its serialized bytes, request ID and identity before it is first sent, and a
+ * completion record is appended once it is answered or given up. After a crash, the requests without a
+ * completion record can be resent byte for byte, so the server's history recognises them as duplicates.
+ *
+ * The journal also keeps the nonce of the client instance and counts its epochs, so that a restarted client
+ * continues under the same nonce in a new epoch.
+ *
+ * The records live in one of two equal regions of the file, chosen by the generation in the file header.
+ * Compacting writes the pending requests to the other region and only then switches the generation, so a
+ * crash during compaction leaves the old region in use.
+ */
+class RequestJournal
+{
+public:
+    /**
+     * @struct Entry
+     * @brief A journaled request that has not completed.
+     */
+    struct Entry
+    {
+        int32_t requestID; ///< Request ID the request was sent with.
+        RequestIdentity identity; ///< Identity the request was sent with.
+        std::vector<uint8_t> data; ///< Serialized request.
+    };
+
+    /**
+     * @brief Opens the journal at the given path, creating it if needed, and starts a new epoch.
+     * @param path The path of the journal file.
+     * @throws std::runtime_error if the file cannot be opened or mapped, or is not a journal.
+     */
+    explicit RequestJournal(const std::string &path);
+
+    /**
+     * @brief Flushes and unmaps the journal.
+     */
+    ~RequestJournal();
+
+    RequestJournal(const RequestJournal &) = delete;
+    RequestJournal &operator=(const RequestJournal &) = delete;
+
+    /**
+     * @brief Gets the nonce of the client instance.
+     * @return The nonce.
+     */
+    int64_t getClientNonce() const;
+
+    /**
+     * @brief Gets the epoch started when the journal was opened.
+     * @return The epoch.
+     */
+    int32_t getEpoch() const;
+
+    /**
+     * @brief Records a request before it is first sent.
+     * @param requestID The request ID of the request.
+     * @param identity The identity of the request.
+     * @param data The serialized request.
+     * @throws std::runtime_error if the request does not fit in the journal.
+     */
+    void append(int32_t requestID, const RequestIdentity &identity, const std::vector<uint8_t> &data);
+
+    /**
+     * @brief Records that a request will not be sent again.
+     * @param identity The identity of the request.
+     * @throws std::runtime_error if the record does not fit in the journal.
+     */
+    void complete(const RequestIdentity &identity);
+
+    /**
+     * @brief Gets the requests that have not completed, in the order they were recorded.
+     * @return The requests.
+     */
+    std::vector<Entry> getPending() const;
+
+    /**
+     * @brief Writes the records appended so far to disk and waits for the write to finish.
+     */
+    void sync();
+
+private:
+    /**
+     * @enum RecordType
+     * @brief Types of the records in the journal.
+     */
+    enum RecordType : uint32_t
+    {
+        REQUEST = 1, ///< A request and its serialized bytes.
+        COMPLETION = 2 ///< Completion of an earlier request.
+    };
+
+    /**
+     * @struct FileHeader
+     * @brief Layout of the start of the journal file.
+     */
+    struct FileHeader
+    {
+        uint32_t magic; ///< FILE_MAGIC once the file is initialised.
+        uint32_t version; ///< Layout version of the file.
+        int64_t clientNonce; ///< Nonce of the client instance.
+        int32_t epoch; ///< Epoch of the latest run.
+        uint32_t generation; ///< Number of compactions; its lowest bit selects the region holding the records.
+        uint64_t regionSize; ///< Size of each of the two regions of records.
+    };
+
+    /**
+     * @struct RecordHeader
+     * @brief Layout of the header preceding each record.
+     */
+    struct RecordHeader
+    {
+        uint32_t marker; ///< RECORD_MARKER once the record is fully written, 0 past the last record.
+        uint32_t type; ///< RecordType of the record.
+        uint32_t length; ///< Number of bytes of serialized request following the header.
+        int32_t requestID; ///< Request ID of the request.
+        int32_t epoch; ///< Epoch of the request.
+        uint32_t reserved; ///< Padding, always 0.
+        int64_t sequence; ///< Sequence of the request.
+    };
+
+    static constexpr uint32_t FILE_MAGIC = 0x4A524353; ///< "SCRJ" in little-endian byte order.
+    static constexpr uint32_t FILE_VERSION = 2; ///< Current layout version.
+    static constexpr uint32_t RECORD_MARKER = 0x52454352; ///< "RCER" in little-endian byte order.
+    static constexpr size_t RECORD_ALIGNMENT = 8; ///< Records start at multiples of this offset.
+
+    uint8_t *mapping; ///< Start of the mapped file.
+    size_t capacity; ///< Size of the mapped file.
+    FileHeader fileHeader; ///< Header of the file, as last written.
+    size_t regionBegin; ///< Offset of the region holding the records.
+    size_t regionEnd; ///< Offset past the region holding the records.
+    size_t tail; ///< Offset past the last record.
+    size_t syncedOffset; ///< Offset up to which the records have been handed to the OS for writing.
+    int unsyncedRecords; ///< Number of records appended since the last flush.
+    int64_t clientNonce; ///< Nonce of the client instance.
+    int32_t epoch; ///< Epoch of this run.
+    std::map<std::pair<int32_t, int64_t>, size_t> pending; ///< Offset of each incomplete request, by epoch and sequence.
+
+#ifdef _WIN32
+    void *fileHandle; ///< Handle of the journal file.
+    void *mappingHandle; ///< Handle of the file mapping.
+#else
+    int fd; ///< File descriptor of the journal file.
+#endif
+
+    /**
+     * @brief Maps the file at the given path, extending it to the journal capacity.
+     * @param path The path of the journal file.
+     */
+    void map(const std::string &path);
+
+    /**
+     * @brief Unmaps and closes the file.
+     */
+    void unmap();
+
+    /**
+     * @brief Reads the records, rebuilding the set of pending requests and finding the tail.
+     */
+    void scan();
+
+    /**
+     * @brief Writes a record at the tail, compacting the journal first if it does not fit.
+     * @param header The header of the record. Its marker is set by this method.
+     * @param data The serialized request, or nullptr for a completion.
+     * @return The offset of the record.
+     * @throws std::runtime_error if the record does not fit even after compacting.
+     */
+    size_t writeRecord(RecordHeader header, const uint8_t *data);
+
+    /**
+     * @brief Copies the pending requests to the other region and switches to it, dropping every other record.
+     */
+    void compact();
+
+    /**
+     * @brief Selects the region of the generation in the file header.
+     */
+    void selectRegion();
+
+    /**
+     * @brief Writes the file header through to disk.
+     */
+    void writeFileHeader();
+
+    /**
+     * @brief Hands the given range of the mapping to the OS for writing.
+     * @param begin The offset of the first byte.
+     * @param end The offset past the last byte.
+     * @param wait Whether to wait for the write to finish.
+     */
+    void flush(size_t begin, size_t end, bool wait);
+
+    /**
+     * @brief Gets the size a record occupies in the journal.
+     * @param length The number of bytes of serialized request.
+     * @return The size including the header and the alignment padding.
+     */
+    static size_t recordSize(size_t length);
+};
+
+#endif // REQUEST_JOURNAL_HPP
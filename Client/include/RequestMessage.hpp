@@ -1,8 +1,10 @@
 #ifndef REQUEST_MESSAGE_HPP
 #define REQUEST_MESSAGE_HPP
 
+#include <cstdint>
 #include <string>
 
+#include "RequestIdentity.hpp"
 #include "Serializer.hpp"
 
 /**
@@ -12,6 +14,9 @@
  * The RequestMessage class encapsulates the details of a request sent to the server,
  * including the request type, request ID, and associated data. It supports serialization
  * and deserialization for communication with the server.
+ * 
+ * The request ID matches replies to requests on one socket, while the identity (client nonce, epoch and
+ * sequence) lets the server detect duplicate requests regardless of the client's address and port.
  */
 class RequestMessage : public JavaSerializable
 {
@@ -19,6 +24,10 @@ private:
     int requestType; ///< Type of request (e.g., READ, WRITE, etc.).
     int requestID; ///< Unique identifier for the request.
     std::string data; ///<  Associated data for the request.
+    int64_t clientNonce; ///< Random identifier of the client instance, or 0 if the request has no identity.
+    int32_t epoch; ///< Run of the client instance that sent the request.
+    int64_t sequence; ///< Number of the request within the epoch.
+    int64_t ackedSequence; ///< Sequence up to which the client has received or given up every reply of the epoch.
 
 public:
     /**
@@ -91,6 +100,18 @@ public:
      */
     std::string getData() const;
 
+    /**
+     * @brief Gets the globally unique identity of the request.
+     * @return The identity, with a client nonce of 0 if the request has none.
+     */
+    RequestIdentity getIdentity() const;
+
+    /**
+     * @brief Gets the cumulative acknowledgement carried by the request.
+     * @return The sequence up to which the client has received or given up every reply, or 0 if there is none.
+     */
+    int64_t getAckedSequence() const;
+
     /**
      * @brief Sets the request type.
      * @param type The request type as an integer.
@@ -108,6 +129,18 @@ public:
      * @param data The associated data as a string.
      */
     void setData(const std::string &data);
+
+    /**
+     * @brief Sets the globally unique identity of the request.
+     * @param identity The identity.
+     */
+    void setIdentity(const RequestIdentity &identity);
+
+    /**
+     * @brief Sets the cumulative acknowledgement carried by the request.
+     * @param sequence The sequence up to which the client has received or given up every reply.
+     */
+    void setAckedSequence(int64_t sequence);
 };
 
 #endif // REQUEST_MESSAGE_HPP
@@ -1,103 +1,287 @@
 #ifndef RESPONSE_PARSER_HPP
 #define RESPONSE_PARSER_HPP
 
-#include <sstream>
+#include <array>
+#include <cstdint>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
+#include "Constants.hpp"
+#include "ResponseTokenizer.hpp"
+#include "WeekTime.hpp"
+
 /**
  * @class ResponseParser
  * @brief Provides methods to parse server responses into structured data.
- * 
+ *
  * The ResponseParser class contains static methods to parse various types of server
  * responses, such as facility names, availabilities, booking details, and ratings.
- * It converts raw server responses into a vector of strings for easier processing and
- * display.
+ * Each method fills a typed result directly from the raw response, so programs can
+ * use the fields without parsing text again; UserInterface formats results for display.
+ * Responses are split by ResponseTokenizer into views of the raw response, so the only
+ * strings allocated are the fields of the result.
  */
 class ResponseParser
 {
 public:
+    /**
+     * @struct Error
+     * @brief The error reported by the server, if any. Every result carries one.
+     *
+     * The code is mapped from the message once, when the response is parsed, so that callers can decide what to do
+     * about an error without comparing messages. Only errors that a later attempt may not hit are retryable; the
+     * others are answers of the server to the request itself, which a resend would only repeat.
+     */
+    struct Error
+    {
+        /**
+         * @enum Code
+         * @brief Kinds of errors.
+         */
+        enum Code
+        {
+            NONE = 0, ///< The server reported success.
+            SERVER_ERROR = 1, ///< The server reported an error not listed below, described by message.
+            TIMEOUT = 2, ///< The client got no reply within its retries; the request may or may not have been applied.
+            SLOT_UNAVAILABLE = 3, ///< The requested period overlaps a booking or a closed period.
+            FACILITY_NOT_FOUND = 4, ///< The facility does not exist.
+            BOOKING_NOT_FOUND = 5, ///< The booking does not exist or was made by another user.
+            INVALID_REQUEST = 6, ///< The server could not parse or does not support the request.
+            ALREADY_ACKNOWLEDGED = 7 ///< A copy of a request arrived after the client acknowledged it; it was not run again.
+        };
+
+        Code code = NONE; ///< Kind of the error.
+        std::string message; ///< Message of the server, empty without an error.
+
+        /**
+         * @brief Checks whether there is an error.
+         * @return True if the server reported an error.
+         */
+        bool failed() const { return code != NONE; }
+
+        /**
+         * @brief Checks whether sending the request again may succeed.
+         * @return True for timeouts, false for success and for errors the server would repeat.
+         */
+        bool retryable() const { return code == TIMEOUT; }
+    };
+
+    /**
+     * @struct FacilityList
+     * @brief The names of all facilities.
+     */
+    struct FacilityList
+    {
+        Error error; ///< Error reported by the server.
+        std::vector<std::string> names; ///< Facility names in the order of the server.
+    };
+
+    /**
+     * @struct Timeslot
+     * @brief A free period of a facility.
+     */
+    struct Timeslot
+    {
+        MinuteOfDay start; ///< Start time.
+        MinuteOfDay end; ///< End time, exclusive.
+    };
+
+    /**
+     * @struct Availability
+     * @brief The free periods of a facility in a week, also sent as monitoring updates.
+     *
+     * Only the days of the mask given to the parser are kept, and their timeslots stay undecoded text until
+     * timeslots() is called, so that callers pay only for the days they use.
+     */
+    struct Availability
+    {
+        Error error; ///< Error reported by the server.
+        std::string facility; ///< Facility name.
+        uint8_t requestedDays = Constants::ALL_DAYS_MASK; ///< Mask of the days parsed; lines of other days were skipped.
+        uint8_t listedDays = 0; ///< Mask of the requested days the server listed; unlisted days are closed.
+
+        /**
+         * @brief Checks whether the server listed a day, i.e. whether the facility is open on it.
+         * @param day The day.
+         * @return True if the day was requested and listed.
+         */
+        bool isListed(DayOfWeek day) const { return listedDays & Days::bit(day); }
+
+        /**
+         * @brief Decodes the free periods of a day.
+         * @param day The day.
+         * @return The free periods in the order of the server, or none if the day was not listed.
+         */
+        std::vector<Timeslot> timeslots(DayOfWeek day) const;
+
+    private:
+        friend class ResponseParser;
+
+        std::string timeslotText; ///< Timeslot lists of the listed days, one after another.
+        std::array<std::pair<uint32_t, uint32_t>, Constants::DAYS_PER_WEEK> dayText{}; ///< Offset and length of each day's list in timeslotText.
+    };
+
+    /**
+     * @struct Booking
+     * @brief A booking, as returned when it is made, queried, updated or deleted.
+     *
+     * Fields the server does not send for an operation are empty. Only updates carry oldBookingID, and
+     * deletions carry only bookingID and user. The day and times are decoded as they are read, so that
+     * bookings can be shifted and checked without parsing text again; ones that are not valid are left empty.
+     */
+    struct Booking
+    {
+        Error error; ///< Error reported by the server.
+        std::string bookingID; ///< ID of the booking; the new ID after an update.
+        std::string oldBookingID; ///< ID of the booking before an update.
+        std::string user; ///< Address of the user who made the booking.
+        std::string facility; ///< Facility name.
+        std::optional<DayOfWeek> day; ///< Day of the week.
+        std::optional<MinuteOfDay> start; ///< Start time.
+        std::optional<MinuteOfDay> end; ///< End time.
+    };
+
+    /**
+     * @struct MonitorRegistration
+     * @brief The confirmation of a registration for availability updates.
+     */
+    struct MonitorRegistration
+    {
+        Error error; ///< Error reported by the server.
+        std::string facility; ///< Facility name.
+        int intervalSeconds = 0; ///< Duration of the registration in seconds.
+    };
+
+    /**
+     * @struct Rating
+     * @brief The rating of a facility, as returned when it is queried or a rating is added.
+     */
+    struct Rating
+    {
+        Error error; ///< Error reported by the server.
+        std::string user; ///< Address of the user who added a rating; empty for queries.
+        std::string facility; ///< Facility name.
+        float rating = 0; ///< Rating, given by the server to one decimal.
+    };
+
+    /**
+     * @brief Parses only the status of a response, for callers that need nothing else of it.
+     * @param response The raw server response.
+     * @return The error, or no error if the response reports success.
+     */
+    static Error parseStatus(std::string_view response);
+
+    /**
+     * @brief Maps the message of an error to its code.
+     * @param message The message of the server or of the client.
+     * @return The code, or SERVER_ERROR for messages that are not known.
+     */
+    static Error::Code classifyError(std::string_view message);
+
     /**
      * @brief Parses the response for querying facility names.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed facility names or an error message.
+     * @return The facility names or the error.
      */
-    static std::vector<std::string> parseQueryFacilityNamesResponse(const std::string &response);
+    static FacilityList parseQueryFacilityNamesResponse(std::string_view response);
 
     /**
      * @brief Parses the response for querying facility availability.
      * @param response The raw server response.
-     * @param daysRequested A comma-separated list of days to filter availability (optional).
-     * @return A vector of strings containing the parsed availability information or an error message.
+     * @param dayMask The days to parse, with the bit of each day set.
+     * @return The availability of the listed days of the mask or the error.
      */
-    static std::vector<std::string> parseQueryAvailabilityResponse(
-        const std::string &response,
-        const std::string &daysRequested = ""
-    );
+    static Availability parseQueryAvailabilityResponse(std::string_view response, uint8_t dayMask = Constants::ALL_DAYS_MASK);
 
     /**
      * @brief Parses the response for booking a facility.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed booking details or an error message.
+     * @return The booking or the error.
      */
-    static std::vector<std::string> parseBookFacilityResponse(const std::string &response);
+    static Booking parseBookFacilityResponse(std::string_view response);
 
     /**
      * @brief Parses the response for querying booking details.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed booking details or an error message.
+     * @return The booking or the error.
      */
-    static std::vector<std::string> parseQueryBookingResponse(const std::string &response);
+    static Booking parseQueryBookingResponse(std::string_view response);
 
     /**
      * @brief Parses the response for updating a booking.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed updated booking details or an error message.
+     * @return The updated booking or the error.
      */
-    static std::vector<std::string> parseUpdateBookingResponse(const std::string &response);
+    static Booking parseUpdateBookingResponse(std::string_view response);
 
     /**
      * @brief Parses the response for deleting a booking.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed deletion confirmation or an error message.
+     * @return The ID and user of the deleted booking or the error.
      */
-    static std::vector<std::string> parseDeleteBookingResponse(const std::string &response);
+    static Booking parseDeleteBookingResponse(std::string_view response);
 
     /**
      * @brief Parses the response for monitoring facility availability.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed monitoring registration details or an error message.
+     * @return The registration or the error.
      */
-    static std::vector<std::string> parseMonitorAvailabilityResponse(const std::string &response);
+    static MonitorRegistration parseMonitorAvailabilityResponse(std::string_view response);
 
     /**
      * @brief Parses the response for adding a rating to a facility.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed rating confirmation or an error message.
+     * @return The rating added or the error.
      */
-    static std::vector<std::string> parseRateFacilityResponse(const std::string &response);
+    static Rating parseRateFacilityResponse(std::string_view response);
 
     /**
      * @brief Parses the response for querying a rating of a facility.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed rating details or an error message.
+     * @return The rating or the error.
      */
-    static std::vector<std::string> parseQueryRatingResponse(const std::string &response);
+    static Rating parseQueryRatingResponse(std::string_view response);
 
     /**
      * @brief Parses the response for echoing a message.
      * @param response The raw server response.
-     * @return A vector of strings containing the parsed echoed message or an error message.
+     * @return The echoed message.
      */
-    static std::vector<std::string> parseEchoMessageResponse(const std::string &response);
+    static std::string parseEchoMessageResponse(std::string_view response);
 
 private:
     /**
-     * @brief Checks if the response indicates an error.
-     * @param responseStream The input stream containing the server response.
+     * @brief Checks if the response indicates an error and parses it if so.
+     * @param lines The tokenizer over the lines of the response, advanced past the status line and, for errors, the message.
+     * @param error Set to the error if the response indicates one.
      * @return True if the response indicates an error, false otherwise.
      */
-    static bool isErrorResponse(std::istringstream &responseStream);
+    static bool parseError(ResponseTokenizer &lines, Error &error);
+
+    /**
+     * @brief Parses any booking reply in a single pass.
+     * @param response The raw server response.
+     * @return The fields of the booking the response carries, or the error.
+     */
+    static Booking parseBooking(std::string_view response);
+
+    /**
+     * @brief Parses a timeslot of the form "HHMM - HHMM".
+     * @param text The timeslot.
+     * @param timeslot Set to the timeslot if it is valid.
+     * @return True if the timeslot has a valid start and end.
+     */
+    static bool parseTimeslot(std::string_view text, Timeslot &timeslot);
+
+    /**
+     * @brief Removes spaces from both ends of a field.
+     * @param field The field.
+     * @return The field without surrounding spaces.
+     */
+    static std::string_view trim(std::string_view field);
 };
 
 #endif // RESPONSE_PARSER_HPP
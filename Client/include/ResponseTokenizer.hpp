@@ -0,0 +1,46 @@
+#ifndef RESPONSE_TOKENIZER_HPP
+#define RESPONSE_TOKENIZER_HPP
+
+#include <cstddef>
+#include <string_view>
+
+/**
+ * @class ResponseTokenizer
+ * @brief Splits a server response into lines or fields without copying it.
+ *
+ * Each token is a view into the text given to the constructor, so the text must outlive the tokens. Splitting
+ * follows std::getline(): a delimiter at the very end does not produce an empty last token, but two adjacent
+ * delimiters produce an empty token between them.
+ */
+class ResponseTokenizer
+{
+public:
+    /**
+     * @brief Constructs a tokenizer over a text.
+     * @param text The text to split.
+     * @param delimiter The character between tokens.
+     */
+    explicit ResponseTokenizer(std::string_view text, char delimiter = '\n');
+
+    /**
+     * @brief Gets the next token.
+     * @param token Set to the next token if there is one.
+     * @return True if there was a token, false if the text is exhausted.
+     */
+    bool next(std::string_view &token);
+
+    /**
+     * @brief Removes a key from the start of a field if the field starts with it.
+     * @param field The field, set to the part after the key if it matches.
+     * @param key The key, including its trailing ':'.
+     * @return True if the field started with the key.
+     */
+    static bool stripKey(std::string_view &field, std::string_view key);
+
+private:
+    std::string_view text; ///< Text being split.
+    size_t position; ///< Offset of the next token in text.
+    char delimiter; ///< Character between tokens.
+};
+
+#endif // RESPONSE_TOKENIZER_HPP
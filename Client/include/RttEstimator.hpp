@@ -0,0 +1,48 @@
+#ifndef RTT_ESTIMATOR_HPP
+#define RTT_ESTIMATOR_HPP
+
+#include <chrono>
+
+/**
+ * @class RttEstimator
+ * @brief Estimates the round-trip time to the server and derives a retransmission timeout from it.
+ *
+ * The estimator keeps a smoothed RTT and its mean deviation (Jacobson/Karels), and computes the
+ * retransmission timeout as SRTT + 4 * RTTVAR, clamped to [MIN_RTO_MS, MAX_RTO_MS]. Only samples of
+ * requests that were answered without a retransmission should be added (Karn's algorithm).
+ */
+class RttEstimator
+{
+public:
+    /**
+     * @brief Constructs an estimator with no samples.
+     * @param initialTimeout The retransmission timeout to use until the first sample is added.
+     */
+    explicit RttEstimator(std::chrono::milliseconds initialTimeout);
+
+    /**
+     * @brief Updates the estimate with a measured round trip.
+     * @param rtt The time between sending a request and receiving its reply.
+     */
+    void addSample(std::chrono::microseconds rtt);
+
+    /**
+     * @brief Gets the current retransmission timeout.
+     * @return The retransmission timeout.
+     */
+    std::chrono::milliseconds getTimeout() const;
+
+    /**
+     * @brief Gets the smoothed round-trip time.
+     * @return The smoothed round-trip time, or zero if no sample has been added.
+     */
+    std::chrono::microseconds getSmoothedRtt() const;
+
+private:
+    double smoothedRttMicros; ///< Smoothed round-trip time in microseconds.
+    double rttVarianceMicros; ///< Mean deviation of the round-trip time in microseconds.
+    double timeoutMicros; ///< Current retransmission timeout in microseconds.
+    bool hasSample; ///< Whether any sample has been added.
+};
+
+#endif // RTT_ESTIMATOR_HPP
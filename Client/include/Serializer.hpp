@@ -64,8 +64,8 @@ public:
 class JavaSerializer
 {
 private:
-    static std::map<const void *, int> serializedObjects; ///< Track serialized objects to handle circular references.
-    static int objectCounter; ///< Counter for assigning unique IDs to serialized objects.
+    static thread_local std::map<const void *, int> serializedObjects; ///< Track serialized objects to handle circular references, per thread.
+    static thread_local int objectCounter; ///< Counter for assigning unique IDs to serialized objects, per thread.
 
 public:
     /**
@@ -75,11 +75,11 @@ public:
      */
     static std::vector<uint8_t> serialize(const JavaSerializable *obj);
 
-private:
     /**
      * @brief Serializes the object and writes it into a byte buffer.
      * @param obj The object to serialize.
      * @param buffer The byte buffer to write the serialized data into.
+     * @note Only call this from serializeFieldValues() to write a nested object, as part of a serialize() call.
      */
     static void serializeObject(const JavaSerializable *obj, ByteBuffer &buffer);
 };
@@ -113,6 +113,11 @@ public:
      */
     static std::shared_ptr<JavaSerializable> createObject(const std::string &className);
 
+    /**
+     * @brief Registers the message classes the server sends, which every program must do before receiving.
+     */
+    static void registerMessageClasses();
+
     /**
      * @brief A map of class names to factory functions for creating objects.
      */
@@ -128,8 +133,8 @@ public:
 class JavaDeserializer
 {
 private:
-    static std::map<int, std::shared_ptr<JavaSerializable>> deserializedObjects; ///< Track deserialized objects to handle circular references.
-    static int objectCounter; ///< Counter for assigning unique IDs to deserialized objects.
+    static thread_local std::map<int, std::shared_ptr<JavaSerializable>> deserializedObjects; ///< Track deserialized objects to handle circular references, per thread.
+    static thread_local int objectCounter; ///< Counter for assigning unique IDs to deserialized objects, per thread.
 
 public:
     /**
@@ -140,11 +145,11 @@ public:
      */
     static std::shared_ptr<JavaSerializable> deserialize(const std::vector<uint8_t> &data);
 
-private:
     /**
      * @brief Deserializes an object from a byte reader.
      * @param reader The byte reader to read the serialized data from.
      * @return A shared pointer to the deserialized object.
+     * @note Only call this from deserializeFields() to read a nested object, as part of a deserialize() call.
      */
     static std::shared_ptr<JavaSerializable> deserializeObject(ByteReader &reader);
 };
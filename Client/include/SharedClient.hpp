@@ -0,0 +1,236 @@
+#ifndef SHARED_CLIENT_HPP
+#define SHARED_CLIENT_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "RequestIdentity.hpp"
+#include "RequestMessage.hpp"
+#include "ResponseParser.hpp"
+#include "RttEstimator.hpp"
+#include "Socket.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @class SharedClient
+ * @brief A client whose operations can be called from any number of threads over a single socket.
+ *
+ * Request IDs are allocated atomically, and each request in flight owns a slot of a fixed table indexed by
+ * its request ID. A single receive thread reads the socket, writes each reply into the slot of its request
+ * and wakes the calling thread; the hand-off is a lock-free state change of the slot. The same receive thread
+ * expires the slots whose retransmission timeout has passed, so calling threads only block on their own slot.
+ * All callers share one RttEstimator, which sets the retransmission timeout.
+ *
+ * @note The SharedClient must not be destroyed while any of its operations is running.
+ * @note Requests are not journaled; use a Client with a journal for requests that must survive a crash.
+ */
+class SharedClient
+{
+public:
+    /**
+     * @brief Constructs a SharedClient and starts its receive thread.
+     * @param serverIp The IP address or hostname of the server.
+     * @param serverPort The port number of the server.
+     * @throws std::runtime_error if the socket cannot be set up or the server address cannot be resolved.
+     */
+    SharedClient(const std::string &serverIp, int serverPort);
+
+    /**
+     * @brief Stops the receive thread and closes the socket.
+     */
+    ~SharedClient();
+
+    SharedClient(const SharedClient &) = delete;
+    SharedClient &operator=(const SharedClient &) = delete;
+
+    /**
+     * @brief Queries the names of all available facilities.
+     * @return A string containing the list of facility names or an error message.
+     */
+    std::string queryFacilityNames();
+
+    /**
+     * @brief Queries the availability of a facility for specific days.
+     * @param facilityName The name of the facility to query availability for.
+     * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+     * @return A string containing the availability information or an error message.
+     */
+    std::string queryAvailability(const std::string &facilityName, uint8_t dayMask);
+
+    /**
+     * @brief Books a facility for a specific day and time range.
+     * @param facilityName The name of the facility.
+     * @param dayOfWeek The day of the week.
+     * @param startTime The start time.
+     * @param endTime The end time.
+     * @return A string containing the booking confirmation or an error message.
+     */
+    std::string bookFacility(
+        const std::string &facilityName,
+        DayOfWeek dayOfWeek,
+        MinuteOfDay startTime,
+        MinuteOfDay endTime
+    );
+
+    /**
+     * @brief Queries the details of an existing booking.
+     * @param bookingID The ID of the booking to query.
+     * @return A string containing the booking details or an error message.
+     */
+    std::string queryBooking(const std::string &bookingID);
+
+    /**
+     * @brief Updates an existing booking by applying a time offset.
+     * @param oldBooking The booking to update, as parsed from its details.
+     * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+     * @return A string containing the updated booking details or an error message.
+     */
+    std::string updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes);
+
+    /**
+     * @brief Deletes an existing booking.
+     * @param booking The booking to delete, as parsed from its details.
+     * @return A string containing the deletion confirmation or an error message.
+     */
+    std::string deleteBooking(const ResponseParser::Booking &booking);
+
+    /**
+     * @brief Registers interest in a facility. Updates are passed to the push handler.
+     * @param facilityName The name of the facility to monitor.
+     * @param durationSeconds The duration of the registration in seconds.
+     * @return A string containing the registration confirmation or an error message.
+     */
+    std::string registerMonitor(const std::string &facilityName, int durationSeconds);
+
+    /**
+     * @brief Sets the callback for monitoring updates, which runs on the receive thread.
+     * @param handler The callback, or an empty function to discard updates.
+     */
+    void setPushHandler(const std::function<void(const RequestMessage &)> &handler);
+
+    /**
+     * @brief Rates a facility.
+     * @param facilityName The name of the facility to rate.
+     * @param rating The rating value (e.g., 4.5).
+     * @return A string containing the rating confirmation or an error message.
+     */
+    std::string rateFacility(const std::string &facilityName, float rating);
+
+    /**
+     * @brief Queries the rating of a facility.
+     * @param facilityName The name of the facility to query.
+     * @return A string containing the rating information or an error message.
+     */
+    std::string queryRating(const std::string &facilityName);
+
+    /**
+     * @brief Sends an echo message to the server.
+     * @param messageData The message data to send.
+     * @return A string containing the echoed message or an error message.
+     */
+    std::string echoMessage(const std::string &messageData);
+
+    /**
+     * @brief Gets the retransmission timeout derived from the round trips of all callers.
+     * @return The retransmission timeout.
+     */
+    std::chrono::milliseconds getTimeout();
+
+private:
+    /**
+     * @brief State of a slot, stored in the low bits of its word.
+     */
+    enum SlotState : uint64_t
+    {
+        FREE = 0, ///< Not owned by any request.
+        IDLE = 1, ///< Owned by a request that is not waiting for a reply, e.g. after a timeout.
+        WAITING = 2, ///< Owned by a request waiting for its reply until the slot's deadline.
+        READY = 3 ///< Holds the reply of the owning request.
+    };
+
+    /**
+     * @struct Slot
+     * @brief Hand-off point between a calling thread and the receive thread for one request in flight.
+     *
+     * The word holds the owning request ID in its high 32 bits and the SlotState in its low bits, so a
+     * late reply can never be written into a slot that has since been taken by another request.
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t> word{FREE}; ///< Owning request ID and state.
+        std::atomic<int64_t> deadline{0}; ///< Steady-clock time in nanoseconds at which a WAITING slot expires.
+        std::string response; ///< Reply data, valid once the state is READY.
+    };
+
+    Socket socket; ///< Socket shared by all calling threads.
+    struct sockaddr_in serverAddr; ///< Address of the server.
+    std::atomic<int> requestID; ///< Next request ID to allocate. ID 0 is reserved for server-initiated messages.
+    RequestIdentitySource identitySource; ///< Globally unique identities of the requests, shared by all calling threads.
+    std::unique_ptr<Slot[]> slots; ///< Slots of the requests in flight, indexed by request ID modulo the table size.
+    std::atomic<int> freeSlots; ///< Number of slots not reserved by a calling thread; callers wait on it when it is 0.
+    std::mutex rttMutex; ///< Guards rttEstimator.
+    RttEstimator rttEstimator; ///< Round-trip estimate shared by all calling threads.
+    std::mutex pushHandlerMutex; ///< Guards pushHandler.
+    std::function<void(const RequestMessage &)> pushHandler; ///< Receives monitoring updates.
+    std::atomic<bool> running; ///< Whether the receive thread should keep running.
+    std::thread receiveThread; ///< Thread reading the socket and completing slots.
+
+    /**
+     * @brief Builds the word of a slot.
+     * @param requestID The owning request ID.
+     * @param state The state of the slot.
+     * @return The slot word.
+     */
+    static uint64_t makeWord(int requestID, SlotState state);
+
+    /**
+     * @brief Gets the current steady-clock time, the time base of slot deadlines.
+     * @return The current time in nanoseconds.
+     */
+    static int64_t steadyNanos();
+
+    /**
+     * @brief Allocates a request ID whose slot is free and takes the slot, waiting while every slot is taken.
+     * @return The request ID.
+     */
+    int claimSlot();
+
+    /**
+     * @brief Frees the slot of a request and wakes a thread waiting for one.
+     * @param slot The slot.
+     * @param id The request ID owning the slot.
+     */
+    void releaseSlot(Slot &slot, int id);
+
+    /**
+     * @brief Sends a request and waits for its reply, retransmitting on timeout.
+     * @param request The request to send. Its request ID and identity are assigned here.
+     * @return The reply data or an error message.
+     */
+    std::string sendWithRetry(RequestMessage request);
+
+    /**
+     * @brief Reads the socket and completes slots until the client is destroyed.
+     */
+    void receiveLoop();
+
+    /**
+     * @brief Hands a received message to the waiting caller or the push handler.
+     * @param message The received message.
+     */
+    void dispatch(const std::shared_ptr<RequestMessage> &message);
+
+    /**
+     * @brief Wakes the callers whose deadline has passed.
+     * @param nowNanos The current steady-clock time in nanoseconds.
+     */
+    void expireSlots(int64_t nowNanos);
+};
+
+#endif // SHARED_CLIENT_HPP
@@ -0,0 +1,105 @@
+#ifndef SLOT_FINDER_HPP
+#define SLOT_FINDER_HPP
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "AvailabilityCalendar.hpp"
+#include "Client.hpp"
+#include "Constants.hpp"
+#include "WeekTime.hpp"
+
+/**
+ * @class SlotFinder
+ * @brief Finds, and optionally books, the earliest free slots of a given length across facilities.
+ *
+ * A search queries the facility names, sends the availability queries of all matching facilities at once
+ * with Client::submitPipelined(), and indexes each reply as an AvailabilityCalendar. Candidate slots are the
+ * free windows of the requested length within the day range and time window, ranked by day, then start time,
+ * then facility. The server has no multi-slot booking, so bookBest() books candidates one at a time in rank
+ * order and moves on to the next one when the server reports a conflict.
+ */
+class SlotFinder
+{
+public:
+    /**
+     * @struct Query
+     * @brief What to search for.
+     */
+    struct Query
+    {
+        int durationMinutes = 60; ///< Length of the slot.
+        DayOfWeek firstDay = DayOfWeek::MONDAY; ///< First day of the range.
+        DayOfWeek lastDay = DayOfWeek::SUNDAY; ///< Last day of the range, inclusive.
+        MinuteOfDay windowStart; ///< Earliest start of a slot on each day.
+        MinuteOfDay windowEnd = MinuteOfDay::endOfDay(); ///< Latest end of a slot on each day.
+        std::function<bool(const std::string &)> facilityFilter; ///< Selects the facilities to search, or empty for all.
+        int maxCandidates = Constants::SLOT_SEARCH_MAX_CANDIDATES; ///< Maximum number of candidates returned.
+    };
+
+    /**
+     * @struct Candidate
+     * @brief A free slot of a facility.
+     */
+    struct Candidate
+    {
+        std::string facility; ///< Facility name.
+        DayOfWeek day = DayOfWeek::MONDAY; ///< Day of the slot.
+        MinuteOfDay start; ///< Start time of the slot.
+        MinuteOfDay end; ///< End time of the slot.
+    };
+
+    /**
+     * @struct BookingResult
+     * @brief The outcome of booking the best candidate.
+     */
+    struct BookingResult
+    {
+        bool booked = false; ///< Whether a candidate was booked.
+        Candidate candidate; ///< The candidate booked, or the last one tried.
+        std::string response; ///< The reply to the last booking sent, or empty if there was no candidate.
+        int attempts = 0; ///< Number of candidates tried.
+    };
+
+    /**
+     * @brief Constructs a SlotFinder that uses the given client for its queries and bookings.
+     * @param client Reference to the Client object for server communication.
+     */
+    SlotFinder(Client &client);
+
+    /**
+     * @brief Finds the earliest free slots matching a query.
+     * @param query The query.
+     * @return The candidates, best first, or none if the query is invalid or nothing is free.
+     */
+    std::vector<Candidate> findSlots(const Query &query);
+
+    /**
+     * @brief Books the best candidate of a query, falling back to the next one when a slot was taken.
+     * @param query The query.
+     * @return The outcome of the bookings.
+     */
+    BookingResult bookBest(const Query &query);
+
+    /**
+     * @brief Ranks the free slots of indexed facilities.
+     * @param facilities The facility names.
+     * @param calendars The calendar of each facility.
+     * @param query The query.
+     * @return The candidates, best first.
+     */
+    static std::vector<Candidate> rankCandidates(const std::vector<std::string> &facilities, const std::vector<AvailabilityCalendar> &calendars, const Query &query);
+
+private:
+    Client &client; ///< Reference to the Client object for server communication.
+
+    /**
+     * @brief Checks that a query describes a non-empty search.
+     * @param query The query.
+     * @return True if the day range and time window are valid and can hold a slot of the duration.
+     */
+    static bool isValidQuery(const Query &query);
+};
+
+#endif // SLOT_FINDER_HPP
@@ -9,6 +9,7 @@
     #include <arpa/inet.h>
     #include <netdb.h>
     #include <netinet/in.h>
+    #include <poll.h>
     #include <sys/socket.h>
     #include <unistd.h>
 #endif
@@ -55,6 +56,13 @@ public:
      */
     void bind(const int port);
 
+    /**
+     * @brief Binds the socket to the specified local address.
+     * @param addr The local address and port to bind the socket to.
+     * @throws std::runtime_error if binding fails.
+     */
+    void bind(const struct sockaddr_in &addr);
+
     /**
      * @brief Sets the receive timeout for the socket.
      * @param seconds The timeout duration in seconds.
@@ -62,6 +70,13 @@ public:
      */
     void setReceiveTimeout(int seconds);
 
+    /**
+     * @brief Sets the receive timeout for the socket with millisecond precision.
+     * @param milliseconds The timeout duration in milliseconds (values below 1 are raised to 1).
+     * @throws std::runtime_error if setting the timeout fails.
+     */
+    void setReceiveTimeoutMillis(int milliseconds);
+
     /**
      * @brief Sends data to a specified address.
      * @param data The data to send.
@@ -79,6 +94,54 @@ public:
      */
     int receiveDataFrom(char *buffer, struct sockaddr_in &addr);
 
+    /**
+     * @brief Receives data from a specified address into a buffer of the given size.
+     * @param buffer The buffer to store the received data.
+     * @param bufferSize The size of the buffer in bytes.
+     * @param addr The source address.
+     * @return The number of bytes received.
+     * @throws std::runtime_error if receiving fails.
+     */
+    int receiveDataFrom(char *buffer, int bufferSize, struct sockaddr_in &addr);
+
+    /**
+     * @brief Waits until a datagram can be received without blocking.
+     * @param timeoutMillis The maximum time to wait in milliseconds, or a negative value to wait indefinitely.
+     * @return True if a datagram is ready, false if the timeout expired.
+     * @throws std::runtime_error if waiting fails.
+     */
+    bool waitReadable(int timeoutMillis);
+
+    /**
+     * @brief Marks a bound stream socket as accepting connections.
+     * @param backlog The maximum number of pending connections.
+     * @throws std::runtime_error if listening fails.
+     */
+    void listen(int backlog);
+
+    /**
+     * @brief Accepts a pending connection of a listening socket.
+     * @param connection The socket to hand the connection to. Any socket it held is closed.
+     * @throws std::runtime_error if accepting fails.
+     */
+    void acceptConnection(Socket &connection);
+
+    /**
+     * @brief Sends all bytes over a connected stream socket.
+     * @param data The bytes to send.
+     * @throws std::runtime_error if sending fails.
+     */
+    void sendAll(const std::string &data);
+
+    /**
+     * @brief Resolves a hostname or IPv4 address into a socket address.
+     * @param hostname The hostname or IP address.
+     * @param port The port number.
+     * @return The socket address.
+     * @throws std::runtime_error if the hostname cannot be resolved.
+     */
+    static struct sockaddr_in resolveAddress(const std::string &hostname, int port);
+
     /**
      * @brief Retrieves the local socket name (IP address and port).
      * @param addr The address structure to store the socket name.
@@ -0,0 +1,200 @@
+#ifndef TASK_HPP
+#define TASK_HPP
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+template <typename T>
+class Task;
+
+/**
+ * @class TaskPromiseBase
+ * @brief State shared by the promises of all Task types.
+ *
+ * A task starts suspended and runs when it is first awaited. When it finishes, control transfers
+ * directly to the awaiting coroutine (symmetric transfer), so long chains of tasks do not grow the stack.
+ */
+class TaskPromiseBase
+{
+public:
+    /**
+     * @brief Awaiter run when the task finishes, resuming the coroutine that awaited it.
+     */
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            std::coroutine_handle<> continuation = handle.promise().continuation;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+
+    void unhandled_exception() { exception = std::current_exception(); }
+
+    std::coroutine_handle<> continuation; ///< Coroutine to resume when the task finishes.
+    std::exception_ptr exception; ///< Exception that escaped the task, rethrown to the awaiting coroutine.
+};
+
+/**
+ * @class TaskPromise
+ * @brief Promise of a Task that produces a value.
+ * @tparam T The type of the value.
+ */
+template <typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object();
+
+    template <typename U>
+    void return_value(U &&result)
+    {
+        value.emplace(std::forward<U>(result));
+    }
+
+    /**
+     * @brief Gets the value of the finished task.
+     * @return The value returned by the task.
+     * @throws Any exception that escaped the task.
+     */
+    T takeResult()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+        return std::move(*value);
+    }
+
+private:
+    std::optional<T> value; ///< Value returned by the task.
+};
+
+/**
+ * @class TaskPromise<void>
+ * @brief Promise of a Task that produces no value.
+ */
+template <>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object();
+
+    void return_void() const noexcept {}
+
+    /**
+     * @brief Rethrows the exception that escaped the finished task, if any.
+     */
+    void takeResult()
+    {
+        if (exception)
+        {
+            std::rethrow_exception(exception);
+        }
+    }
+};
+
+/**
+ * @class Task
+ * @brief A lazily started coroutine that produces a value when awaited.
+ *
+ * A Task owns its coroutine frame and is move-only. It is started by co_await, which suspends the awaiting
+ * coroutine until the task finishes and then yields the task's value or rethrows its exception. Top-level
+ * tasks are started with EventLoop::spawn().
+ *
+ * @tparam T The type of the value, or void.
+ *
+ * @note Coroutines returning a Task should take their parameters by value, as the task may outlive the caller's arguments.
+ */
+template <typename T = void>
+class Task
+{
+public:
+    using promise_type = TaskPromise<T>;
+
+    /**
+     * @brief Constructs a task that owns the given coroutine.
+     * @param handle The coroutine handle.
+     */
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    Task(Task &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+            {
+                handle.destroy();
+            }
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    /**
+     * @brief Destroys the coroutine frame.
+     */
+    ~Task()
+    {
+        if (handle)
+        {
+            handle.destroy();
+        }
+    }
+
+    /**
+     * @brief Starts the task and suspends the awaiting coroutine until it finishes.
+     * @return An awaiter yielding the task's value.
+     */
+    auto operator co_await() const noexcept
+    {
+        struct Awaiter
+        {
+            std::coroutine_handle<promise_type> handle;
+
+            bool await_ready() const noexcept { return !handle || handle.done(); }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+            {
+                handle.promise().continuation = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().takeResult(); }
+        };
+
+        return Awaiter{handle};
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle; ///< The owned coroutine.
+};
+
+template <typename T>
+Task<T> TaskPromise<T>::get_return_object()
+{
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object()
+{
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+#endif // TASK_HPP
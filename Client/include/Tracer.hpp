@@ -0,0 +1,131 @@
+#ifndef TRACER_HPP
+#define TRACER_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @class Tracer
+ * @brief Records timed spans of the request lifecycle and writes them as a Chrome trace-event file.
+ *
+ * Each thread records into its own ring buffer of the last TRACE_RING_CAPACITY events, without locks or
+ * allocation once the ring exists. The file written by writeFile() can be opened in chrome://tracing or
+ * Perfetto, where the spans of a thread nest into a timeline of operations, attempts and their phases.
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock; ///< Clock of the recorded spans.
+
+    /**
+     * @class Span
+     * @brief Records a span from its construction to its destruction, if a tracer is given.
+     */
+    class Span
+    {
+    public:
+        /**
+         * @brief Starts a span.
+         * @param tracer The tracer to record into, or null to record nothing.
+         * @param name The name of the span. It must be a string literal or otherwise outlive the tracer.
+         * @param requestID The request ID the span belongs to, or -1 if none.
+         * @param requestType The request type the span belongs to, or -1 if unknown.
+         * @param attempt The attempt the span belongs to, or -1 if none.
+         */
+        Span(Tracer *tracer, const char *name, int64_t requestID = -1, int requestType = -1, int attempt = -1);
+
+        /**
+         * @brief Ends the span and records it.
+         */
+        ~Span();
+
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+        /**
+         * @brief Ends the span early and records it.
+         * @param requestType The request type, for spans started before the request existed, or -1 to keep it.
+         */
+        void end(int requestType = -1);
+
+    private:
+        Tracer *tracer; ///< Tracer to record into, or null.
+        const char *name; ///< Name of the span.
+        Clock::time_point start; ///< Start of the span.
+        int64_t requestID; ///< Request ID of the span, or -1.
+        int requestType; ///< Request type of the span, or -1.
+        int attempt; ///< Attempt of the span, or -1.
+    };
+
+    /**
+     * @brief Constructs an empty tracer.
+     */
+    Tracer();
+
+    Tracer(const Tracer &) = delete;
+    Tracer &operator=(const Tracer &) = delete;
+
+    /**
+     * @brief Records a span into the ring of the calling thread.
+     * @param name The name of the span. It must be a string literal or otherwise outlive the tracer.
+     * @param start The start of the span.
+     * @param end The end of the span.
+     * @param requestID The request ID the span belongs to, or -1 if none.
+     * @param requestType The request type the span belongs to, or -1 if unknown.
+     * @param attempt The attempt the span belongs to, or -1 if none.
+     */
+    void record(const char *name, Clock::time_point start, Clock::time_point end, int64_t requestID = -1, int requestType = -1, int attempt = -1);
+
+    /**
+     * @brief Writes the recorded spans of all threads as a Chrome trace-event JSON file.
+     * @param path The path of the file.
+     * @throws std::runtime_error if the file cannot be written.
+     */
+    void writeFile(const std::string &path) const;
+
+private:
+    /**
+     * @struct Event
+     * @brief A recorded span.
+     */
+    struct Event
+    {
+        const char *name; ///< Name of the span.
+        Clock::time_point start; ///< Start of the span.
+        Clock::time_point end; ///< End of the span.
+        int64_t requestID; ///< Request ID of the span, or -1.
+        int requestType; ///< Request type of the span, or -1.
+        int attempt; ///< Attempt of the span, or -1.
+    };
+
+    /**
+     * @struct Ring
+     * @brief The ring buffer of one thread.
+     */
+    struct Ring
+    {
+        int threadID; ///< Number of the thread within the tracer, shown as its trace thread ID.
+        std::vector<Event> events; ///< Events, indexed by their sequence number modulo the capacity.
+        std::atomic<uint64_t> head; ///< Number of events ever recorded, published after each event is written.
+    };
+
+    static std::atomic<uint64_t> nextTracerID; ///< ID of the next tracer, so that threads can tell tracers apart.
+
+    uint64_t tracerID; ///< ID of this tracer.
+    Clock::time_point origin; ///< Time of construction, the zero of the trace timestamps.
+    mutable std::mutex ringsMutex; ///< Guards rings, locked only when a thread records its first event or the file is written.
+    std::vector<std::unique_ptr<Ring>> rings; ///< Rings of all threads that recorded into this tracer.
+
+    /**
+     * @brief Gets the ring of the calling thread, creating it on its first event.
+     * @return The ring.
+     */
+    Ring &localRing();
+};
+
+#endif // TRACER_HPP
@@ -1,10 +1,14 @@
 #ifndef USER_INTERFACE_HPP
 #define USER_INTERFACE_HPP
 
+#include <functional>
 #include <memory>
+#include <optional>
 
 #include "Client.hpp"
+#include "ResponseParser.hpp"
 #include "Socket.hpp"
+#include "WeekTime.hpp"
 
 /**
  * @class UserInterface
@@ -101,21 +105,21 @@ private:
      * @param prompt The prompt message to display.
      * @return The day of the week entered by the user.
      */
-    static std::string promptDayOfWeek(const std::string prompt);
+    static DayOfWeek promptDayOfWeek(const std::string prompt);
 
     /**
      * @brief Prompts the user for multiple days of the week.
      * @param prompt The prompt message to display.
-     * @return The days of the week entered by the user.
+     * @return The mask of the days of the week entered by the user.
      */
-    static std::string promptDaysOfWeek(const std::string prompt);
+    static uint8_t promptDaysOfWeek(const std::string prompt);
 
     /**
      * @brief Prompts the user for a time in HHMM format.
      * @param prompt The prompt message to display.
-     * @return The time entered by the user in HHMM format.
+     * @return The time entered by the user, before 2400.
      */
-    static std::string promptTime(const std::string prompt);
+    static MinuteOfDay promptTime(const std::string prompt);
 
     /**
      * @brief Prompts the user for a booking ID.
@@ -153,18 +157,53 @@ private:
     static int promptDuration(const std::string prompt);
 
     /**
-     * @brief Generates a box with the specified content.
-     * @param content The content to display inside the box.
-     * @return The formatted box string.
+     * @brief Checks if the response from the server indicates an error.
+     * @param error The error of the parsed response.
+     * @return True if the response indicates an error, false otherwise.
      */
-    static std::string generateBox(const std::vector<std::string> &content);
+    static bool isErrorResponse(const ResponseParser::Error &error);
 
     /**
-     * @brief Checks if the response from the server indicates an error.
-     * @param parsedResponse The parsed response from the server.
-     * @return True if the response indicates an error, false otherwise.
+     * @brief Formats a day of a parsed response for display.
+     * @param day The day, or nothing if the response had none.
+     * @return The day name, or an empty string.
+     */
+    static std::string formatDay(const std::optional<DayOfWeek> &day);
+
+    /**
+     * @brief Formats a time of a parsed response for display.
+     * @param time The time, or nothing if the response had none.
+     * @return The time in HHMM format, or an empty string.
+     */
+    static std::string formatTime(const std::optional<MinuteOfDay> &time);
+
+    /**
+     * @brief Parses a response, recording the parse phase if the client collects statistics or traces.
+     * @param requestType The request type of the operation that received the response.
+     * @param parse The parser call.
+     * @return The parsed response.
      */
-    static bool isErrorResponse(const std::vector<std::string> &parsedResponse);
+    template <typename Parse>
+    auto timeParse(int requestType, const Parse &parse) -> decltype(parse())
+    {
+        if (!client.getStats() && !client.getTracer())
+        {
+            return parse();
+        }
+
+        ClientStats::Clock::time_point parseStart = ClientStats::Clock::now();
+        auto parsedResponse = parse();
+        recordParse(requestType, parseStart, ClientStats::Clock::now());
+        return parsedResponse;
+    }
+
+    /**
+     * @brief Records the parse phase of a response in the statistics and the trace of the client.
+     * @param requestType The request type of the operation that received the response.
+     * @param parseStart The start of the parse.
+     * @param parseEnd The end of the parse.
+     */
+    void recordParse(int requestType, ClientStats::Clock::time_point parseStart, ClientStats::Clock::time_point parseEnd);
 
 public:
     /**
@@ -198,6 +237,83 @@ public:
      * @return The server port number as an integer.
      */
     static int promptServerPort(const std::string prompt);
+
+    /**
+     * @brief Generates a box with the specified content.
+     * @param content The content to display inside the box.
+     * @return The formatted box string.
+     */
+    static std::string generateBox(const std::vector<std::string> &content);
+
+    /**
+     * @brief Formats an error for display.
+     * @param error The error.
+     * @return The lines of the box, headed "Error".
+     */
+    static std::vector<std::string> formatError(const ResponseParser::Error &error);
+
+    /**
+     * @brief Formats facility names for display.
+     * @param facilityList The parsed facility names.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatFacilityList(const ResponseParser::FacilityList &facilityList);
+
+    /**
+     * @brief Formats the availability of a facility for display.
+     * @param availability The parsed availability. If it was parsed for some days only, those are shown, including closed ones.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatAvailability(const ResponseParser::Availability &availability);
+
+    /**
+     * @brief Formats a booking for display.
+     * @param booking The parsed booking.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatBooking(const ResponseParser::Booking &booking);
+
+    /**
+     * @brief Formats an updated booking for display.
+     * @param booking The parsed updated booking.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatUpdatedBooking(const ResponseParser::Booking &booking);
+
+    /**
+     * @brief Formats a deleted booking for display.
+     * @param booking The parsed deleted booking.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatDeletedBooking(const ResponseParser::Booking &booking);
+
+    /**
+     * @brief Formats a monitoring registration for display.
+     * @param registration The parsed registration.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatMonitorRegistration(const ResponseParser::MonitorRegistration &registration);
+
+    /**
+     * @brief Formats the confirmation of a rating for display.
+     * @param rating The parsed rating added.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatRatingAdded(const ResponseParser::Rating &rating);
+
+    /**
+     * @brief Formats the rating of a facility for display.
+     * @param rating The parsed rating.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatRating(const ResponseParser::Rating &rating);
+
+    /**
+     * @brief Formats an echoed message for display.
+     * @param message The echoed message.
+     * @return The lines of the box.
+     */
+    static std::vector<std::string> formatEchoMessage(const std::string &message);
 };
 
 #endif // USER_INTERFACE_HPP
@@ -0,0 +1,306 @@
+#ifndef WEEK_TIME_HPP
+#define WEEK_TIME_HPP
+
+#include <array>
+#include <compare>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "Constants.hpp"
+
+/**
+ * @enum DayOfWeek
+ * @brief A day of the week, numbered from Monday as the server lists them.
+ *
+ * The value of a day is its index in Days::NAMES and its bit in day masks.
+ */
+enum class DayOfWeek : uint8_t
+{
+    MONDAY = 0,
+    TUESDAY = 1,
+    WEDNESDAY = 2,
+    THURSDAY = 3,
+    FRIDAY = 4,
+    SATURDAY = 5,
+    SUNDAY = 6
+};
+
+/**
+ * @class Days
+ * @brief Converts days of the week and day masks to and from the names the server uses.
+ *
+ * Names are looked up in constexpr tables. A day name is parsed by hashing its first two letters, which differ
+ * between all days, into a table of candidate days and comparing the name with the one candidate, so parsing
+ * takes one comparison whatever the day. Strings from outside are parsed once where they enter the client;
+ * everything past that point passes DayOfWeek values and masks.
+ */
+class Days
+{
+public:
+    /**
+     * @brief Names of the days, indexed by DayOfWeek.
+     */
+    static constexpr std::array<std::string_view, Constants::DAYS_PER_WEEK> NAMES = {
+        "MONDAY", "TUESDAY", "WEDNESDAY", "THURSDAY", "FRIDAY", "SATURDAY", "SUNDAY"
+    };
+
+    /**
+     * @brief Converts a day name to a day.
+     * @param name The day name, such as "MONDAY".
+     * @return The day, or nothing if the name is not that of a day.
+     */
+    static constexpr std::optional<DayOfWeek> parse(std::string_view name)
+    {
+        if (name.size() < 2)
+        {
+            return std::nullopt;
+        }
+
+        int candidate = HASH_TABLE[hash(name[0], name[1])];
+        if (candidate >= Constants::DAYS_PER_WEEK || name != NAMES[candidate])
+        {
+            return std::nullopt;
+        }
+        return static_cast<DayOfWeek>(candidate);
+    }
+
+    /**
+     * @brief Converts a day index to a day.
+     * @param index The index, from 0 for Monday to 6 for Sunday.
+     * @return The day, or nothing if the index is outside the week.
+     */
+    static constexpr std::optional<DayOfWeek> fromIndex(int index)
+    {
+        if (index < 0 || index >= Constants::DAYS_PER_WEEK)
+        {
+            return std::nullopt;
+        }
+        return static_cast<DayOfWeek>(index);
+    }
+
+    /**
+     * @brief Gets the index of a day.
+     * @param day The day.
+     * @return The index, from 0 for Monday to 6 for Sunday.
+     */
+    static constexpr int index(DayOfWeek day) { return static_cast<int>(day); }
+
+    /**
+     * @brief Gets the name of a day.
+     * @param day The day.
+     * @return The name, such as "MONDAY".
+     */
+    static constexpr std::string_view name(DayOfWeek day) { return NAMES[index(day)]; }
+
+    /**
+     * @brief Gets the bit of a day in day masks.
+     * @param day The day.
+     * @return The mask of the day alone.
+     */
+    static constexpr uint8_t bit(DayOfWeek day) { return static_cast<uint8_t>(1 << index(day)); }
+
+    /**
+     * @brief Converts a comma-separated list of day names to a day mask.
+     * @param names The days, such as "MONDAY,TUESDAY", or an empty string for every day as the server does.
+     * @return The mask. Unknown days are ignored.
+     */
+    static constexpr uint8_t parseMask(std::string_view names)
+    {
+        if (names.empty())
+        {
+            return Constants::ALL_DAYS_MASK;
+        }
+
+        uint8_t mask = 0;
+        while (true)
+        {
+            size_t commaPos = names.find(',');
+            if (std::optional<DayOfWeek> day = parse(names.substr(0, commaPos)))
+            {
+                mask |= bit(*day);
+            }
+            if (commaPos == std::string_view::npos)
+            {
+                return mask;
+            }
+            names.remove_prefix(commaPos + 1);
+        }
+    }
+
+    /**
+     * @brief Appends the names of the days of a mask as a comma-separated list, in week order.
+     * @param mask The day mask.
+     * @param out The string to append to.
+     */
+    static void appendMask(uint8_t mask, std::string &out)
+    {
+        bool first = true;
+        for (int day = 0; day < Constants::DAYS_PER_WEEK; ++day)
+        {
+            if (mask & (1 << day))
+            {
+                if (!first)
+                {
+                    out += ',';
+                }
+                out += NAMES[day];
+                first = false;
+            }
+        }
+    }
+
+private:
+    /**
+     * @brief Hashes the first two letters of a day name; the seven days hash to distinct values below 8.
+     * @param first The first letter.
+     * @param second The second letter.
+     * @return The hash, from 0 to 7.
+     */
+    static constexpr int hash(char first, char second)
+    {
+        return ((static_cast<unsigned char>(first) * 2 + static_cast<unsigned char>(second)) >> 1) & 7;
+    }
+
+    /**
+     * @brief Day of each hash value, or DAYS_PER_WEEK for the value no day has.
+     */
+    static const std::array<uint8_t, 8> HASH_TABLE;
+};
+
+inline constexpr std::array<uint8_t, 8> Days::HASH_TABLE = []()
+{
+    std::array<uint8_t, 8> table{};
+    table.fill(Constants::DAYS_PER_WEEK);
+    for (int day = 0; day < Constants::DAYS_PER_WEEK; ++day)
+    {
+        table[hash(NAMES[day][0], NAMES[day][1])] = static_cast<uint8_t>(day);
+    }
+    return table;
+}();
+
+/**
+ * @class MinuteOfDay
+ * @brief A time of day in minutes since midnight, from 0000 to 2400 inclusive.
+ *
+ * A MinuteOfDay is always valid: the only ways to make one from outside data are parse() and fromMinutes(),
+ * which reject anything outside the day, so that code receiving one has nothing left to check. 2400 is the end
+ * of the day, as timeslots end exclusive of their end. Parsing checks all four digits at once without
+ * branching on each, and formatting looks the digits up in a constexpr table of two-digit pairs.
+ */
+class MinuteOfDay
+{
+public:
+    /**
+     * @brief Constructs midnight, the start of the day.
+     */
+    constexpr MinuteOfDay() = default;
+
+    /**
+     * @brief Converts minutes since midnight to a time of day.
+     * @param minutes The minutes since midnight.
+     * @return The time, or nothing if it is outside 0 to MINUTES_PER_DAY.
+     */
+    static constexpr std::optional<MinuteOfDay> fromMinutes(int minutes)
+    {
+        if (minutes < 0 || minutes > Constants::MINUTES_PER_DAY)
+        {
+            return std::nullopt;
+        }
+        return MinuteOfDay(minutes);
+    }
+
+    /**
+     * @brief Converts a time in HHMM format to a time of day.
+     * @param time The time, such as "0930".
+     * @return The time, or nothing if it is not four digits of a time up to 2400.
+     */
+    static constexpr std::optional<MinuteOfDay> parse(std::string_view time)
+    {
+        if (time.size() != 4)
+        {
+            return std::nullopt;
+        }
+
+        unsigned values[4];
+        bool valid = true;
+        for (int i = 0; i < 4; ++i)
+        {
+            values[i] = static_cast<unsigned>(time[i] - '0');
+            valid &= values[i] < 10;
+        }
+
+        unsigned minutes = (values[0] * 10 + values[1]) * 60 + values[2] * 10 + values[3];
+        valid &= values[2] < 6;
+        valid &= minutes <= static_cast<unsigned>(Constants::MINUTES_PER_DAY);
+        if (!valid)
+        {
+            return std::nullopt;
+        }
+        return MinuteOfDay(static_cast<int>(minutes));
+    }
+
+    /**
+     * @brief Gets the end of the day, 2400.
+     * @return The end of the day.
+     */
+    static constexpr MinuteOfDay endOfDay() { return MinuteOfDay(Constants::MINUTES_PER_DAY); }
+
+    /**
+     * @brief Gets the minutes since midnight.
+     * @return The minutes, from 0 to MINUTES_PER_DAY.
+     */
+    constexpr int minutes() const { return value; }
+
+    /**
+     * @brief Gets the time in HHMM format as four characters.
+     * @return The digits, such as {'0', '9', '3', '0'}.
+     */
+    constexpr std::array<char, 4> digits() const
+    {
+        int pair = value / 60 * 2;
+        int minutePair = value % 60 * 2;
+        return {DIGIT_PAIRS[pair], DIGIT_PAIRS[pair + 1], DIGIT_PAIRS[minutePair], DIGIT_PAIRS[minutePair + 1]};
+    }
+
+    /**
+     * @brief Formats the time in HHMM format.
+     * @return The time, such as "0930".
+     */
+    std::string format() const
+    {
+        std::array<char, 4> text = digits();
+        return std::string(text.data(), text.size());
+    }
+
+    /**
+     * @brief Compares times of day.
+     */
+    friend constexpr auto operator<=>(MinuteOfDay, MinuteOfDay) = default;
+
+private:
+    uint16_t value = 0; ///< Minutes since midnight.
+
+    /**
+     * @brief Constructs a time of day from minutes that are known to be within the day.
+     * @param minutes The minutes since midnight.
+     */
+    constexpr explicit MinuteOfDay(int minutes) : value(static_cast<uint16_t>(minutes)) {}
+
+    /**
+     * @brief The two-digit decimal forms of 0 to 24 for hours and 0 to 59 for minutes, one after another.
+     */
+    static constexpr std::array<char, 120> DIGIT_PAIRS = []()
+    {
+        std::array<char, 120> pairs{};
+        for (int i = 0; i < 60; ++i)
+        {
+            pairs[i * 2] = static_cast<char>('0' + i / 10);
+            pairs[i * 2 + 1] = static_cast<char>('0' + i % 10);
+        }
+        return pairs;
+    }();
+};
+
+#endif // WEEK_TIME_HPP
@@ -0,0 +1,245 @@
+#include "AsyncClient.hpp"
+
+#include <iostream>
+
+#include "Constants.hpp"
+#include "RequestFactory.hpp"
+#include "Serializer.hpp"
+
+/**
+ * @brief Constructs an AsyncClient that sends requests to the given server through the loop.
+ *
+ * @param loop The event loop owning the socket.
+ * @param serverIp The IP address or hostname of the server.
+ * @param serverPort The port number of the server.
+ *
+ * @throws std::runtime_error if the server address cannot be resolved.
+ */
+AsyncClient::AsyncClient(EventLoop &loop, const std::string &serverIp, int serverPort)
+    : loop(loop), serverAddr(Socket::resolveAddress(serverIp, serverPort))
+{
+}
+
+/**
+ * @brief Queries the names of all available facilities.
+ *
+ * @return A task yielding the list of facility names or an error message.
+ */
+Task<std::string> AsyncClient::queryFacilityNamesAsync()
+{
+    return sendWithRetry(RequestFactory::queryFacilityNames());
+}
+
+/**
+ * @brief Queries the availability of a facility for specific days.
+ *
+ * @param facilityName The name of the facility to query availability for.
+ * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+ *
+ * @return A task yielding the availability information or an error message.
+ */
+Task<std::string> AsyncClient::queryAvailabilityAsync(std::string facilityName, uint8_t dayMask)
+{
+    return sendWithRetry(RequestFactory::queryAvailability(facilityName, dayMask));
+}
+
+/**
+ * @brief Books a facility for a specific day and time range.
+ *
+ * @param facilityName The name of the facility.
+ * @param dayOfWeek The day of the week.
+ * @param startTime The start time.
+ * @param endTime The end time.
+ *
+ * @return A task yielding the booking confirmation or an error message.
+ */
+Task<std::string> AsyncClient::bookFacilityAsync(
+    std::string facilityName,
+    DayOfWeek dayOfWeek,
+    MinuteOfDay startTime,
+    MinuteOfDay endTime
+)
+{
+    return sendWithRetry(RequestFactory::bookFacility(facilityName, dayOfWeek, startTime, endTime));
+}
+
+/**
+ * @brief Queries the details of an existing booking.
+ *
+ * @param bookingID The ID of the booking to query.
+ *
+ * @return A task yielding the booking details or an error message.
+ */
+Task<std::string> AsyncClient::queryBookingAsync(std::string bookingID)
+{
+    return sendWithRetry(RequestFactory::queryBooking(bookingID));
+}
+
+/**
+ * @brief Updates an existing booking by applying a time offset.
+ *
+ * @param oldBooking The booking to update, as parsed from its details.
+ * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+ *
+ * @return A task yielding the updated booking details or an error message.
+ */
+Task<std::string> AsyncClient::updateBookingAsync(ResponseParser::Booking oldBooking, int offsetMinutes)
+{
+    return sendWithRetry(RequestFactory::updateBooking(oldBooking, offsetMinutes));
+}
+
+/**
+ * @brief Deletes an existing booking.
+ *
+ * @param booking The booking to delete, as parsed from its details.
+ *
+ * @return A task yielding the deletion confirmation or an error message.
+ */
+Task<std::string> AsyncClient::deleteBookingAsync(ResponseParser::Booking booking)
+{
+    return sendWithRetry(RequestFactory::deleteBooking(booking));
+}
+
+/**
+ * @brief Registers interest in a facility without waiting for its updates.
+ *
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration of the registration in seconds.
+ *
+ * @return A task yielding the registration confirmation or an error message.
+ */
+Task<std::string> AsyncClient::registerMonitorAsync(std::string facilityName, int durationSeconds)
+{
+    return sendWithRetry(RequestFactory::registerMonitor(facilityName, durationSeconds));
+}
+
+/**
+ * @brief Monitors the availability of a facility for a specified duration.
+ *
+ * Unlike Client::monitorAvailability(), only the awaiting coroutine is suspended during the monitoring period;
+ * other coroutines on the loop keep running. Updates for other facilities are skipped.
+ *
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration to monitor in seconds.
+ * @param onUpdate Callback function to handle the registration response and the updates.
+ *
+ * @return A task that finishes when the duration has elapsed or the registration failed.
+ *
+ * @note The boolean in the callback function indicates whether the message is the registration response.
+ * @note The server sends one update per registration, and all AsyncClients of a loop share its socket. If several
+ * coroutines on the same loop monitor the same facility, each of them receives every copy of an update.
+ */
+Task<void> AsyncClient::monitorAvailabilityAsync(
+    std::string facilityName,
+    int durationSeconds,
+    std::function<void(const std::string &, const bool)> onUpdate
+)
+{
+    auto endTime = EventLoop::Clock::now() + std::chrono::seconds(durationSeconds);
+
+    std::string registrationResponse = co_await registerMonitorAsync(facilityName, durationSeconds);
+    onUpdate(registrationResponse, true);
+
+    if (ResponseParser::parseStatus(registrationResponse).failed())
+    {
+        co_return;
+    }
+
+    const std::string facilityLine = "facility:" + facilityName + "\n";
+
+    while (EventLoop::Clock::now() < endTime)
+    {
+        auto remaining = std::chrono::ceil<std::chrono::milliseconds>(endTime - EventLoop::Clock::now());
+        std::shared_ptr<RequestMessage> update = co_await loop.receivePush(remaining);
+
+        if (update && update->getData().find(facilityLine) != std::string::npos)
+        {
+            onUpdate(update->getData(), false);
+        }
+    }
+}
+
+/**
+ * @brief Rates a facility.
+ *
+ * @param facilityName The name of the facility to rate.
+ * @param rating The rating value (e.g., 4.5).
+ *
+ * @return A task yielding the rating confirmation or an error message.
+ */
+Task<std::string> AsyncClient::rateFacilityAsync(std::string facilityName, float rating)
+{
+    return sendWithRetry(RequestFactory::rateFacility(facilityName, rating));
+}
+
+/**
+ * @brief Queries the rating of a facility.
+ *
+ * @param facilityName The name of the facility to query.
+ *
+ * @return A task yielding the rating information or an error message.
+ */
+Task<std::string> AsyncClient::queryRatingAsync(std::string facilityName)
+{
+    return sendWithRetry(RequestFactory::queryRating(facilityName));
+}
+
+/**
+ * @brief Sends an echo message to the server.
+ *
+ * @param messageData The message data to send.
+ *
+ * @return A task yielding the echoed message or an error message.
+ */
+Task<std::string> AsyncClient::echoMessageAsync(std::string messageData)
+{
+    return sendWithRetry(RequestFactory::echoMessage(messageData));
+}
+
+/**
+ * @brief Sends a request and awaits its reply, retransmitting on timeout.
+ *
+ * The request is serialized once and the same bytes are sent on every attempt, so the server's
+ * duplicate filtering sees the same identity. Each attempt waits up to TIMEOUT_SEC for the reply
+ * on an awaitable timer; the coroutine is suspended, not the thread. The request carries the loop's
+ * acknowledged watermark at the time it is first sent.
+ *
+ * @param request The request to send. Its request ID and identity are assigned by the loop.
+ *
+ * @return A task yielding the reply data or an error message.
+ */
+Task<std::string> AsyncClient::sendWithRetry(RequestMessage request)
+{
+    RequestIdentitySource &identitySource = loop.getIdentitySource();
+
+    request.setRequestID(loop.nextRequestID());
+    request.setIdentity(identitySource.next());
+    request.setAckedSequence(identitySource.getAckedSequence());
+    std::vector<uint8_t> serializedData = JavaSerializer::serialize(&request);
+
+    for (int attempt = 0; attempt < Constants::MAX_RETRIES; ++attempt)
+    {
+        try
+        {
+            loop.send(serializedData, serverAddr);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error sending data: " << e.what() << std::endl;
+        }
+
+        std::shared_ptr<RequestMessage> reply = co_await loop.receiveReply(request.getRequestID(), std::chrono::seconds(Constants::TIMEOUT_SEC));
+
+        if (reply)
+        {
+            identitySource.complete(request.getIdentity().sequence);
+            co_return reply->getData();
+        }
+
+        std::cerr << "No response received. Retrying... (" << (attempt + 1) << "/" << Constants::MAX_RETRIES << ")" << std::endl;
+    }
+
+    identitySource.complete(request.getIdentity().sequence);
+
+    co_return Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE;
+}
@@ -0,0 +1,106 @@
+#include "AvailabilityCache.hpp"
+
+/**
+ * @brief Stores the requested days of a parsed availability reply.
+ *
+ * Every requested day replaces the cached one, including days the reply does not list, which are closed.
+ * Other days keep their cached state.
+ *
+ * @param availability The parsed availability, parsed with the mask of the days the query asked for. Errors are not stored.
+ * @param fetchedAt The time the reply was received.
+ */
+void AvailabilityCache::store(const ResponseParser::Availability &availability, Clock::time_point fetchedAt)
+{
+    uint8_t dayMask = availability.requestedDays;
+    if (availability.error.failed() || availability.facility.empty() || dayMask == 0)
+    {
+        return;
+    }
+
+    AvailabilityCalendar received = AvailabilityCalendar::fromAvailability(availability);
+    Entry &entry = entries[availability.facility];
+
+    for (int day = 0; day < Constants::DAYS_PER_WEEK; ++day)
+    {
+        if (dayMask & (1 << day))
+        {
+            entry.calendar.copyDay(day, received);
+            entry.fetchedAt[day] = fetchedAt;
+        }
+    }
+    entry.knownDays |= dayMask;
+}
+
+/**
+ * @brief Marks a range of a cached day busy, such as after the client booked it.
+ *
+ * Facilities that are not cached are left uncached.
+ *
+ * @param facilityName The facility name.
+ * @param day The day.
+ * @param start The start of the range.
+ * @param end The end of the range, exclusive.
+ */
+void AvailabilityCache::markBusy(const std::string &facilityName, DayOfWeek day, MinuteOfDay start, MinuteOfDay end)
+{
+    auto found = entries.find(facilityName);
+    if (found != entries.end())
+    {
+        found->second.calendar.setFree(Days::index(day), start.minutes(), end.minutes(), false);
+    }
+}
+
+/**
+ * @brief Forgets the cached availability of a facility.
+ *
+ * @param facilityName The facility name.
+ */
+void AvailabilityCache::invalidate(const std::string &facilityName)
+{
+    entries.erase(facilityName);
+}
+
+/**
+ * @brief Forgets the cached availability of every facility.
+ */
+void AvailabilityCache::clear()
+{
+    entries.clear();
+}
+
+/**
+ * @brief Checks whether fresh cached availability shows that a range cannot be booked.
+ *
+ * Only a definite answer from fresh data rejects a booking: ranges of uncached or stale days, and empty ranges,
+ * are left for the server to decide.
+ *
+ * @param facilityName The facility name.
+ * @param day The day.
+ * @param start The start of the range.
+ * @param end The end of the range, exclusive.
+ * @param maxAge The maximum age of cached days that are trusted.
+ * @param now The current time.
+ *
+ * @return True if the day is cached, no older than maxAge, and any minute of the range is not free.
+ */
+bool AvailabilityCache::isKnownUnavailable(const std::string &facilityName, DayOfWeek day, MinuteOfDay start, MinuteOfDay end, Clock::duration maxAge, Clock::time_point now) const
+{
+    if (start >= end)
+    {
+        return false;
+    }
+
+    auto found = entries.find(facilityName);
+    if (found == entries.end())
+    {
+        return false;
+    }
+
+    const Entry &entry = found->second;
+    if (!(entry.knownDays & Days::bit(day)) || now - entry.fetchedAt[Days::index(day)] > maxAge)
+    {
+        return false;
+    }
+
+    return !entry.calendar.isFree(Days::index(day), start.minutes(), end.minutes());
+}
@@ -0,0 +1,252 @@
+#include "AvailabilityCalendar.hpp"
+
+#include <algorithm>
+#include <bit>
+
+/**
+ * @brief Constructs a calendar in which every minute is busy.
+ */
+AvailabilityCalendar::AvailabilityCalendar() : words{}
+{
+}
+
+/**
+ * @brief Builds the calendar of a parsed availability response.
+ *
+ * Days the server did not list stay busy, as the facility is closed on them, and so do days that were not parsed.
+ *
+ * @param availability The parsed availability. Timeslots that are not valid ranges are skipped.
+ *
+ * @return The calendar, with the minutes of the listed timeslots free and all others busy.
+ */
+AvailabilityCalendar AvailabilityCalendar::fromAvailability(const ResponseParser::Availability &availability)
+{
+    AvailabilityCalendar calendar;
+
+    for (int day = 0; day < Constants::DAYS_PER_WEEK; ++day)
+    {
+        for (const ResponseParser::Timeslot &timeslot : availability.timeslots(static_cast<DayOfWeek>(day)))
+        {
+            if (isValidRange(day, timeslot.start.minutes(), timeslot.end.minutes()))
+            {
+                calendar.setFree(day, timeslot.start.minutes(), timeslot.end.minutes());
+            }
+        }
+    }
+
+    return calendar;
+}
+
+/**
+ * @brief Replaces the minutes of a day with those of the same day in another calendar.
+ *
+ * Invalid days are ignored.
+ *
+ * @param day The index of the day.
+ * @param source The calendar to copy from.
+ */
+void AvailabilityCalendar::copyDay(int day, const AvailabilityCalendar &source)
+{
+    if (day < 0 || day >= Constants::DAYS_PER_WEEK)
+    {
+        return;
+    }
+
+    std::copy_n(&source.words[day * WORDS_PER_DAY], WORDS_PER_DAY, &words[day * WORDS_PER_DAY]);
+}
+
+/**
+ * @brief Marks a range of minutes as free or busy.
+ *
+ * Invalid ranges are ignored.
+ *
+ * @param day The index of the day.
+ * @param start The first minute.
+ * @param end The minute after the last one.
+ * @param free True to mark the minutes free, false to mark them busy.
+ */
+void AvailabilityCalendar::setFree(int day, int start, int end, bool free)
+{
+    if (!isValidRange(day, start, end))
+    {
+        return;
+    }
+
+    uint64_t *dayWords = &words[day * WORDS_PER_DAY];
+    for (int word = start / WORD_BITS; word <= (end - 1) / WORD_BITS; ++word)
+    {
+        uint64_t mask = rangeMask(word, start, end);
+        dayWords[word] = free ? dayWords[word] | mask : dayWords[word] & ~mask;
+    }
+}
+
+/**
+ * @brief Checks whether every minute of a range is free.
+ *
+ * Every word the range covers is compared with its mask, without branching on individual minutes.
+ *
+ * @param day The index of the day.
+ * @param start The first minute.
+ * @param end The minute after the last one.
+ *
+ * @return True if the range is free, false if any minute of it is busy or it is outside the day.
+ */
+bool AvailabilityCalendar::isFree(int day, int start, int end) const
+{
+    if (!isValidRange(day, start, end))
+    {
+        return false;
+    }
+
+    const uint64_t *dayWords = &words[day * WORDS_PER_DAY];
+    uint64_t missing = 0;
+    for (int word = start / WORD_BITS; word <= (end - 1) / WORD_BITS; ++word)
+    {
+        uint64_t mask = rangeMask(word, start, end);
+        missing |= mask & ~dayWords[word];
+    }
+    return missing == 0;
+}
+
+/**
+ * @brief Finds the earliest free window of a given length within a range of a day.
+ *
+ * The search jumps from each busy minute to the next free one and back, a word at a time, so it takes
+ * time proportional to the words and free runs of the range rather than its minutes.
+ *
+ * @param day The index of the day.
+ * @param length The length of the window in minutes.
+ * @param from The earliest start of the window.
+ * @param until The latest end of the window.
+ *
+ * @return The first minute of the window, or -1 if there is none.
+ */
+int AvailabilityCalendar::findFreeWindow(int day, int length, int from, int until) const
+{
+    if (length <= 0 || !isValidRange(day, from, until) || until - from < length)
+    {
+        return -1;
+    }
+
+    int start = from;
+    while (until - start >= length)
+    {
+        start = findNext(day, start, until, true);
+        if (until - start < length)
+        {
+            break;
+        }
+
+        int end = findNext(day, start, start + length, false);
+        if (end == start + length)
+        {
+            return start;
+        }
+        start = end;
+    }
+    return -1;
+}
+
+/**
+ * @brief Keeps only the minutes that are also free in another calendar.
+ *
+ * @param other The other calendar, such as that of another facility.
+ */
+void AvailabilityCalendar::intersect(const AvailabilityCalendar &other)
+{
+    for (size_t word = 0; word < words.size(); ++word)
+    {
+        words[word] &= other.words[word];
+    }
+}
+
+/**
+ * @brief Counts the free minutes of a day.
+ *
+ * @param day The index of the day.
+ *
+ * @return The number of free minutes.
+ */
+int AvailabilityCalendar::countFreeMinutes(int day) const
+{
+    if (day < 0 || day >= Constants::DAYS_PER_WEEK)
+    {
+        return 0;
+    }
+
+    int count = 0;
+    for (int word = 0; word < WORDS_PER_DAY; ++word)
+    {
+        count += std::popcount(words[day * WORDS_PER_DAY + word]);
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the mask of the bits of a word that lie within a range of minutes.
+ *
+ * @param word The index of the word within its day.
+ * @param start The first minute.
+ * @param end The minute after the last one.
+ *
+ * @return The mask, empty if the word lies outside the range.
+ */
+uint64_t AvailabilityCalendar::rangeMask(int word, int start, int end)
+{
+    int low = std::max(start - word * WORD_BITS, 0);
+    int high = std::min(end - word * WORD_BITS, WORD_BITS);
+    if (low >= high)
+    {
+        return 0;
+    }
+
+    uint64_t belowHigh = high == WORD_BITS ? ~uint64_t(0) : (uint64_t(1) << high) - 1;
+    uint64_t belowLow = (uint64_t(1) << low) - 1;
+    return belowHigh & ~belowLow;
+}
+
+/**
+ * @brief Finds the next minute at or after a given one whose bit has a given value.
+ *
+ * Each word is inverted when searching for busy minutes, masked to the range and scanned with a count of
+ * trailing zeros.
+ *
+ * @param day The index of the day.
+ * @param minute The minute to start at.
+ * @param until The minute to stop at.
+ * @param free True to find a free minute, false to find a busy one.
+ *
+ * @return The minute found, or until if there is none before it.
+ */
+int AvailabilityCalendar::findNext(int day, int minute, int until, bool free) const
+{
+    if (minute >= until)
+    {
+        return until;
+    }
+
+    const uint64_t *dayWords = &words[day * WORDS_PER_DAY];
+    for (int word = minute / WORD_BITS; word <= (until - 1) / WORD_BITS; ++word)
+    {
+        uint64_t bits = (free ? dayWords[word] : ~dayWords[word]) & rangeMask(word, minute, until);
+        if (bits != 0)
+        {
+            return word * WORD_BITS + std::countr_zero(bits);
+        }
+    }
+    return until;
+}
+
+/**
+ * @brief Checks that a day and a range of minutes are valid.
+ *
+ * @param day The index of the day.
+ * @param start The first minute.
+ * @param end The minute after the last one.
+ *
+ * @return True if the day exists and 0 <= start < end <= MINUTES_PER_DAY.
+ */
+bool AvailabilityCalendar::isValidRange(int day, int start, int end)
+{
+    return day >= 0 && day < Constants::DAYS_PER_WEEK && start >= 0 && start < end && end <= Constants::MINUTES_PER_DAY;
+}
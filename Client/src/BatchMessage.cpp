@@ -0,0 +1,106 @@
+#include "BatchMessage.hpp"
+
+/**
+ * @brief Default constructor for BatchMessage.
+ *
+ * Initializes the batch ID to 0 and the batch to no requests.
+ */
+BatchMessage::BatchMessage() : batchID(0) {}
+
+/**
+ * @brief Parameterized constructor for BatchMessage.
+ *
+ * @param batchID The unique identifier for the batch.
+ * @param requests The requests carried by the batch.
+ */
+BatchMessage::BatchMessage(int batchID, const std::vector<RequestMessage> &requests)
+    : batchID(batchID), requests(requests) {}
+
+/**
+ * @brief Gets the Java class name for serialization.
+ *
+ * @return The Java class name as a string.
+ */
+std::string BatchMessage::getJavaClassName() const
+{
+    return "Server.BatchMessage";
+}
+
+/**
+ * @brief Gets the metadata about the fields in the batch message.
+ *
+ * The requests are declared as a Java array of RequestMessage, using the JVM's name for array types.
+ *
+ * @return A vector of pairs representing field names and their types.
+ */
+std::vector<std::pair<std::string, std::string>> BatchMessage::getFieldMetadata() const
+{
+    return {
+        {"batchID", "int"},
+        {"requests", "[LServer.RequestMessage;"}
+    };
+}
+
+/**
+ * @brief Serializes the field values into a byte buffer.
+ *
+ * The requests are written as an array: the element count followed by each request as a nested object.
+ *
+ * @param buffer The byte buffer to write the serialized data to.
+ */
+void BatchMessage::serializeFieldValues(ByteBuffer &buffer) const
+{
+    buffer.writeInt(batchID);
+
+    buffer.writeInt(static_cast<int32_t>(requests.size()));
+    for (const RequestMessage &request : requests)
+    {
+        JavaSerializer::serializeObject(&request, buffer);
+    }
+}
+
+/**
+ * @brief Deserializes the fields from a byte reader.
+ *
+ * A null array (length -1) is read as an empty batch.
+ *
+ * @param reader The byte reader to read the serialized data from.
+ *
+ * @throws std::runtime_error if an element of the batch is not a RequestMessage.
+ */
+void BatchMessage::deserializeFields(ByteReader &reader)
+{
+    batchID = reader.readInt();
+
+    requests.clear();
+    int length = reader.readInt();
+    for (int i = 0; i < length; i++)
+    {
+        std::shared_ptr<RequestMessage> request = std::dynamic_pointer_cast<RequestMessage>(JavaDeserializer::deserializeObject(reader));
+        if (!request)
+        {
+            throw std::runtime_error("Batch element is not a RequestMessage");
+        }
+        requests.push_back(*request);
+    }
+}
+
+/**
+ * @brief Gets the batch ID.
+ *
+ * @return The batch ID as an integer.
+ */
+int BatchMessage::getBatchID() const
+{
+    return batchID;
+}
+
+/**
+ * @brief Gets the requests carried by the batch.
+ *
+ * @return The requests in batch order.
+ */
+const std::vector<RequestMessage> &BatchMessage::getRequests() const
+{
+    return requests;
+}
@@ -0,0 +1,130 @@
+#include "BatchPacker.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "Serializer.hpp"
+
+/**
+ * @brief Constructs a packer with no open batch.
+ *
+ * @param maxDatagramSize The maximum serialized size of a batch in bytes.
+ * @param linger The time a batch waits for more requests after its first request.
+ */
+BatchPacker::BatchPacker(size_t maxDatagramSize, std::chrono::microseconds linger)
+    : maxDatagramSize(maxDatagramSize), linger(linger), encodedSize(getEnvelopeSize())
+{
+}
+
+/**
+ * @brief Adds a request to the open batch.
+ *
+ * A request nested in a batch is serialized exactly as a standalone message without its parity byte,
+ * so its share of the batch size is measured by serializing it on its own.
+ *
+ * @param request The request to add.
+ *
+ * @return False if the request does not fit in the open batch, which is then left unchanged.
+ *
+ * @throws std::runtime_error if the request does not fit in a batch on its own.
+ */
+bool BatchPacker::add(const RequestMessage &request)
+{
+    size_t requestSize = JavaSerializer::serialize(&request).size() - 1;
+
+    if (getEnvelopeSize() + requestSize > maxDatagramSize)
+    {
+        throw std::runtime_error("Request of " + std::to_string(requestSize) + " bytes does not fit in a batch");
+    }
+
+    if (encodedSize + requestSize > maxDatagramSize)
+    {
+        return false;
+    }
+
+    if (requests.empty())
+    {
+        openedAt = Clock::now();
+    }
+
+    requests.push_back(request);
+    encodedSize += requestSize;
+    return true;
+}
+
+/**
+ * @brief Checks whether the open batch has waited long enough for more requests.
+ *
+ * @param now The current time.
+ *
+ * @return True if the batch holds requests and has been open for at least the linger time.
+ */
+bool BatchPacker::isReady(Clock::time_point now) const
+{
+    return !requests.empty() && now - openedAt >= linger;
+}
+
+/**
+ * @brief Checks whether the open batch holds no requests.
+ *
+ * @return True if there is nothing to send.
+ */
+bool BatchPacker::empty() const
+{
+    return requests.empty();
+}
+
+/**
+ * @brief Gets the serialized size of the open batch.
+ *
+ * @return The size in bytes, including the parity byte.
+ */
+size_t BatchPacker::getEncodedSize() const
+{
+    return encodedSize;
+}
+
+/**
+ * @brief Closes the open batch and starts a new, empty one.
+ *
+ * @param batchID The ID to give the closed batch.
+ *
+ * @return The closed batch.
+ */
+BatchMessage BatchPacker::take(int batchID)
+{
+    BatchMessage batch(batchID, requests);
+
+    requests.clear();
+    encodedSize = getEnvelopeSize();
+
+    return batch;
+}
+
+/**
+ * @brief Sets the time a batch waits for more requests after its first request.
+ *
+ * @param linger The linger time.
+ */
+void BatchPacker::setLinger(std::chrono::microseconds linger)
+{
+    this->linger = linger;
+}
+
+/**
+ * @brief Gets the serialized size of a batch without requests.
+ *
+ * The size does not depend on the batch ID, as integers are written with a fixed width.
+ *
+ * @return The size in bytes, including the parity byte.
+ */
+size_t BatchPacker::getEnvelopeSize()
+{
+    static const size_t envelopeSize = []()
+    {
+        BatchMessage emptyBatch;
+        return JavaSerializer::serialize(&emptyBatch).size();
+    }();
+
+    return envelopeSize;
+}
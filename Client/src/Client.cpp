@@ -1,19 +1,34 @@
 #include "Client.hpp"
 
+#include "BatchMessage.hpp"
 #include "Constants.hpp"
+#include "Parity.hpp"
+#include "RequestFactory.hpp"
 #include "Serializer.hpp"
 #include "UserInterface.hpp"
+#include <algorithm>
 #include <chrono>
+#include <unordered_map>
+
 /**
  * @brief Constructs a Client object and initializes the connection to the server.
  *
  * This constructor creates a UDP socket, binds it to a local address, and sets up
  * the remote server address. It also sets a timeout for receiving data.
+ * Request IDs start at 1 as the server uses ID 0 for the monitoring updates it pushes to clients.
+ * With a journal, the client continues under the nonce stored in it, in a new epoch; call replayJournal()
+ * to resend the requests left pending by the previous run.
  *
  * @param serverIp The IP address of the server.
  * @param serverPort The port number of the server.
+ * @param journalPath The path of the request journal, or an empty string to not journal requests.
  */
-Client::Client(const std::string &serverIp, int serverPort) : requestID(0)
+Client::Client(const std::string &serverIp, int serverPort, const std::string &journalPath)
+    : requestID(1), journal(openJournal(journalPath)),
+      identitySource(journal ? journal->getClientNonce() : RequestIdentitySource::generateNonce(), journal ? journal->getEpoch() : 1),
+      rttEstimator(std::chrono::seconds(Constants::TIMEOUT_SEC)), pipelineWindow(Constants::PIPELINE_INITIAL_WINDOW),
+      batchPacker(Constants::BATCH_MTU, std::chrono::microseconds(Constants::BATCH_LINGER_US)),
+      bookingPrecheck(false), precheckMaxAge(Constants::PRECHECK_MAX_AGE_MS), precheckRejections(0)
 {
     try
     {
@@ -63,9 +78,11 @@ Client::~Client()
  */
 std::string Client::queryFacilityNames()
 {
-    std::string messageData = "facility,ALL"; // Request all facility name
-
-    RequestMessage requestMessage(RequestMessage::READ, requestID, messageData); // READ operation
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::queryFacilityNames();
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
     return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
@@ -74,52 +91,86 @@ std::string Client::queryFacilityNames()
  * @brief Queries the availability of a facility for specific days.
  * 
  * This method sends a request to the server to check the availability of a facility for the specified days.
+ * With the booking pre-check on, the requested days of a successful reply are cached for it.
  * 
  * @param facilityName The name of the facility to query availability for.
- * @param daysOfWeek A comma-separated list of days (e.g., "MONDAY,TUESDAY,WEDNESDAY").
+ * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
  * 
  * @return A string containing the availability information or error message.
  */
-std::string Client::queryAvailability(std::string facilityName, std::string daysOfWeek)
+std::string Client::queryAvailability(std::string facilityName, uint8_t dayMask)
 {
-    std::string messageData = "facility," + facilityName + "," + daysOfWeek; // Request availability for the specified facility and days
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::queryAvailability(facilityName, dayMask);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
-    RequestMessage requestMessage(RequestMessage::READ, requestID, messageData); // READ operation
+    std::string response = sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 
-    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
+    if (bookingPrecheck)
+    {
+        availabilityCache.store(*parseAvailability(response, dayMask), AvailabilityCache::Clock::now());
+    }
+
+    return response;
 }
 
 /**
  * @brief Books a facility for a specific day and time range.
  * 
  * This method sends a request to the server to book a facility for the specified day and time range.
+ * With the booking pre-check on, a booking that fresh cached availability shows to be on a closed day, outside
+ * the opening hours or overlapping a booking is rejected with the error the server would send, without a round
+ * trip. The booked range of a successful booking is marked busy in the cache, and the cached availability of the
+ * facility is dropped after a failed one, as the cache was evidently out of date.
  * 
  * @param facilityName The name of the facility.
- * @param dayOfWeek The day of the week (e.g., "MONDAY").
- * @param startTime The start time in HHMM format (e.g., "0900").
- * @param endTime The end time in HHMM format (e.g., "1100").
+ * @param dayOfWeek The day of the week.
+ * @param startTime The start time.
+ * @param endTime The end time.
+ * @param bypassPrecheck True to send the booking even if cached availability shows it cannot succeed.
  * 
  * @return A string containing the booking confirmation or error message.
+ * 
+ * @note The server does not check opening hours when booking, so bypassing the pre-check may succeed where it rejects.
  */
 std::string Client::bookFacility(
     std::string facilityName,
-    std::string dayOfWeek,
-    std::string startTime,
-    std::string endTime
+    DayOfWeek dayOfWeek,
+    MinuteOfDay startTime,
+    MinuteOfDay endTime,
+    bool bypassPrecheck
 )
 {
-    std::string startTimeHour, startTimeMinute, endTimeHour, endTimeMinute;
-    // Extract hours and minutes from the start and end times
-    startTimeHour = startTime.substr(0, 2);
-    startTimeMinute = startTime.substr(2, 2);
-    endTimeHour = endTime.substr(0, 2);
-    endTimeMinute = endTime.substr(2, 2);
+    if (bookingPrecheck && !bypassPrecheck &&
+        availabilityCache.isKnownUnavailable(facilityName, dayOfWeek, startTime, endTime, precheckMaxAge, AvailabilityCache::Clock::now()))
+    {
+        precheckRejections++;
+        return Constants::STATUS_ERROR + "\nmessage:" + Constants::SLOT_UNAVAILABLE_MESSAGE;
+    }
 
-    std::string messageData = facilityName + "," + dayOfWeek + "," + startTimeHour + "," + startTimeMinute + "," + endTimeHour + "," + endTimeMinute; // Booking request for the specified facility, day, and times
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::bookFacility(facilityName, dayOfWeek, startTime, endTime);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
-    RequestMessage requestMessage(RequestMessage::WRITE, requestID, messageData); // WRITE operation
+    std::string response = sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 
-    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
+    if (bookingPrecheck)
+    {
+        if (!ResponseParser::parseStatus(response).failed())
+        {
+            availabilityCache.markBusy(facilityName, dayOfWeek, startTime, endTime);
+        }
+        else
+        {
+            availabilityCache.invalidate(facilityName);
+        }
+    }
+
+    return response;
 }
 
 /**
@@ -133,9 +184,11 @@ std::string Client::bookFacility(
  */
 std::string Client::queryBooking(std::string bookingID)
 {
-    std::string messageData = "booking," + bookingID; // Request booking details for the specified ID
-
-    RequestMessage requestMessage(RequestMessage::READ, requestID, messageData); // READ operation
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::queryBooking(bookingID);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
     return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
@@ -146,53 +199,27 @@ std::string Client::queryBooking(std::string bookingID)
  * This method sends a request to the server to update an existing booking by applying a time offset.
  * The new start and end times are first calculated based on the old booking details and the offset.
  * Then, the update request containing the old booking ID, facility name, day of the week, and new times are sent to the server.
+ * With the booking pre-check on, the cached availability of the facility is dropped, as the update frees one range and books another.
  * 
- * @param oldBookingID The ID of the booking to update.
+ * @param oldBooking The booking to update, as parsed from its details.
  * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
- * @param oldBookingDetails The details of the old booking to be updated.
  * 
  * @return A string containing the updated booking details or an error message.
+ * 
+ * @throws std::runtime_error if the booking has no valid day, start or end time.
  */
-std::string Client::updateBooking(
-    std::string oldBookingID,
-    int offsetMinutes,
-    std::string oldBookingDetails)
-{
-    // Extract facility name, day of week, start time, and end time from the old booking details
-    std::string facilityName = extractFacilityName(oldBookingDetails);
-    std::string oldDayOfWeek = extractDayOfWeek(oldBookingDetails);
-    std::string oldStartTime = extractStartTime(oldBookingDetails);
-    std::string oldEndTime = extractEndTime(oldBookingDetails);
-
-    // Parse old start and end times into hours and minutes
-    int oldStartHour = std::stoi(oldStartTime.substr(0, 2));
-    int oldStartMinute = std::stoi(oldStartTime.substr(2, 2));
-    int oldEndHour = std::stoi(oldEndTime.substr(0, 2));
-    int oldEndMinute = std::stoi(oldEndTime.substr(2, 2));
-
-    // Apply offset
-    int totalStartMinutes = oldStartHour * 60 + oldStartMinute + offsetMinutes;
-    int totalEndMinutes = oldEndHour * 60 + oldEndMinute + offsetMinutes;
-
-    // Calculate new start and end times
-    int newStartHour = totalStartMinutes / 60;
-    int newStartMinute = totalStartMinutes % 60;
-    int newEndHour = totalEndMinutes / 60;
-    int newEndMinute = totalEndMinutes % 60;
-
-    // Now we can proceed with the change booking request
-    std::string messageData = (
-        "booking," +
-        oldBookingID + "," +
-        facilityName + "," +
-        oldDayOfWeek + "," +
-        std::to_string(newStartHour) + "," +
-        std::to_string(newStartMinute) + "," +
-        std::to_string(newEndHour) + "," +
-        std::to_string(newEndMinute)
-    );
-
-    RequestMessage requestMessage(RequestMessage::UPDATE, requestID, messageData); // UPDATE operation
+std::string Client::updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes)
+{
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::updateBooking(oldBooking, offsetMinutes);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
+
+    if (bookingPrecheck)
+    {
+        availabilityCache.invalidate(oldBooking.facility);
+    }
 
     return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
@@ -201,22 +228,26 @@ std::string Client::updateBooking(
  * @brief Deletes an existing booking.
  * 
  * This method sends a request to the server to delete an existing booking.
+ * With the booking pre-check on, the cached availability of the facility is dropped, as the deletion frees a range.
  * 
- * @param bookingID The ID of the booking to delete.
- * @param bookingDetails The details of the booking to delete.
+ * @param booking The booking to delete, as parsed from its details.
  * 
  * @return A string containing the deletion confirmation or an error message.
  */
-std::string Client::deleteBooking(std::string bookingID, std::string bookingDetails)
+std::string Client::deleteBooking(const ResponseParser::Booking &booking)
 {
-    // Extract the facility name from the existing booking as it is required for the delete booking request
-    std::string facilityName = extractFacilityName(bookingDetails);
-
-    std::string messageData = bookingID + "," + facilityName; // Request to delete the booking with the specified ID and facility name
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::deleteBooking(booking);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
-    RequestMessage requestMessage(RequestMessage::DELETE_REQUEST, requestID, messageData); // DELETE (enum named as DELETE_REQUEST) operation
+    if (bookingPrecheck)
+    {
+        availabilityCache.invalidate(booking.facility);
+    }
 
-    return sendWithRetry(requestMessage);
+    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
 
 /**
@@ -239,15 +270,11 @@ void Client::monitorAvailability(
     const std::function<void(const std::string &, const bool)> &onUpdate
 )
 {
-    std::string messageData = "register," + facilityName + "," + std::to_string(durationSeconds); // Request to register for monitoring the specified facility for the specified duration
-
-    RequestMessage requestMessage(RequestMessage::MONITOR, requestID, messageData); // MONITOR operation
-
-    std::string registrationResponse = sendWithRetry(requestMessage);
+    std::string registrationResponse = registerMonitor(facilityName, durationSeconds);
     onUpdate(registrationResponse, true); // Call the callback function with the registration response
 
     // Check if the registration was successful
-    if (registrationResponse.find(Constants::STATUS_SUCCESS) == 0)
+    if (!ResponseParser::parseStatus(registrationResponse).failed())
     {
         // If successful, listen for updates for the specified duration
         // Client is blocked from making other requests during this time
@@ -258,6 +285,613 @@ void Client::monitorAvailability(
     }
 }
 
+/**
+ * @brief Registers interest in a facility without blocking for its updates.
+ * 
+ * This method sends the same registration request as monitorAvailability() but returns as soon as the server has replied.
+ * The caller is responsible for receiving the updates, e.g. through receiveMonitorUpdate() or a MonitorManager.
+ * 
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration of the registration in seconds.
+ * 
+ * @return A string containing the registration confirmation or an error message.
+ */
+std::string Client::registerMonitor(const std::string &facilityName, int durationSeconds)
+{
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::registerMonitor(facilityName, durationSeconds);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
+
+    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
+}
+
+/**
+ * @brief Waits for the next monitoring update pushed by the server.
+ * 
+ * Monitoring updates are serialized RequestMessages with request ID 0.
+ * Late replies to earlier requests may still arrive on the same socket; these are discarded and the wait continues until the timeout.
+ * 
+ * @param update The message to store the received update in.
+ * @param timeoutMillis The maximum time to wait in milliseconds.
+ * 
+ * @return True if an update was received before the timeout, false otherwise.
+ */
+bool Client::receiveMonitorUpdate(RequestMessage &update, int timeoutMillis)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMillis);
+    bool received = false;
+
+    while (!received)
+    {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+        {
+            break;
+        }
+
+        char recvBuffer[Constants::BUFFER_SIZE];
+        struct sockaddr_in senderAddr;
+
+        try
+        {
+            socket.setReceiveTimeoutMillis(static_cast<int>(remaining));
+            int bytesReceived = socket.receiveDataFrom(recvBuffer, senderAddr);
+
+            std::shared_ptr<RequestMessage> message = decodeMessage(recvBuffer, bytesReceived);
+            if (message->getRequestID() == 0)
+            {
+                update = *message;
+                received = true;
+            }
+            else
+            {
+                std::cerr << "Discarding late reply for request ID " << message->getRequestID() << std::endl;
+            }
+        }
+        catch (const std::exception &e)
+        {
+            // Timeouts end the wait, corrupted datagrams are skipped
+            if (std::string(e.what()).find("Timeout") != std::string::npos)
+            {
+                break;
+            }
+            std::cerr << e.what() << std::endl;
+        }
+    }
+
+    socket.setReceiveTimeout(Constants::TIMEOUT_SEC);
+
+    return received;
+}
+
+/**
+ * @brief Sets the handler for monitoring updates that arrive while waiting for a reply.
+ * 
+ * Without a handler, updates received while a request is outstanding are discarded.
+ * 
+ * @param handler The handler to call with each update, or an empty function to discard them.
+ */
+void Client::setPushHandler(const std::function<void(const RequestMessage &)> &handler)
+{
+    pushHandler = handler;
+}
+
+/**
+ * @brief Sends a batch of requests with several in flight at once and collects their replies.
+ * 
+ * Up to the current window of requests are outstanding at any time; as replies arrive, further requests are sent.
+ * Each request is retransmitted on its own when its timeout expires, so replies that did arrive are never requested again.
+ * The timeout comes from the measured round trips of requests answered on the first attempt (Karn's algorithm)
+ * and doubles with each retransmission of the same request.
+ * 
+ * The window grows by one request per window of replies and is halved when a timeout expires (AIMD),
+ * at most once per window of requests, so that a backlog at the single-threaded server drains instead of growing.
+ * The window persists across calls.
+ * 
+ * If journaling is on, non-idempotent requests are journaled before they are first sent, like those of
+ * sendWithRetry(), and can be resent alone by replayJournal().
+ * 
+ * Each request is a separate operation in the statistics and the trace, from its first transmission until it
+ * is answered or given up, and each transmission is an attempt that ends in a reply or a timeout. A datagram
+ * that answers no request in flight, or cannot be decoded, cannot be told apart from a late or corrupted reply,
+ * so it is counted against the request in flight that was sent first, the one waiting longest.
+ * 
+ * @param requests The requests to send. Their request IDs and identities are assigned by the client.
+ * 
+ * @return The reply data of each request in submission order, or an error message for requests that failed.
+ */
+std::vector<std::string> Client::submitPipelined(std::vector<RequestMessage> requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Attempt
+    {
+        Clock::time_point startedAt; ///< Time of the first transmission.
+        Clock::time_point sentAt; ///< Time of the latest transmission.
+        Clock::time_point deadline; ///< Time at which the request is retransmitted.
+        int transmissions = 0; ///< Number of times the request has been sent.
+    };
+
+    std::vector<std::string> results(requests.size());
+    std::vector<Attempt> attempts(requests.size());
+    std::unordered_map<int, size_t> inFlight; // Request ID to submission index
+    size_t nextToSend = 0;
+    size_t completed = 0;
+    size_t recoveryPoint = 0; // Losses of requests sent before this index belong to the last window decrease
+    bool timed = stats || tracer;
+
+    for (RequestMessage &request : requests)
+    {
+        request.setRequestID(requestID++);
+        request.setIdentity(identitySource.next());
+        journalRequest(request);
+    }
+
+    auto transmit = [&](size_t index)
+    {
+        Attempt &attempt = attempts[index];
+        auto timeout = rttEstimator.getTimeout() * (1LL << std::min(attempt.transmissions, 16));
+        timeout = std::min<std::chrono::milliseconds>(timeout, std::chrono::milliseconds(Constants::MAX_RTO_MS));
+
+        if (attempt.transmissions == 0)
+        {
+            attempt.startedAt = Clock::now();
+            if (stats)
+            {
+                stats->beginOperation(requests[index].getRequestType());
+            }
+        }
+
+        sendRequest(requests[index], attempt.transmissions > 0);
+        attempt.sentAt = Clock::now();
+        attempt.deadline = attempt.sentAt + timeout;
+        attempt.transmissions++;
+    };
+
+    // Ends the latest attempt of a request with the given outcome
+    auto endAttempt = [&](size_t index, ClientStats::Outcome outcome)
+    {
+        const RequestMessage &request = requests[index];
+        if (stats)
+        {
+            stats->recordAttempt(request.getRequestType(), outcome);
+        }
+        if (tracer)
+        {
+            Clock::time_point now = Clock::now();
+            tracer->record("attempt", attempts[index].sentAt, now, request.getRequestID(), request.getRequestType(), attempts[index].transmissions);
+            if (outcome != ClientStats::SUCCESS)
+            {
+                tracer->record(ClientStats::getOutcomeName(outcome), attempts[index].sentAt, now, request.getRequestID(), request.getRequestType());
+            }
+        }
+    };
+
+    // Stores the result of a request that was answered or given up
+    auto finish = [&](size_t index, std::string result, bool succeeded)
+    {
+        const RequestMessage &request = requests[index];
+        results[index] = std::move(result);
+        identitySource.complete(request.getIdentity().sequence);
+        completeJournaled(request);
+        completed++;
+
+        if (stats)
+        {
+            stats->recordOperation(request.getRequestType(), succeeded, Clock::now() - attempts[index].startedAt);
+        }
+        if (tracer)
+        {
+            tracer->record("operation", attempts[index].startedAt, Clock::now(), request.getRequestID(), request.getRequestType());
+        }
+    };
+
+    // Counts a datagram that answered no request in flight against the request in flight that was sent first
+    auto recordStray = [&](ClientStats::Outcome outcome, Clock::time_point waitStart)
+    {
+        if (inFlight.empty())
+        {
+            return;
+        }
+
+        size_t oldest = std::min_element(inFlight.begin(), inFlight.end(), [](const auto &a, const auto &b) { return a.second < b.second; })->second;
+        const RequestMessage &request = requests[oldest];
+        if (stats)
+        {
+            stats->recordAttempt(request.getRequestType(), outcome);
+        }
+        if (tracer)
+        {
+            tracer->record(ClientStats::getOutcomeName(outcome), waitStart, Clock::now(), request.getRequestID(), request.getRequestType());
+        }
+    };
+
+    while (completed < requests.size())
+    {
+        // Fill the window with requests that have not been sent yet
+        while (nextToSend < requests.size() && inFlight.size() < static_cast<size_t>(pipelineWindow))
+        {
+            inFlight[requests[nextToSend].getRequestID()] = nextToSend;
+            transmit(nextToSend);
+            nextToSend++;
+        }
+
+        Clock::time_point nextDeadline = Clock::time_point::max();
+        for (const auto &entry : inFlight)
+        {
+            nextDeadline = std::min(nextDeadline, attempts[entry.second].deadline);
+        }
+
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(nextDeadline - Clock::now()).count();
+        if (remaining > 0)
+        {
+            char recvBuffer[Constants::BUFFER_SIZE];
+            struct sockaddr_in senderAddr;
+            int bytesReceived = 0; // Stays 0 if the receive times out
+            Clock::time_point waitStart;
+            if (timed)
+            {
+                waitStart = Clock::now();
+            }
+
+            try
+            {
+                socket.setReceiveTimeoutMillis(static_cast<int>(remaining));
+                bytesReceived = socket.receiveDataFrom(recvBuffer, senderAddr);
+                Clock::time_point receivedAt;
+                if (timed)
+                {
+                    receivedAt = Clock::now();
+                }
+
+                std::shared_ptr<RequestMessage> reply = decodeMessage(recvBuffer, bytesReceived);
+
+                auto match = inFlight.find(reply->getRequestID());
+                if (reply->getRequestID() == 0)
+                {
+                    if (pushHandler)
+                    {
+                        pushHandler(*reply);
+                    }
+                }
+                else if (match != inFlight.end())
+                {
+                    size_t index = match->second;
+                    if (attempts[index].transmissions == 1)
+                    {
+                        rttEstimator.addSample(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - attempts[index].sentAt));
+                    }
+
+                    if (timed)
+                    {
+                        recordPhase(requests[index].getRequestType(), reply->getRequestID(), ClientStats::WAIT, attempts[index].sentAt, receivedAt);
+                        recordPhase(requests[index].getRequestType(), reply->getRequestID(), ClientStats::DECODE, receivedAt, Clock::now());
+                    }
+                    endAttempt(index, ClientStats::SUCCESS);
+
+                    inFlight.erase(match);
+                    finish(index, reply->getData(), true);
+
+                    pipelineWindow = std::min<double>(pipelineWindow + 1 / pipelineWindow, Constants::PIPELINE_MAX_WINDOW);
+                }
+                else
+                {
+                    // A duplicate reply to a retransmitted request, which is dropped
+                    recordStray(ClientStats::ID_MISMATCH, waitStart);
+                }
+            }
+            catch (const std::exception &e)
+            {
+                // Timeouts are handled below, corrupted datagrams are skipped
+                if (std::string(e.what()).find("Timeout") == std::string::npos)
+                {
+                    std::cerr << e.what() << std::endl;
+                    if (bytesReceived > 0)
+                    {
+                        recordStray(classifyUndecodable(recvBuffer, bytesReceived), waitStart);
+                    }
+                }
+            }
+        }
+
+        // Retransmit only the requests whose timeout expired
+        Clock::time_point now = Clock::now();
+        for (auto it = inFlight.begin(); it != inFlight.end();)
+        {
+            size_t index = it->second;
+            if (attempts[index].deadline > now)
+            {
+                ++it;
+                continue;
+            }
+
+            endAttempt(index, ClientStats::TIMEOUT);
+
+            if (index >= recoveryPoint)
+            {
+                pipelineWindow = std::max(pipelineWindow / 2, 1.0);
+                recoveryPoint = nextToSend;
+            }
+
+            if (attempts[index].transmissions >= Constants::MAX_RETRIES)
+            {
+                it = inFlight.erase(it);
+                finish(index, Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE, false);
+                continue;
+            }
+
+            std::cerr << "No response received for request ID " << it->first << ". Retrying... ("
+                      << attempts[index].transmissions << "/" << Constants::MAX_RETRIES << ")" << std::endl;
+            transmit(index);
+            ++it;
+        }
+    }
+
+    socket.setReceiveTimeout(Constants::TIMEOUT_SEC);
+
+    return results;
+}
+
+/**
+ * @brief Gets the current pipelining window.
+ * 
+ * @return The number of requests submitPipelined() may currently keep in flight.
+ */
+int Client::getPipelineWindow() const
+{
+    return static_cast<int>(pipelineWindow);
+}
+
+/**
+ * @brief Queues a request to be sent together with others in a batch.
+ * 
+ * The request joins the open batch. If it does not fit within BATCH_MTU, the open batch is sent first.
+ * Once the open batch has waited for the linger time, it is sent without waiting for more requests.
+ * Sending a batch blocks until its reply arrives or the retries are used up.
+ * If journaling is on, a non-idempotent request is journaled here, before its batch is sent, and can be
+ * resent alone by replayJournal().
+ * 
+ * @param request The request to queue. Its request ID and identity are assigned by the client.
+ * 
+ * @return The index of the request's reply in the result of flushBatched().
+ */
+size_t Client::queueBatched(RequestMessage request)
+{
+    request.setRequestID(requestID++);
+    request.setIdentity(identitySource.next());
+    request.setAckedSequence(identitySource.getAckedSequence());
+    journalRequest(request);
+
+    if (!batchPacker.add(request))
+    {
+        sendBatch();
+        batchPacker.add(request);
+    }
+
+    size_t ticket = batchResults.size();
+    batchResults.emplace_back();
+    batchTickets[request.getRequestID()] = ticket;
+
+    if (batchPacker.isReady(std::chrono::steady_clock::now()))
+    {
+        sendBatch();
+    }
+
+    return ticket;
+}
+
+/**
+ * @brief Sends any open batch and returns the replies to all requests queued since the last flush.
+ * 
+ * @return The reply data of each queued request in queue order, or an error message for requests that failed.
+ */
+std::vector<std::string> Client::flushBatched()
+{
+    if (!batchPacker.empty())
+    {
+        sendBatch();
+    }
+
+    std::vector<std::string> results;
+    results.swap(batchResults);
+    batchTickets.clear();
+
+    return results;
+}
+
+/**
+ * @brief Sends requests packed into as few datagrams as possible and collects their replies.
+ * 
+ * Consecutive requests share a datagram for as long as the batch stays within BATCH_MTU.
+ * Requests queued with queueBatched() and not yet flushed are sent as well, and their replies are discarded.
+ * 
+ * @param requests The requests to send. Their request IDs and identities are assigned by the client.
+ * 
+ * @return The reply data of each request in submission order, or an error message for requests that failed.
+ */
+std::vector<std::string> Client::submitBatched(const std::vector<RequestMessage> &requests)
+{
+    flushBatched();
+
+    for (const RequestMessage &request : requests)
+    {
+        queueBatched(request);
+    }
+
+    return flushBatched();
+}
+
+/**
+ * @brief Sets the time a batch waits for more requests after its first request.
+ * 
+ * @param linger The linger time.
+ */
+void Client::setBatchLinger(std::chrono::microseconds linger)
+{
+    batchPacker.setLinger(linger);
+}
+
+/**
+ * @brief Resends the journaled requests that had not completed when the previous run of the client ended.
+ * 
+ * The requests are resent one by one in the order they were first sent, each with its original request ID.
+ * New requests then continue above the highest of these IDs, so that a late reply to a resent request cannot
+ * be mistaken for the reply to a new one. Does nothing if journaling is off.
+ * 
+ * @return The reply data of each resent request in the order they were first sent, or an error message for requests that failed.
+ */
+std::vector<std::string> Client::replayJournal()
+{
+    std::vector<std::string> responses;
+    if (!journal)
+    {
+        return responses;
+    }
+
+    for (const RequestJournal::Entry &entry : journal->getPending())
+    {
+        responses.push_back(resendJournaled(entry));
+        requestID = std::max(requestID, entry.requestID + 1);
+    }
+
+    return responses;
+}
+
+/**
+ * @brief Starts collecting latency and attempt statistics of the operations, including pipelined and batched ones.
+ *
+ * Until this is called, the only cost of the instrumentation is a null check per phase. Statistics already
+ * collected are kept if it is called again.
+ */
+void Client::enableStats()
+{
+    if (!stats)
+    {
+        stats = std::make_unique<ClientStats>();
+    }
+}
+
+/**
+ * @brief Gets the collected statistics.
+ *
+ * Callers may record phases they time themselves, such as parsing the reply, and take snapshots.
+ *
+ * @return The statistics, or null if they are not collected.
+ */
+ClientStats *Client::getStats()
+{
+    return stats.get();
+}
+
+/**
+ * @brief Starts tracing the lifecycle of the operations, including pipelined and batched ones.
+ *
+ * Each operation is traced as spans for the construction of its request, the whole operation, each attempt,
+ * and the serialize, send, wait and decode phases of each attempt, with timeouts and other failed attempts
+ * named after their outcome. Until this is called, tracing costs a null check per phase.
+ */
+void Client::enableTracing()
+{
+    if (!tracer)
+    {
+        tracer = std::make_unique<Tracer>();
+    }
+}
+
+/**
+ * @brief Gets the tracer.
+ *
+ * Callers may record spans of their own, such as parsing the reply, and write the trace file.
+ *
+ * @return The tracer, or null if tracing is off.
+ */
+Tracer *Client::getTracer()
+{
+    return tracer.get();
+}
+
+/**
+ * @brief Starts checking bookings against the availability last received from the server.
+ *
+ * From then on, replies to availability queries and monitoring updates are cached, and bookFacility() rejects
+ * bookings that fresh cached availability shows cannot succeed. Cached days older than maxAge are not trusted,
+ * so the bound trades the round trips saved against the chance of rejecting a range freed in the meantime.
+ *
+ * @param maxAge The maximum age of cached availability that may reject a booking.
+ */
+void Client::enableBookingPrecheck(std::chrono::milliseconds maxAge)
+{
+    bookingPrecheck = true;
+    precheckMaxAge = maxAge;
+}
+
+/**
+ * @brief Stops checking bookings against cached availability and forgets it.
+ */
+void Client::disableBookingPrecheck()
+{
+    bookingPrecheck = false;
+    availabilityCache.clear();
+}
+
+/**
+ * @brief Gets the number of bookings rejected by the pre-check.
+ *
+ * @return The number of bookings rejected without contacting the server.
+ */
+int64_t Client::getPrecheckRejections() const
+{
+    return precheckRejections;
+}
+
+/**
+ * @brief Starts keeping recently parsed availability replies, so that identical replies are not parsed again.
+ *
+ * Repeated queries and monitoring updates of the same facility often return the same text, which is then parsed
+ * once for the booking pre-check and for every caller of parseAvailability(). Calling this again keeps the
+ * existing table.
+ *
+ * @param capacity The maximum number of replies kept.
+ */
+void Client::enableParseMemo(size_t capacity)
+{
+    if (!parseMemo)
+    {
+        parseMemo = std::make_unique<ParseMemo>(capacity);
+    }
+}
+
+/**
+ * @brief Gets the table of parsed availability replies.
+ *
+ * Callers may read its hit and miss counters, e.g. to export them with a MetricsExporter.
+ *
+ * @return The table, or null if parses are not memoized.
+ */
+ParseMemo *Client::getParseMemo()
+{
+    return parseMemo.get();
+}
+
+/**
+ * @brief Parses an availability reply or monitoring update, through the parse memo if it is enabled.
+ *
+ * @param response The raw server response.
+ * @param dayMask The days to parse, with the bit of each day set.
+ *
+ * @return The availability of the listed days of the mask or the error.
+ */
+std::shared_ptr<const ResponseParser::Availability> Client::parseAvailability(std::string_view response, uint8_t dayMask)
+{
+    if (parseMemo)
+    {
+        return parseMemo->parseQueryAvailabilityResponse(response, dayMask);
+    }
+    return std::make_shared<const ResponseParser::Availability>(ResponseParser::parseQueryAvailabilityResponse(response, dayMask));
+}
+
 /**
  * @brief Rates a facility.
  * 
@@ -270,9 +904,11 @@ void Client::monitorAvailability(
  */
 std::string Client::rateFacility(std::string facilityName, float rating)
 {
-    std::string messageData = "rating," + facilityName + "," + std::to_string(rating); // Request to rate the facility with the specified name and rating
-
-    RequestMessage requestMessage(RequestMessage::UPDATE, requestID, messageData); // UPDATE operation
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::rateFacility(facilityName, rating);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
     return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
@@ -288,11 +924,13 @@ std::string Client::rateFacility(std::string facilityName, float rating)
  */
 std::string Client::queryRating(std::string facilityName)
 {
-    std::string messageData = "rating," + facilityName;
-
-    RequestMessage requestMessage(RequestMessage::READ, requestID, messageData);
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::queryRating(facilityName);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
-    return sendWithRetry(requestMessage);
+    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
 
 /**
@@ -306,9 +944,13 @@ std::string Client::queryRating(std::string facilityName)
  */
 std::string Client::echoMessage(std::string messageData)
 {
-    RequestMessage requestMessage(RequestMessage::ECHO, requestID, messageData);
+    Tracer::Span construction(tracer.get(), "construct", requestID);
+    RequestMessage requestMessage = RequestFactory::echoMessage(messageData);
+    requestMessage.setRequestID(requestID);
+    requestMessage.setIdentity(identitySource.next());
+    construction.end(requestMessage.getRequestType());
 
-    return sendWithRetry(requestMessage);
+    return sendWithRetry(requestMessage); // Send the request with retry (in case of timeout)
 }
 
 /**
@@ -329,7 +971,7 @@ void Client::makeLocalSocketAddress(struct sockaddr_in *sa)
  * @brief Creates a remote socket address from a hostname and port.
  * 
  * This method initializes the remote socket address structure with the specified hostname and port.
- * It first tries to convert the hostname to an IP address. If that fails, it resolves the hostname using gethostbyname.
+ * The hostname is resolved by Socket::resolveAddress(), and the client exits if it cannot be resolved.
  * This is necessary for the client to be able to communicate with the server.
  * 
  * @param sa Pointer to the sockaddr_in structure to initialize.
@@ -338,22 +980,14 @@ void Client::makeLocalSocketAddress(struct sockaddr_in *sa)
  */
 void Client::makeRemoteSocketAddress(struct sockaddr_in *sa, char *hostname, int port)
 {
-    sa->sin_family = AF_INET;
-    sa->sin_port = htons(port);
-
-    // Try to convert IP address directly
-    sa->sin_addr.s_addr = inet_addr(hostname);
-
-    // If not an IP address, try to resolve hostname
-    if (sa->sin_addr.s_addr == INADDR_NONE)
+    try
     {
-        struct hostent *host;
-        if ((host = gethostbyname(hostname)) == NULL)
-        {
-            std::cerr << "Unknown host" << std::endl;
-            exit(-1);
-        }
-        memcpy(&(sa->sin_addr), host->h_addr, host->h_length);
+        *sa = Socket::resolveAddress(hostname, port);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Unknown host" << std::endl;
+        exit(-1);
     }
 }
 
@@ -361,22 +995,34 @@ void Client::makeRemoteSocketAddress(struct sockaddr_in *sa, char *hostname, int
  * @brief Sends a request message to the server.
  * 
  * This method serializes the request message and sends it to the server.
- * It increments the request ID for each new request.
+ * Every transmission carries the latest acknowledged watermark, so that the server can drop its cached replies
+ * to requests that have completed.
  * 
  * @param request The request message to send.
- * @param retry Whether this is a retry attempt.
- * 
- * @note The retry flag is used to determine whether to increment the request ID or not.
+ * @param retry Whether this is a retry attempt, which is counted as a retry in the statistics.
  */
-void Client::sendRequest(const RequestMessage &request, bool retry)
+void Client::sendRequest(RequestMessage &request, bool retry)
 {
-    if (!retry)
+    request.setAckedSequence(identitySource.getAckedSequence());
+
+    bool timed = stats || tracer;
+    ClientStats::Clock::time_point serializeStart, sendStart;
+    if (timed)
+    {
+        serializeStart = ClientStats::Clock::now();
+    }
+    if (stats && retry)
     {
-        requestID++;
+        stats->recordRetry(request.getRequestType());
     }
 
     std::vector<uint8_t> serializedData = JavaSerializer::serialize(&request);
 
+    if (timed)
+    {
+        sendStart = ClientStats::Clock::now();
+    }
+
     try
     {
         socket.sendDataTo(serializedData, serverAddr);
@@ -386,6 +1032,12 @@ void Client::sendRequest(const RequestMessage &request, bool retry)
         std::cerr << "Error sending data: " << e.what() << std::endl;
         exit(1);
     }
+
+    if (timed)
+    {
+        recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::SERIALIZE, serializeStart, sendStart);
+        recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::SEND, sendStart, ClientStats::Clock::now());
+    }
 }
 
 /**
@@ -393,173 +1045,550 @@ void Client::sendRequest(const RequestMessage &request, bool retry)
  * 
  * This method receives a response from the server, deserializes it, and checks if the request ID matches the expected one.
  * If it doesn't match, it returns an empty string to trigger a retry.
+ * Monitoring updates (request ID 0) received in the meantime are passed to the push handler, if any, and do not end the wait.
+ * If statistics are collected, the outcome of the attempt is counted, and the wait and decode phases of the reply are recorded.
+ * If tracing is on, the same phases are traced, or a span named after the outcome if the attempt failed.
  * 
  * @param expectedRequestID The expected request ID for the response.
+ * @param requestType The request type to record statistics under, or -1 to not record any.
  * 
  * @return A string containing the response message from the server or error message.
  */
-std::string Client::receiveResponse(uint32_t expectedRequestID)
+std::string Client::receiveResponse(uint32_t expectedRequestID, int requestType)
 {
     char recvBuffer[Constants::BUFFER_SIZE];
     struct sockaddr_in senderAddr;
     std::string messageData;
+    int bytesReceived = 0;
+
+    bool timed = stats || tracer;
+    ClientStats::Clock::time_point waitStart, receivedAt, decodedAt;
+    if (timed)
+    {
+        waitStart = ClientStats::Clock::now();
+    }
 
+    ClientStats::Outcome outcome = ClientStats::SUCCESS;
     try
     {
-        int bytesReceived = socket.receiveDataFrom(recvBuffer, senderAddr);
+        std::shared_ptr<RequestMessage> responseMessage;
+
+        // Monitoring updates may arrive while waiting for the reply, hand them over and keep waiting
+        do
+        {
+            bytesReceived = 0; // Stays 0 if the receive times out
+            bytesReceived = socket.receiveDataFrom(recvBuffer, senderAddr);
+            if (timed)
+            {
+                receivedAt = ClientStats::Clock::now();
+            }
 
-        // Deserialize response
-        std::vector<uint8_t> receivedData(recvBuffer, recvBuffer + bytesReceived);
-        std::shared_ptr<JavaSerializable> deserializedObj = JavaDeserializer::deserialize(receivedData);
+            responseMessage = decodeMessage(recvBuffer, bytesReceived);
+            if (timed)
+            {
+                decodedAt = ClientStats::Clock::now();
+            }
 
-        std::shared_ptr<RequestMessage> responseMessage = std::dynamic_pointer_cast<RequestMessage>(deserializedObj);
+            if (responseMessage->getRequestID() == 0 && expectedRequestID != 0 && pushHandler)
+            {
+                pushHandler(*responseMessage);
+            }
+        } while (responseMessage->getRequestID() == 0 && expectedRequestID != 0);
         
         // Verify the response matches our request ID
         if (responseMessage->getRequestID() != expectedRequestID) {
             std::cerr << "Received response for request ID " 
                       << responseMessage->getRequestID() 
                       << " but expected " << expectedRequestID << std::endl;
-            return ""; // Return empty string to trigger retry
+            outcome = ClientStats::ID_MISMATCH; // Leave the data empty to trigger a retry
+        }
+        else
+        {
+            messageData = responseMessage->getData();
         }
-        
-        messageData = responseMessage->getData();
     }
     catch(const std::exception& e)
     {
         std::cerr << e.what() << std::endl;
+        outcome = bytesReceived > 0 ? classifyUndecodable(recvBuffer, bytesReceived) : ClientStats::TIMEOUT;
+    }
+
+    if (outcome == ClientStats::SUCCESS && timed)
+    {
+        recordPhase(requestType, expectedRequestID, ClientStats::WAIT, waitStart, receivedAt);
+        recordPhase(requestType, expectedRequestID, ClientStats::DECODE, receivedAt, decodedAt);
+    }
+    else if (tracer)
+    {
+        tracer->record(ClientStats::getOutcomeName(outcome), waitStart, ClientStats::Clock::now(), expectedRequestID, requestType);
+    }
+
+    if (stats)
+    {
+        stats->recordAttempt(requestType, outcome);
     }
 
     return messageData;
 }
 
+/**
+ * @brief Records a timed phase into the statistics and the trace, whichever are on.
+ * 
+ * The phase is traced as a span named after the phase.
+ * 
+ * @param requestType The request type of the operation.
+ * @param requestID The request ID of the operation.
+ * @param phase The phase.
+ * @param start The start of the phase.
+ * @param end The end of the phase.
+ */
+void Client::recordPhase(int requestType, int64_t requestID, ClientStats::Phase phase, ClientStats::Clock::time_point start, ClientStats::Clock::time_point end)
+{
+    if (stats)
+    {
+        stats->recordPhase(requestType, phase, end - start);
+    }
+    if (tracer)
+    {
+        tracer->record(ClientStats::getPhaseName(phase), start, end, requestID, requestType);
+    }
+}
+
+/**
+ * @brief Classifies a datagram that could not be decoded.
+ * 
+ * The parity check is repeated on the datagram, as the deserializer reports every failure the same way.
+ * This is only done for failed datagrams, so decoding does not pay for it.
+ * 
+ * @param data The received bytes.
+ * @param length The number of bytes received.
+ * 
+ * @return PARITY_FAILURE if the parity check fails, DECODE_FAILURE otherwise.
+ */
+ClientStats::Outcome Client::classifyUndecodable(const char *data, int length)
+{
+    std::vector<uint8_t> serializedData(data, data + length - 1);
+    uint8_t parityBit = static_cast<uint8_t>(data[length - 1]);
+    return Parity::verifyEvenParity(serializedData, parityBit) ? ClientStats::DECODE_FAILURE : ClientStats::PARITY_FAILURE;
+}
+
+/**
+ * @brief Deserializes a datagram received from the server.
+ * 
+ * The datagram is parity-checked and deserialized by JavaDeserializer, and must contain a RequestMessage.
+ * 
+ * @param data The received bytes.
+ * @param length The number of bytes received.
+ * 
+ * @return The decoded request message.
+ * 
+ * @throws std::runtime_error if the datagram cannot be decoded into a RequestMessage.
+ */
+std::shared_ptr<RequestMessage> Client::decodeMessage(const char *data, int length)
+{
+    std::vector<uint8_t> receivedData(data, data + length);
+    std::shared_ptr<JavaSerializable> deserializedObj = JavaDeserializer::deserialize(receivedData);
+
+    std::shared_ptr<RequestMessage> message = std::dynamic_pointer_cast<RequestMessage>(deserializedObj);
+    if (!message)
+    {
+        throw std::runtime_error("Received datagram is not a RequestMessage");
+    }
+
+    return message;
+}
+
+/**
+ * @brief Sends the open batch with retries and stores the replies in batchResults.
+ * 
+ * The whole batch is retransmitted until a BatchMessage with the same batch ID arrives.
+ * The server filters duplicates per request, so requests it already executed are answered from its history.
+ * Monitoring updates received in the meantime are passed to the push handler, and other datagrams are discarded.
+ * If no reply arrives after MAX_RETRIES attempts, every request of the batch gets an error message.
+ * 
+ * Each request of the batch is a separate operation in the statistics and the trace, from the first
+ * transmission of the batch until its reply, and shares the phases and attempts of the batch. Datagrams other
+ * than the reply are counted against the first request of the batch.
+ */
+void Client::sendBatch()
+{
+    BatchMessage batch = batchPacker.take(requestID++);
+    const std::vector<RequestMessage> &members = batch.getRequests();
+    std::vector<char> recvBuffer(Constants::MAX_DATAGRAM_SIZE);
+
+    bool timed = stats || tracer;
+    ClientStats::Clock::time_point operationStart, serializeStart, sendStart, sentAt, receivedAt;
+    if (timed)
+    {
+        operationStart = serializeStart = ClientStats::Clock::now();
+    }
+    if (stats)
+    {
+        for (const RequestMessage &request : members)
+        {
+            stats->beginOperation(request.getRequestType());
+        }
+    }
+
+    std::vector<uint8_t> serializedData = JavaSerializer::serialize(&batch);
+
+    // Ends the current attempt of every request of the batch with the given outcome
+    auto endAttempt = [&](ClientStats::Outcome outcome, int attempt)
+    {
+        ClientStats::Clock::time_point now = ClientStats::Clock::now();
+        for (const RequestMessage &request : members)
+        {
+            if (stats)
+            {
+                stats->recordAttempt(request.getRequestType(), outcome);
+            }
+            if (tracer)
+            {
+                tracer->record("attempt", sentAt, now, request.getRequestID(), request.getRequestType(), attempt + 1);
+                if (outcome != ClientStats::SUCCESS)
+                {
+                    tracer->record(ClientStats::getOutcomeName(outcome), sentAt, now, request.getRequestID(), request.getRequestType());
+                }
+            }
+        }
+    };
+
+    // Counts a datagram other than the reply against the first request of the batch
+    auto recordStray = [&](ClientStats::Outcome outcome)
+    {
+        if (stats)
+        {
+            stats->recordAttempt(members.front().getRequestType(), outcome);
+        }
+        if (tracer)
+        {
+            tracer->record(ClientStats::getOutcomeName(outcome), sentAt, ClientStats::Clock::now(), members.front().getRequestID(), members.front().getRequestType());
+        }
+    };
+
+    // Records the end of every request of the batch
+    auto endOperations = [&](bool succeeded)
+    {
+        ClientStats::Clock::time_point now = ClientStats::Clock::now();
+        for (const RequestMessage &request : members)
+        {
+            if (stats)
+            {
+                stats->recordOperation(request.getRequestType(), succeeded, now - operationStart);
+            }
+            if (tracer)
+            {
+                tracer->record("operation", operationStart, now, request.getRequestID(), request.getRequestType());
+            }
+        }
+    };
+
+    for (int attempt = 0; attempt < Constants::MAX_RETRIES; ++attempt)
+    {
+        if (timed)
+        {
+            sendStart = ClientStats::Clock::now();
+        }
+
+        try
+        {
+            socket.sendDataTo(serializedData, serverAddr);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error sending data: " << e.what() << std::endl;
+            exit(1);
+        }
+
+        if (timed)
+        {
+            sentAt = ClientStats::Clock::now();
+            for (const RequestMessage &request : members)
+            {
+                if (attempt == 0)
+                {
+                    recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::SERIALIZE, serializeStart, sendStart);
+                }
+                else if (stats)
+                {
+                    stats->recordRetry(request.getRequestType());
+                }
+                recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::SEND, sendStart, sentAt);
+            }
+        }
+
+        while (true)
+        {
+            struct sockaddr_in senderAddr;
+            std::shared_ptr<JavaSerializable> message;
+            int bytesReceived = 0; // Stays 0 if the receive times out
+
+            try
+            {
+                bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+                if (timed)
+                {
+                    receivedAt = ClientStats::Clock::now();
+                }
+                message = JavaDeserializer::deserialize(std::vector<uint8_t>(recvBuffer.begin(), recvBuffer.begin() + bytesReceived));
+            }
+            catch (const std::exception &e)
+            {
+                // Timeouts trigger a retransmission, corrupted datagrams are skipped
+                if (std::string(e.what()).find("Timeout") != std::string::npos)
+                {
+                    break;
+                }
+                std::cerr << e.what() << std::endl;
+                if (bytesReceived > 0)
+                {
+                    recordStray(classifyUndecodable(recvBuffer.data(), bytesReceived));
+                }
+                continue;
+            }
+
+            std::shared_ptr<BatchMessage> reply = std::dynamic_pointer_cast<BatchMessage>(message);
+            if (reply && reply->getBatchID() == batch.getBatchID())
+            {
+                if (timed)
+                {
+                    ClientStats::Clock::time_point decodedAt = ClientStats::Clock::now();
+                    for (const RequestMessage &request : members)
+                    {
+                        recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::WAIT, sentAt, receivedAt);
+                        recordPhase(request.getRequestType(), request.getRequestID(), ClientStats::DECODE, receivedAt, decodedAt);
+                    }
+                }
+                endAttempt(ClientStats::SUCCESS, attempt);
+
+                for (const RequestMessage &response : reply->getRequests())
+                {
+                    auto ticket = batchTickets.find(response.getRequestID());
+                    if (ticket != batchTickets.end())
+                    {
+                        batchResults[ticket->second] = response.getData();
+                    }
+                }
+                for (const RequestMessage &request : members)
+                {
+                    identitySource.complete(request.getIdentity().sequence);
+                    completeJournaled(request);
+                }
+                endOperations(true);
+                return;
+            }
+
+            std::shared_ptr<RequestMessage> push = std::dynamic_pointer_cast<RequestMessage>(message);
+            if (push && push->getRequestID() == 0)
+            {
+                if (pushHandler)
+                {
+                    pushHandler(*push);
+                }
+            }
+            else
+            {
+                recordStray(ClientStats::ID_MISMATCH);
+            }
+        }
+
+        endAttempt(ClientStats::TIMEOUT, attempt);
+        std::cerr << "No response received for batch " << batch.getBatchID() << ". Retrying... ("
+                  << (attempt + 1) << "/" << Constants::MAX_RETRIES << ")" << std::endl;
+    }
+
+    for (const RequestMessage &request : members)
+    {
+        batchResults[batchTickets[request.getRequestID()]] = Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE;
+        identitySource.complete(request.getIdentity().sequence);
+        completeJournaled(request);
+    }
+    endOperations(false);
+}
+
 /**
  * @brief Sends a request to the server with retries.
  * 
  * This method attempts to send a request to the server multiple times in case of timeouts or no response.
  * It uses a maximum number of retries defined by MAX_RETRIES in Constants.hpp.
+ * Once the request is answered or given up, it is marked complete so that later requests acknowledge it.
+ * If journaling is on, non-idempotent requests are journaled before they are first sent and marked complete
+ * in the journal as well. A request that cannot be journaled is still sent.
+ * If statistics are collected, the operation and its total duration over all attempts are recorded, and if
+ * tracing is on, the operation and each of its attempts are traced as spans.
  * 
- * @param request The request message to send.
+ * @param request The request message to send, built with the current request ID, which is used up here.
  * 
  * @return A string containing the response message from the server or error message.
  */
-std::string Client::sendWithRetry(const RequestMessage &request)
+std::string Client::sendWithRetry(RequestMessage &request)
 {
+    requestID++;
+
+    ClientStats::Clock::time_point operationStart;
+    if (stats)
+    {
+        operationStart = ClientStats::Clock::now();
+        stats->beginOperation(request.getRequestType());
+    }
+
+    Tracer::Span operation(tracer.get(), "operation", request.getRequestID(), request.getRequestType());
+
+    journalRequest(request);
+
     for (int attempt = 0; attempt < Constants::MAX_RETRIES; ++attempt)
     {
+        Tracer::Span attemptSpan(tracer.get(), "attempt", request.getRequestID(), request.getRequestType(), attempt + 1);
         sendRequest(request, attempt > 0); // Retry flag is false for first attempt and true for subsequent attempts
 
         // std::string response = receiveResponse();
-        std::string response = receiveResponse(request.getRequestID());
+        std::string response = receiveResponse(request.getRequestID(), request.getRequestType());
 
         if (!response.empty())
         {
+            identitySource.complete(request.getIdentity().sequence);
+            completeJournaled(request);
+            if (stats)
+            {
+                stats->recordOperation(request.getRequestType(), true, ClientStats::Clock::now() - operationStart);
+            }
             return response;
         }
 
         std::cerr << "No response received. Retrying... (" << (attempt + 1) << "/" << Constants::MAX_RETRIES << ")" << std::endl;
     }
 
-    return Constants::STATUS_ERROR + "\nmessage:Request failed after " + std::to_string(Constants::MAX_RETRIES) + " attempts.";
+    identitySource.complete(request.getIdentity().sequence);
+    completeJournaled(request);
+    if (stats)
+    {
+        stats->recordOperation(request.getRequestType(), false, ClientStats::Clock::now() - operationStart);
+    }
+
+    return Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE;
 }
 
 /**
- * @brief Extracts the facility name from the booking details string.
+ * @brief Resends a journaled request with its original bytes and request ID until it is answered.
  * 
- * This method searches for the facility name in the booking details string.
- * It looks for the prefix "facility:" and extracts the name that follows it.
+ * The bytes carry the request's original identity, so the server replies from its history if the previous
+ * run's transmission was already applied. The request is marked complete in the journal once it is answered
+ * or given up.
  * 
- * @param bookingDetails The booking details string.
+ * @param entry The journaled request.
  * 
- * @return The extracted facility name.
+ * @return A string containing the response message from the server or error message.
  */
-std::string Client::extractFacilityName(const std::string &bookingDetails)
+std::string Client::resendJournaled(const RequestJournal::Entry &entry)
 {
-    const std::string facilityPrefix = "facility:";
-    size_t pos = bookingDetails.find(facilityPrefix);
-
-    if (pos != std::string::npos)
+    for (int attempt = 0; attempt < Constants::MAX_RETRIES; ++attempt)
     {
-        size_t start = pos + facilityPrefix.length();
-        size_t end = bookingDetails.find('\n', start);
-        return bookingDetails.substr(start, end - start);
+        try
+        {
+            socket.sendDataTo(entry.data, serverAddr);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error sending data: " << e.what() << std::endl;
+            exit(1);
+        }
+
+        std::string response = receiveResponse(entry.requestID);
+
+        if (!response.empty())
+        {
+            journal->complete(entry.identity);
+            return response;
+        }
+
+        std::cerr << "No response received. Retrying... (" << (attempt + 1) << "/" << Constants::MAX_RETRIES << ")" << std::endl;
     }
 
-    return "";
+    journal->complete(entry.identity);
+
+    return Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE;
 }
 
 /**
- * @brief Extracts the day of the week from the booking details string.
- * 
- * This method searches for the day of the week in the booking details string.
- * It looks for the prefix "day:" and extracts the name that follows it.
+ * @brief Opens the request journal, exiting if it cannot be opened.
  * 
- * @param bookingDetails The booking details string.
+ * @param journalPath The path of the journal, or an empty string.
  * 
- * @return The extracted day of the week.
+ * @return The journal, or null if the path is empty.
  */
-std::string Client::extractDayOfWeek(const std::string &bookingDetails)
+std::unique_ptr<RequestJournal> Client::openJournal(const std::string &journalPath)
 {
-    const std::string dayPrefix = "day:";
-    size_t pos = bookingDetails.find(dayPrefix);
+    if (journalPath.empty())
+    {
+        return nullptr;
+    }
 
-    if (pos != std::string::npos)
+    try
+    {
+        return std::make_unique<RequestJournal>(journalPath);
+    }
+    catch (const std::runtime_error &e)
     {
-        size_t start = pos + dayPrefix.length();
-        size_t end = bookingDetails.find('\n', start);
-        return bookingDetails.substr(start, end - start);
+        std::cerr << e.what() << std::endl;
+        exit(1);
     }
+}
 
-    return "";
+/**
+ * @brief Checks whether a request must be journaled, i.e. whether resending it could apply it twice.
+ * 
+ * @param request The request.
+ * 
+ * @return True for bookings, updates, ratings and deletions.
+ */
+bool Client::needsJournal(const RequestMessage &request)
+{
+    int type = request.getRequestType();
+    return type == RequestMessage::WRITE || type == RequestMessage::UPDATE || type == RequestMessage::DELETE_REQUEST;
 }
 
 /**
- * @brief Extracts the start time from the booking details string.
+ * @brief Journals a request before it is first sent, if journaling is on and the request needs it.
  * 
- * This method searches for the start time in the booking details string.
- * It looks for the prefix "startTime:" and extracts the time that follows it.
+ * The journal holds the request as it would be sent on its own, so replayJournal() can resend it alone even
+ * if it was first sent in a batch. A request that cannot be journaled is still sent.
  * 
- * @param bookingDetails The booking details string.
+ * @param request The request, with its request ID and identity assigned. Its acknowledged sequence is set.
  * 
- * @return The extracted start time in HHMM format.
+ * @return True if the request was journaled.
  */
-std::string Client::extractStartTime(const std::string &bookingDetails)
+bool Client::journalRequest(RequestMessage &request)
 {
-    const std::string startTimePrefix = "startTime:";
-    size_t pos = bookingDetails.find(startTimePrefix);
-
-    if (pos != std::string::npos)
+    if (!journal || !needsJournal(request))
     {
-        size_t start = pos + startTimePrefix.length();
-        size_t end = bookingDetails.find('\n', start);
-        return bookingDetails.substr(start, end - start);
+        return false;
     }
 
-    return "";
+    request.setAckedSequence(identitySource.getAckedSequence());
+
+    try
+    {
+        journal->append(request.getRequestID(), request.getIdentity(), JavaSerializer::serialize(&request));
+        return true;
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << "Error journaling request: " << e.what() << std::endl;
+        return false;
+    }
 }
 
 /**
- * @brief Extracts the end time from the booking details string.
+ * @brief Marks a request complete in the journal, if it was journaled.
  * 
- * This method searches for the end time in the booking details string.
- * It looks for the prefix "endTime:" and extracts the time that follows it.
- * 
- * @param bookingDetails The booking details string.
- * 
- * @return The extracted end time in HHMM format.
+ * @param request The request.
  */
-std::string Client::extractEndTime(const std::string &bookingDetails)
+void Client::completeJournaled(const RequestMessage &request)
 {
-    const std::string endTimePrefix = "endTime:";
-    size_t pos = bookingDetails.find(endTimePrefix);
-
-    if (pos != std::string::npos)
+    if (journal)
     {
-        size_t start = pos + endTimePrefix.length();
-        size_t end = bookingDetails.find('\n', start);
-        return bookingDetails.substr(start, end - start);
+        journal->complete(request.getIdentity());
     }
-
-    return "";
 }
 
 /**
@@ -567,6 +1596,7 @@ std::string Client::extractEndTime(const std::string &bookingDetails)
  * 
  * This method listens for updates from the server during the monitoring period.
  * It uses a timeout to break out of the loop after the specified duration.
+ * Each update is deserialized and only its data string is passed to the callback.
  * 
  * @param durationSeconds The duration to monitor in seconds.
  * @param onUpdate Callback function to handle updates during monitoring.
@@ -592,14 +1622,26 @@ void Client::listenForMonitoringUpdates(
 
             if (bytesReceived > 0)
             {
-                std::string response(recvBuffer, bytesReceived);
-                onUpdate(response, false);
+                std::shared_ptr<RequestMessage> update = decodeMessage(recvBuffer, bytesReceived);
+                if (update->getRequestID() == 0)
+                {
+                    // Updates list the free periods of every day, so they refresh the whole week
+                    if (bookingPrecheck)
+                    {
+                        availabilityCache.store(*parseAvailability(update->getData()), AvailabilityCache::Clock::now());
+                    }
+                    onUpdate(update->getData(), false);
+                }
             }
         }
         catch (const std::exception &e)
         {
             // Socket timeout aligns with the duration of monitoring, hence we can safely break out of loop
-            break;
+            if (std::string(e.what()).find("Timeout") != std::string::npos)
+            {
+                break;
+            }
+            std::cerr << e.what() << std::endl; // Corrupted update, keep listening
         }
     }
 
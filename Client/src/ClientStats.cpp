@@ -0,0 +1,199 @@
+#include "ClientStats.hpp"
+
+#include <algorithm>
+
+/**
+ * @brief Constructs empty statistics.
+ *
+ * The bucket counts of all histograms are allocated up front, so that recording never allocates. With
+ * durations up to MAX_NANOSECONDS, they take about 1 MB.
+ */
+ClientStats::ClientStats()
+    : bucketCount(LatencyHistogram::bucketOf(MAX_NANOSECONDS) + 1),
+      buckets(new std::atomic<int64_t>[REQUEST_TYPE_COUNT * PHASE_COUNT * bucketCount]()),
+      operations{}, failures{}, retries{}, inFlight{}, attempts{}
+{
+}
+
+/**
+ * @brief Counts the start of an operation, which is in flight until recordOperation() is called for it.
+ *
+ * @param requestType The request type of the operation. Other values are ignored.
+ */
+void ClientStats::beginOperation(int requestType)
+{
+    if (!isTracked(requestType))
+    {
+        return;
+    }
+
+    inFlight[requestType].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts a retransmission.
+ *
+ * @param requestType The request type of the operation. Other values are ignored.
+ */
+void ClientStats::recordRetry(int requestType)
+{
+    if (!isTracked(requestType))
+    {
+        return;
+    }
+
+    retries[requestType].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Records the duration of a phase.
+ *
+ * @param requestType The request type of the operation. Other values are ignored.
+ * @param phase The phase.
+ * @param elapsed The duration.
+ */
+void ClientStats::recordPhase(int requestType, Phase phase, Clock::duration elapsed)
+{
+    if (!isTracked(requestType))
+    {
+        return;
+    }
+
+    int64_t nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    size_t bucket = LatencyHistogram::bucketOf(std::clamp<int64_t>(nanoseconds, 0, MAX_NANOSECONDS));
+    size_t index = (static_cast<size_t>(requestType) * PHASE_COUNT + phase) * bucketCount + bucket;
+    buckets[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts an attempt.
+ *
+ * @param requestType The request type of the operation. Other values are ignored.
+ * @param outcome The outcome of the attempt.
+ */
+void ClientStats::recordAttempt(int requestType, Outcome outcome)
+{
+    if (!isTracked(requestType))
+    {
+        return;
+    }
+
+    attempts[requestType * OUTCOME_COUNT + outcome].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Counts a completed operation, no longer in flight, and records its total duration.
+ *
+ * @param requestType The request type of the operation. Other values are ignored.
+ * @param succeeded Whether a reply was received.
+ * @param elapsed The duration of the operation.
+ */
+void ClientStats::recordOperation(int requestType, bool succeeded, Clock::duration elapsed)
+{
+    if (!isTracked(requestType))
+    {
+        return;
+    }
+
+    operations[requestType].fetch_add(1, std::memory_order_relaxed);
+    inFlight[requestType].fetch_sub(1, std::memory_order_relaxed);
+    if (!succeeded)
+    {
+        failures[requestType].fetch_add(1, std::memory_order_relaxed);
+    }
+    recordPhase(requestType, TOTAL, elapsed);
+}
+
+/**
+ * @brief Copies the current statistics.
+ *
+ * Each bucket is recorded into the histogram at its highest value, so minimums, maximums and means are
+ * accurate to the bucket precision of LatencyHistogram. Counters are read one by one while recording may
+ * continue, so counters of an operation in progress may be partly included.
+ *
+ * @return The statistics of each request type, indexed by request type.
+ */
+ClientStats::Snapshot ClientStats::snapshot() const
+{
+    Snapshot result;
+
+    for (int type = 0; type < REQUEST_TYPE_COUNT; ++type)
+    {
+        OperationStats &stats = result[type];
+        stats.operations = operations[type].load(std::memory_order_relaxed);
+        stats.failures = failures[type].load(std::memory_order_relaxed);
+        stats.retries = retries[type].load(std::memory_order_relaxed);
+        stats.inFlight = inFlight[type].load(std::memory_order_relaxed);
+
+        for (int outcome = 0; outcome < OUTCOME_COUNT; ++outcome)
+        {
+            stats.attempts[outcome] = attempts[type * OUTCOME_COUNT + outcome].load(std::memory_order_relaxed);
+        }
+
+        for (int phase = 0; phase < PHASE_COUNT; ++phase)
+        {
+            const std::atomic<int64_t> *counts = &buckets[(static_cast<size_t>(type) * PHASE_COUNT + phase) * bucketCount];
+            for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+            {
+                int64_t count = counts[bucket].load(std::memory_order_relaxed);
+                if (count > 0)
+                {
+                    stats.phases[phase].record(LatencyHistogram::highestValueOf(bucket), count);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Gets the name of a request type.
+ *
+ * @param requestType The request type.
+ *
+ * @return The name as in RequestMessage::RequestType, or "UNKNOWN".
+ */
+const char *ClientStats::getRequestTypeName(int requestType)
+{
+    static const char *const NAMES[REQUEST_TYPE_COUNT] = {"READ", "WRITE", "UPDATE", "DELETE", "MONITOR", "ECHO"};
+    return isTracked(requestType) ? NAMES[requestType] : "UNKNOWN";
+}
+
+/**
+ * @brief Gets the name of a phase.
+ *
+ * @param phase The phase.
+ *
+ * @return The name in lower case.
+ */
+const char *ClientStats::getPhaseName(Phase phase)
+{
+    static const char *const NAMES[PHASE_COUNT] = {"serialize", "send", "wait", "decode", "parse", "total"};
+    return phase >= 0 && phase < PHASE_COUNT ? NAMES[phase] : "unknown";
+}
+
+/**
+ * @brief Gets the name of an outcome.
+ *
+ * @param outcome The outcome.
+ *
+ * @return The name in lower case.
+ */
+const char *ClientStats::getOutcomeName(Outcome outcome)
+{
+    static const char *const NAMES[OUTCOME_COUNT] = {"success", "timeout", "id_mismatch", "parity_failure", "decode_failure"};
+    return outcome >= 0 && outcome < OUTCOME_COUNT ? NAMES[outcome] : "unknown";
+}
+
+/**
+ * @brief Checks whether a request type has statistics.
+ *
+ * @param requestType The request type.
+ *
+ * @return True for READ to ECHO.
+ */
+bool ClientStats::isTracked(int requestType)
+{
+    return requestType >= 0 && requestType < REQUEST_TYPE_COUNT;
+}
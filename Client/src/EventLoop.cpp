@@ -0,0 +1,339 @@
+#include "EventLoop.hpp"
+
+#include <algorithm>
+#include <iostream>
+
+#include "Constants.hpp"
+#include "Serializer.hpp"
+
+/**
+ * @brief Constructs an awaitable for a wait of the given kind.
+ *
+ * @param loop The loop that resumes the coroutine.
+ * @param kind What the coroutine waits for.
+ * @param requestID The request ID of the awaited reply, for REPLY waits.
+ * @param deadline The time at which the wait ends without a message.
+ */
+EventLoop::Awaiter::Awaiter(EventLoop &loop, WaitKind kind, int requestID, Clock::time_point deadline)
+    : loop(loop), waiter{kind, requestID, deadline, nullptr, {}, nullptr}
+{
+}
+
+/**
+ * @brief Registers the suspended coroutine with the loop.
+ *
+ * @param handle The suspended coroutine.
+ */
+void EventLoop::Awaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    waiter.handle = handle;
+    loop.addWaiter(waiter);
+}
+
+/**
+ * @brief Constructs an event loop with its own UDP socket bound to any available port.
+ *
+ * The socket keeps a receive timeout as a safeguard, although the loop only receives once poll reports a datagram.
+ *
+ * @throws std::runtime_error if the socket cannot be created or bound.
+ */
+EventLoop::EventLoop() : requestID(1), activeTasks(0), recvBuffer(Constants::MAX_DATAGRAM_SIZE)
+{
+    socket.create(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    socket.bind(0);
+    socket.setReceiveTimeout(Constants::TIMEOUT_SEC);
+}
+
+/**
+ * @brief Closes the socket.
+ *
+ * Tasks that have not finished are abandoned; run() should be called until they complete.
+ */
+EventLoop::~EventLoop()
+{
+    socket.closeSocket();
+}
+
+/**
+ * @brief Schedules a task to be started by run().
+ *
+ * Exceptions escaping the task are logged and do not stop the loop.
+ *
+ * @param task The task to run to completion.
+ */
+void EventLoop::spawn(Task<void> task)
+{
+    activeTasks++;
+    readyQueue.push_back(launch(std::move(task)).handle);
+}
+
+/**
+ * @brief Runs the loop until every spawned task has finished.
+ *
+ * Each iteration resumes all ready coroutines, then waits until a datagram arrives or the earliest deadline passes.
+ * Because ready coroutines run before the socket is read again, a coroutine that handles a message and awaits the
+ * next one never misses a datagram in between.
+ */
+void EventLoop::run()
+{
+    while (activeTasks > 0)
+    {
+        while (!readyQueue.empty())
+        {
+            std::coroutine_handle<> handle = readyQueue.front();
+            readyQueue.pop_front();
+            handle.resume();
+        }
+
+        if (activeTasks == 0)
+        {
+            break;
+        }
+
+        if (timers.empty())
+        {
+            std::cerr << "Event loop stopped with " << activeTasks << " tasks waiting on something else" << std::endl;
+            break;
+        }
+
+        auto waitMillis = std::chrono::ceil<std::chrono::milliseconds>(timers.begin()->first - Clock::now()).count();
+
+        try
+        {
+            if (socket.waitReadable(static_cast<int>(std::max<long long>(waitMillis, 0))))
+            {
+                receiveDatagrams();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl;
+        }
+
+        fireExpiredTimers();
+    }
+}
+
+/**
+ * @brief Suspends the awaiting coroutine for a duration.
+ *
+ * @param duration The time to sleep.
+ *
+ * @return An awaitable that always yields nullptr.
+ */
+EventLoop::Awaiter EventLoop::sleep(std::chrono::milliseconds duration)
+{
+    return Awaiter(*this, WaitKind::SLEEP, 0, Clock::now() + duration);
+}
+
+/**
+ * @brief Suspends the awaiting coroutine until the reply to a request arrives.
+ *
+ * @param requestID The request ID of the awaited reply.
+ * @param timeout The maximum time to wait.
+ *
+ * @return An awaitable yielding the reply, or nullptr on timeout.
+ */
+EventLoop::Awaiter EventLoop::receiveReply(int requestID, std::chrono::milliseconds timeout)
+{
+    return Awaiter(*this, WaitKind::REPLY, requestID, Clock::now() + timeout);
+}
+
+/**
+ * @brief Suspends the awaiting coroutine until the server pushes a monitoring update.
+ *
+ * Every coroutine waiting at the time receives the same update.
+ *
+ * @param timeout The maximum time to wait.
+ *
+ * @return An awaitable yielding the update, or nullptr on timeout.
+ */
+EventLoop::Awaiter EventLoop::receivePush(std::chrono::milliseconds timeout)
+{
+    return Awaiter(*this, WaitKind::PUSH, 0, Clock::now() + timeout);
+}
+
+/**
+ * @brief Sends a datagram from the loop's socket.
+ *
+ * @param data The serialized message.
+ * @param addr The destination address.
+ *
+ * @throws std::runtime_error if sending fails.
+ */
+void EventLoop::send(const std::vector<uint8_t> &data, const struct sockaddr_in &addr)
+{
+    socket.sendDataTo(data, addr);
+}
+
+/**
+ * @brief Allocates a request ID unique on the loop's socket.
+ *
+ * @return The request ID.
+ */
+int EventLoop::nextRequestID()
+{
+    return requestID++;
+}
+
+/**
+ * @brief Gets the source of the identities of the requests sent through the loop.
+ *
+ * All AsyncClients of a loop share its socket, so they also share one client nonce and acknowledged watermark.
+ *
+ * @return The identity source.
+ */
+RequestIdentitySource &EventLoop::getIdentitySource()
+{
+    return identitySource;
+}
+
+/**
+ * @brief Gets the number of spawned tasks that have not finished.
+ *
+ * @return The number of active tasks.
+ */
+size_t EventLoop::getActiveTaskCount() const
+{
+    return activeTasks;
+}
+
+/**
+ * @brief Runs a spawned task and counts it as finished afterwards.
+ *
+ * Exceptions thrown by the task are logged and end only that task, whatever their type, so the loop always
+ * sees it finish.
+ *
+ * @param task The task to run.
+ *
+ * @return The wrapping coroutine.
+ */
+EventLoop::DetachedTask EventLoop::launch(Task<void> task)
+{
+    try
+    {
+        co_await task;
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Task failed: " << e.what() << std::endl;
+    }
+    catch (...)
+    {
+        std::cerr << "Task failed with an unknown exception" << std::endl;
+    }
+
+    activeTasks--;
+}
+
+/**
+ * @brief Registers a suspended coroutine's wait with the loop.
+ *
+ * @param waiter The registration of the coroutine.
+ */
+void EventLoop::addWaiter(Waiter &waiter)
+{
+    waiter.timer = timers.emplace(waiter.deadline, &waiter);
+
+    if (waiter.kind == WaitKind::REPLY)
+    {
+        replyWaiters[waiter.requestID] = &waiter;
+    }
+    else if (waiter.kind == WaitKind::PUSH)
+    {
+        pushWaiters.push_back(&waiter);
+    }
+}
+
+/**
+ * @brief Ends a wait and queues the coroutine to be resumed.
+ *
+ * The caller removes the waiter from replyWaiters or pushWaiters; its timer is removed here.
+ *
+ * @param waiter The registration of the coroutine.
+ * @param message The message that ended the wait, or nullptr if the deadline passed.
+ */
+void EventLoop::completeWaiter(Waiter &waiter, const std::shared_ptr<RequestMessage> &message)
+{
+    timers.erase(waiter.timer);
+    waiter.message = message;
+    readyQueue.push_back(waiter.handle);
+}
+
+/**
+ * @brief Receives and routes the datagrams waiting on the socket.
+ *
+ * Replies go to the coroutine awaiting their request ID, and monitoring updates (request ID 0) to every coroutine
+ * awaiting one. Replies nobody waits for, such as duplicates of retransmitted requests, are discarded.
+ * At most EVENT_LOOP_RECEIVE_BUDGET datagrams are read per call so that expired timers are not starved under load.
+ */
+void EventLoop::receiveDatagrams()
+{
+    int budget = Constants::EVENT_LOOP_RECEIVE_BUDGET;
+
+    do
+    {
+        struct sockaddr_in senderAddr;
+        std::shared_ptr<RequestMessage> message;
+
+        try
+        {
+            int bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+            std::vector<uint8_t> receivedData(recvBuffer.begin(), recvBuffer.begin() + bytesReceived);
+            message = std::dynamic_pointer_cast<RequestMessage>(JavaDeserializer::deserialize(receivedData));
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl; // Corrupted datagram, skip it
+            continue;
+        }
+
+        if (!message)
+        {
+            continue;
+        }
+
+        if (message->getRequestID() == 0)
+        {
+            std::vector<Waiter *> waiters;
+            waiters.swap(pushWaiters);
+            for (Waiter *waiter : waiters)
+            {
+                completeWaiter(*waiter, message);
+            }
+            continue;
+        }
+
+        auto match = replyWaiters.find(message->getRequestID());
+        if (match != replyWaiters.end())
+        {
+            Waiter *waiter = match->second;
+            replyWaiters.erase(match);
+            completeWaiter(*waiter, message);
+        }
+    } while (--budget > 0 && socket.waitReadable(0));
+}
+
+/**
+ * @brief Ends the waits whose deadline has passed.
+ */
+void EventLoop::fireExpiredTimers()
+{
+    Clock::time_point now = Clock::now();
+
+    while (!timers.empty() && timers.begin()->first <= now)
+    {
+        Waiter *waiter = timers.begin()->second;
+
+        if (waiter->kind == WaitKind::REPLY)
+        {
+            replyWaiters.erase(waiter->requestID);
+        }
+        else if (waiter->kind == WaitKind::PUSH)
+        {
+            pushWaiters.erase(std::remove(pushWaiters.begin(), pushWaiters.end(), waiter), pushWaiters.end());
+        }
+
+        completeWaiter(*waiter, nullptr);
+    }
+}
@@ -0,0 +1,285 @@
+#include "FaultInjector.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Constants.hpp"
+
+/**
+ * @brief Binds the relay to a free local port and starts its thread.
+ *
+ * @param serverIp The IP address or hostname of the server.
+ * @param serverPort The port number of the server.
+ * @param toServer The impairment of requests.
+ * @param toClient The impairment of replies.
+ * @param seed The seed of the random choices.
+ *
+ * @throws std::runtime_error if the socket cannot be set up or the server address cannot be resolved.
+ */
+FaultInjector::FaultInjector(const std::string &serverIp, int serverPort, const Impairment &toServer, const Impairment &toClient, uint64_t seed)
+    : serverAddr(Socket::resolveAddress(serverIp, serverPort)), hasClient(false), impairments{toServer, toClient},
+      inLossBurst{false, false}, random(seed), nextOrder(0), counters{}, running(true)
+{
+    memset(&clientAddr, 0, sizeof(clientAddr));
+
+    socket.create(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    socket.bind(0);
+
+    relayThread = std::thread(&FaultInjector::relayLoop, this);
+}
+
+/**
+ * @brief Stops the relay thread. Datagrams still held back are discarded.
+ */
+FaultInjector::~FaultInjector()
+{
+    running.store(false);
+    if (relayThread.joinable())
+    {
+        relayThread.join();
+    }
+    socket.closeSocket();
+}
+
+/**
+ * @brief Gets the local port the client should send to instead of the server.
+ *
+ * @return The port number.
+ */
+int FaultInjector::getPort()
+{
+    struct sockaddr_in addr;
+    socket.getSocketName(reinterpret_cast<struct sockaddr *>(&addr));
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * @brief Gets the counters of a direction.
+ *
+ * @param direction The direction.
+ *
+ * @return The counters so far.
+ */
+FaultInjector::Counters FaultInjector::getCounters(Direction direction) const
+{
+    const std::atomic<int64_t> *values = &counters[static_cast<int>(direction) * COUNTER_COUNT];
+
+    Counters result;
+    result.received = values[RECEIVED].load(std::memory_order_relaxed);
+    result.dropped = values[DROPPED].load(std::memory_order_relaxed);
+    result.duplicated = values[DUPLICATED].load(std::memory_order_relaxed);
+    result.corrupted = values[CORRUPTED].load(std::memory_order_relaxed);
+    result.reordered = values[REORDERED].load(std::memory_order_relaxed);
+    return result;
+}
+
+/**
+ * @brief Orders datagrams so that the earliest is on top of a priority queue.
+ *
+ * @param other The other datagram.
+ *
+ * @return True if this datagram is delivered after the other.
+ */
+bool FaultInjector::Scheduled::operator>(const Scheduled &other) const
+{
+    return due != other.due ? due > other.due : order > other.order;
+}
+
+/**
+ * @brief Receives and forwards datagrams until the relay is destroyed.
+ *
+ * Datagrams from the server address go to the client, all others to the server. The wait for the next
+ * datagram is bounded by the delivery time of the earliest held-back datagram, so delays have a granularity
+ * of one millisecond.
+ */
+void FaultInjector::relayLoop()
+{
+    std::vector<char> recvBuffer(Constants::MAX_DATAGRAM_SIZE);
+
+    while (running.load())
+    {
+        int timeoutMillis = Constants::FAULT_POLL_INTERVAL_MS;
+        if (!pending.empty())
+        {
+            auto untilDue = std::chrono::ceil<std::chrono::milliseconds>(pending.top().due - Clock::now()).count();
+            timeoutMillis = static_cast<int>(std::clamp<int64_t>(untilDue, 0, timeoutMillis));
+        }
+
+        try
+        {
+            if (socket.waitReadable(timeoutMillis))
+            {
+                struct sockaddr_in senderAddr;
+                int bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+
+                bool fromServer = senderAddr.sin_addr.s_addr == serverAddr.sin_addr.s_addr && senderAddr.sin_port == serverAddr.sin_port;
+                if (!fromServer)
+                {
+                    clientAddr = senderAddr;
+                    hasClient = true;
+                }
+
+                if (!fromServer || hasClient)
+                {
+                    impair(fromServer ? TO_CLIENT : TO_SERVER, std::vector<uint8_t>(recvBuffer.begin(), recvBuffer.begin() + bytesReceived));
+                }
+            }
+
+            deliverDue();
+        }
+        catch (const std::runtime_error &e)
+        {
+            // An unreachable peer must not stop the relay, the datagram is simply lost
+            std::cerr << "Fault injector: " << e.what() << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Applies the impairment of a direction to a datagram and schedules the copies to deliver.
+ *
+ * A datagram is first dropped or kept, then possibly corrupted, and then delivered once or twice, each copy
+ * after its own delay and possibly held back further to be reordered.
+ *
+ * @param direction The direction of the datagram.
+ * @param data The bytes of the datagram.
+ */
+void FaultInjector::impair(Direction direction, std::vector<uint8_t> data)
+{
+    const Impairment &impairment = impairments[direction];
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+    count(direction, RECEIVED);
+    if (shouldDrop(direction))
+    {
+        count(direction, DROPPED);
+        return;
+    }
+
+    if (!data.empty() && chance(random) < impairment.corruptProbability)
+    {
+        size_t bit = std::uniform_int_distribution<size_t>(0, data.size() * 8 - 1)(random);
+        data[bit / 8] ^= static_cast<uint8_t>(1u << (bit % 8));
+        count(direction, CORRUPTED);
+    }
+
+    int copies = 1;
+    if (chance(random) < impairment.duplicateProbability)
+    {
+        copies = 2;
+        count(direction, DUPLICATED);
+    }
+
+    Clock::time_point now = Clock::now();
+    for (int copy = 0; copy < copies; ++copy)
+    {
+        Clock::duration delay = drawDelay(impairment);
+        if (chance(random) < impairment.reorderProbability)
+        {
+            delay += impairment.reorderDelay;
+            count(direction, REORDERED);
+        }
+
+        pending.push({now + delay, nextOrder++, direction, data});
+    }
+}
+
+/**
+ * @brief Decides whether to drop the next datagram of a direction.
+ *
+ * With a burst length of at most 1, each datagram is dropped independently with dropProbability. Otherwise
+ * losses follow a two-state Gilbert model: a burst starts with a probability chosen so that the long-run loss
+ * rate is dropProbability, and every datagram in a burst is dropped until the burst ends with probability
+ * 1 / lossBurstLength. Independent loss already has a mean burst of 1 / (1 - dropProbability), so shorter
+ * bursts are raised to that length, which keeps the start probability at most 1 and the loss rate right.
+ *
+ * @param direction The direction.
+ *
+ * @return True to drop it.
+ */
+bool FaultInjector::shouldDrop(Direction direction)
+{
+    const Impairment &impairment = impairments[direction];
+    if (impairment.dropProbability <= 0)
+    {
+        return false;
+    }
+    if (impairment.dropProbability >= 1)
+    {
+        return true;
+    }
+
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    if (impairment.lossBurstLength <= 1)
+    {
+        return chance(random) < impairment.dropProbability;
+    }
+
+    double burstLength = std::max(impairment.lossBurstLength, 1 / (1 - impairment.dropProbability));
+    if (inLossBurst[direction])
+    {
+        inLossBurst[direction] = chance(random) >= 1.0 / burstLength;
+    }
+    else
+    {
+        double startProbability = impairment.dropProbability / (burstLength * (1 - impairment.dropProbability));
+        inLossBurst[direction] = chance(random) < startProbability;
+    }
+    return inLossBurst[direction];
+}
+
+/**
+ * @brief Draws the delay of one copy of a datagram.
+ *
+ * @param impairment The impairment of its direction.
+ *
+ * @return The delay, never negative.
+ */
+FaultInjector::Clock::duration FaultInjector::drawDelay(const Impairment &impairment)
+{
+    double delayMicros = static_cast<double>(impairment.delay.count());
+    double jitterMicros = static_cast<double>(impairment.jitter.count());
+
+    if (jitterMicros > 0)
+    {
+        switch (impairment.distribution)
+        {
+            case UNIFORM:
+                delayMicros += std::uniform_real_distribution<double>(-jitterMicros, jitterMicros)(random);
+                break;
+            case NORMAL:
+                delayMicros = std::normal_distribution<double>(delayMicros, jitterMicros)(random);
+                break;
+            case EXPONENTIAL:
+                delayMicros += std::exponential_distribution<double>(1.0 / jitterMicros)(random);
+                break;
+        }
+    }
+
+    return std::chrono::microseconds(static_cast<int64_t>(std::max(0.0, delayMicros)));
+}
+
+/**
+ * @brief Sends the held-back datagrams whose delivery time has come.
+ */
+void FaultInjector::deliverDue()
+{
+    Clock::time_point now = Clock::now();
+    while (!pending.empty() && pending.top().due <= now)
+    {
+        Scheduled next = pending.top();
+        pending.pop();
+        socket.sendDataTo(next.data, next.direction == TO_SERVER ? serverAddr : clientAddr);
+    }
+}
+
+/**
+ * @brief Increments a counter.
+ *
+ * @param direction The direction.
+ * @param counter The counter.
+ */
+void FaultInjector::count(Direction direction, CounterIndex counter)
+{
+    counters[static_cast<int>(direction) * COUNTER_COUNT + counter].fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,228 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+
+/**
+ * @brief Constructs an empty histogram.
+ *
+ * Buckets are allocated up to the highest one used, so a histogram of short latencies stays small. Values up
+ * to 2^63 take 57 powers of two of SUB_BUCKETS buckets each, about 58 KB.
+ */
+LatencyHistogram::LatencyHistogram()
+    : totalCount(0), minValue(std::numeric_limits<int64_t>::max()), maxValue(0), sum(0)
+{
+}
+
+/**
+ * @brief Records a value.
+ *
+ * @param value The value. Negative values are recorded as 0.
+ */
+void LatencyHistogram::record(int64_t value)
+{
+    record(value, 1);
+}
+
+/**
+ * @brief Records a value several times.
+ *
+ * @param value The value. Negative values are recorded as 0.
+ * @param count The number of times to record it.
+ */
+void LatencyHistogram::record(int64_t value, int64_t count)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    value = std::max<int64_t>(value, 0);
+
+    size_t index = bucketOf(value);
+    if (index >= counts.size())
+    {
+        counts.resize(index + 1, 0);
+    }
+
+    counts[index] += count;
+    totalCount += count;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += static_cast<double>(value) * static_cast<double>(count);
+}
+
+/**
+ * @brief Adds the counts of another histogram to this one.
+ *
+ * @param other The histogram to add.
+ */
+void LatencyHistogram::merge(const LatencyHistogram &other)
+{
+    if (other.counts.size() > counts.size())
+    {
+        counts.resize(other.counts.size(), 0);
+    }
+    for (size_t i = 0; i < other.counts.size(); ++i)
+    {
+        counts[i] += other.counts[i];
+    }
+    totalCount += other.totalCount;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+}
+
+/**
+ * @brief Removes all recorded values.
+ */
+void LatencyHistogram::reset()
+{
+    counts.clear();
+    totalCount = 0;
+    minValue = std::numeric_limits<int64_t>::max();
+    maxValue = 0;
+    sum = 0;
+}
+
+/**
+ * @brief Gets the number of recorded values.
+ *
+ * @return The count.
+ */
+int64_t LatencyHistogram::getCount() const
+{
+    return totalCount;
+}
+
+/**
+ * @brief Gets the smallest recorded value.
+ *
+ * @return The value, or 0 if the histogram is empty.
+ */
+int64_t LatencyHistogram::getMin() const
+{
+    return totalCount == 0 ? 0 : minValue;
+}
+
+/**
+ * @brief Gets the largest recorded value.
+ *
+ * @return The value, or 0 if the histogram is empty.
+ */
+int64_t LatencyHistogram::getMax() const
+{
+    return maxValue;
+}
+
+/**
+ * @brief Gets the mean of the recorded values.
+ *
+ * @return The mean, or 0 if the histogram is empty.
+ */
+double LatencyHistogram::getMean() const
+{
+    return totalCount == 0 ? 0 : sum / static_cast<double>(totalCount);
+}
+
+/**
+ * @brief Gets the value at a percentile.
+ *
+ * The result is the highest value of the bucket holding the value at the percentile, capped at the largest
+ * recorded value, so it never understates a tail latency.
+ *
+ * @param percentile The percentile, from 0 to 100.
+ *
+ * @return The highest value equivalent to the value at the percentile, or 0 if the histogram is empty.
+ */
+int64_t LatencyHistogram::getValueAtPercentile(double percentile) const
+{
+    if (totalCount == 0)
+    {
+        return 0;
+    }
+
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    int64_t rank = std::max<int64_t>(1, static_cast<int64_t>(std::ceil(percentile / 100.0 * static_cast<double>(totalCount))));
+
+    int64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+        {
+            return std::min(highestValueOf(i), maxValue);
+        }
+    }
+    return maxValue;
+}
+
+/**
+ * @brief Gets the number of recorded values up to a bound.
+ *
+ * The bucket holding the bound is counted as a whole, so values slightly above the bound, within the bucket
+ * precision, may be included.
+ *
+ * @param value The bound. Negative bounds count nothing.
+ *
+ * @return The number of values in the buckets up to the bucket of the bound.
+ */
+int64_t LatencyHistogram::getCountAtOrBelow(int64_t value) const
+{
+    if (value < 0)
+    {
+        return 0;
+    }
+
+    size_t last = std::min(bucketOf(value) + 1, counts.size());
+    int64_t count = 0;
+    for (size_t i = 0; i < last; ++i)
+    {
+        count += counts[i];
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the bucket of a value.
+ *
+ * Values below 2 * SUB_BUCKETS are their own bucket. A larger value is shifted right until it has
+ * SUB_BUCKET_BITS + 1 significant bits; the shift selects the power of two and the remaining bits the
+ * linear bucket within it.
+ *
+ * @param value The non-negative value.
+ *
+ * @return The index of the bucket.
+ */
+size_t LatencyHistogram::bucketOf(int64_t value)
+{
+    uint64_t unsignedValue = static_cast<uint64_t>(value);
+    if (unsignedValue < static_cast<uint64_t>(2 * SUB_BUCKETS))
+    {
+        return static_cast<size_t>(unsignedValue);
+    }
+
+    int shift = std::bit_width(unsignedValue) - 1 - SUB_BUCKET_BITS;
+    return static_cast<size_t>(shift) * SUB_BUCKETS + static_cast<size_t>(unsignedValue >> shift);
+}
+
+/**
+ * @brief Gets the highest value that falls into a bucket.
+ *
+ * @param index The index of the bucket.
+ *
+ * @return The value.
+ */
+int64_t LatencyHistogram::highestValueOf(size_t index)
+{
+    if (index < static_cast<size_t>(2 * SUB_BUCKETS))
+    {
+        return static_cast<int64_t>(index);
+    }
+
+    int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+    uint64_t subBucket = index % SUB_BUCKETS + SUB_BUCKETS;
+    return static_cast<int64_t>(((subBucket + 1) << shift) - 1);
+}
@@ -0,0 +1,373 @@
+#include "MetricsExporter.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "Constants.hpp"
+
+/**
+ * @brief Constructs an exporter of a client's statistics.
+ *
+ * @param stats The statistics to export.
+ */
+MetricsExporter::MetricsExporter(const ClientStats &stats) : stats(stats), running(false)
+{
+}
+
+/**
+ * @brief Stops serving the endpoint, if it is served.
+ */
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+/**
+ * @brief Registers a counter, a value that only increases.
+ *
+ * @param name The metric name, e.g. "booking_client_cache_hits_total".
+ * @param help The description of the metric.
+ * @param value Reads the current value.
+ */
+void MetricsExporter::addCounter(const std::string &name, const std::string &help, const std::function<double()> &value)
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    metrics.push_back({name, help, "counter", value});
+}
+
+/**
+ * @brief Registers a gauge, a value that may go up and down.
+ *
+ * @param name The metric name, e.g. "booking_client_cache_hit_ratio".
+ * @param help The description of the metric.
+ * @param value Reads the current value.
+ */
+void MetricsExporter::addGauge(const std::string &name, const std::string &help, const std::function<double()> &value)
+{
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    metrics.push_back({name, help, "gauge", value});
+}
+
+/**
+ * @brief Renders all metrics.
+ *
+ * The client statistics are labelled by request type, attempts also by outcome and latencies also by phase.
+ * Latencies are exported in seconds, with the bucket bounds of METRICS_LATENCY_BUCKETS in Constants.hpp.
+ * Rates are left to the scraper, which derives them from the counters.
+ *
+ * @return The metrics in the Prometheus text exposition format.
+ */
+std::string MetricsExporter::render() const
+{
+    ClientStats::Snapshot snapshot = stats.snapshot();
+    std::string out;
+
+    std::vector<std::string> typeLabels;
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        typeLabels.push_back("type=\"" + std::string(ClientStats::getRequestTypeName(type)) + "\"");
+    }
+
+    appendHeader(out, "booking_client_requests_total", "Operations completed, by request type.", "counter");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        appendSample(out, "booking_client_requests_total", typeLabels[type], static_cast<double>(snapshot[type].operations));
+    }
+
+    appendHeader(out, "booking_client_request_failures_total", "Operations that gave up without a reply, by request type.", "counter");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        appendSample(out, "booking_client_request_failures_total", typeLabels[type], static_cast<double>(snapshot[type].failures));
+    }
+
+    appendHeader(out, "booking_client_retries_total", "Retransmissions, by request type.", "counter");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        appendSample(out, "booking_client_retries_total", typeLabels[type], static_cast<double>(snapshot[type].retries));
+    }
+
+    appendHeader(out, "booking_client_attempts_total", "Attempts, by request type and outcome.", "counter");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        for (int outcome = 0; outcome < ClientStats::OUTCOME_COUNT; ++outcome)
+        {
+            std::string labels = typeLabels[type] + ",outcome=\"" + ClientStats::getOutcomeName(static_cast<ClientStats::Outcome>(outcome)) + "\"";
+            appendSample(out, "booking_client_attempts_total", labels, static_cast<double>(snapshot[type].attempts[outcome]));
+        }
+    }
+
+    appendHeader(out, "booking_client_in_flight", "Operations in progress, by request type.", "gauge");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        appendSample(out, "booking_client_in_flight", typeLabels[type], static_cast<double>(snapshot[type].inFlight));
+    }
+
+    appendHeader(out, "booking_client_phase_duration_seconds", "Duration of each phase of the operations, by request type.", "histogram");
+    for (int type = 0; type < ClientStats::REQUEST_TYPE_COUNT; ++type)
+    {
+        for (int phase = 0; phase < ClientStats::PHASE_COUNT; ++phase)
+        {
+            std::string labels = typeLabels[type] + ",phase=\"" + ClientStats::getPhaseName(static_cast<ClientStats::Phase>(phase)) + "\"";
+            appendHistogram(out, "booking_client_phase_duration_seconds", labels, snapshot[type].phases[phase]);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(metricsMutex);
+    for (const Metric &metric : metrics)
+    {
+        appendHeader(out, metric.name, metric.help, metric.type);
+        appendSample(out, metric.name, "", metric.value());
+    }
+
+    return out;
+}
+
+/**
+ * @brief Writes all metrics to a file, replacing it atomically.
+ *
+ * The metrics are written to a temporary file next to it, which is then renamed, so that a collector never
+ * reads a partly written file. Call it periodically to feed a textfile collector.
+ *
+ * @param path The path of the file.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void MetricsExporter::writeFile(const std::string &path) const
+{
+    std::string temporaryPath = path + ".tmp";
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file << render();
+        if (!file)
+        {
+            throw std::runtime_error("Failed to write metrics file: " + temporaryPath);
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error)
+    {
+        throw std::runtime_error("Failed to replace metrics file " + path + ": " + error.message());
+    }
+}
+
+/**
+ * @brief Starts serving the metrics over HTTP from a background thread.
+ *
+ * Every GET request is answered with the rendered metrics, one connection at a time, which is enough for
+ * periodic scrapes. By default only the loopback address is bound, so the metrics are not reachable from
+ * outside the host; pass the address of an interface, or "0.0.0.0", to let a remote Prometheus scrape them.
+ *
+ * @param port The TCP port to listen on, or 0 for any free port.
+ * @param address The local address to listen on, e.g. "0.0.0.0" for every interface.
+ *
+ * @throws std::runtime_error if the endpoint is already served, the address cannot be resolved or the port cannot be bound.
+ */
+void MetricsExporter::serve(int port, const std::string &address)
+{
+    if (running.load())
+    {
+        throw std::runtime_error("Metrics endpoint is already served");
+    }
+
+    listener.create(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    try
+    {
+        listener.bind(Socket::resolveAddress(address, port));
+        listener.listen(16);
+    }
+    catch (const std::runtime_error &)
+    {
+        listener.closeSocket();
+        throw;
+    }
+
+    running.store(true);
+    serverThread = std::thread(&MetricsExporter::serveLoop, this);
+}
+
+/**
+ * @brief Stops serving the metrics and waits for the background thread.
+ *
+ * The thread notices within METRICS_POLL_INTERVAL_MS milliseconds, or after the scrape it is answering.
+ */
+void MetricsExporter::stop()
+{
+    running.store(false);
+    if (serverThread.joinable())
+    {
+        serverThread.join();
+    }
+    listener.closeSocket();
+}
+
+/**
+ * @brief Gets the port the metrics are served on.
+ *
+ * @return The port number, or 0 if the endpoint is not served.
+ */
+int MetricsExporter::getPort()
+{
+    if (!running.load())
+    {
+        return 0;
+    }
+
+    struct sockaddr_in addr;
+    listener.getSocketName(reinterpret_cast<struct sockaddr *>(&addr));
+    return ntohs(addr.sin_port);
+}
+
+/**
+ * @brief Accepts scrape connections until stop() is called.
+ *
+ * The listener is polled with a timeout, so that the thread can check whether it should stop.
+ */
+void MetricsExporter::serveLoop()
+{
+    while (running.load())
+    {
+        try
+        {
+            if (!listener.waitReadable(Constants::METRICS_POLL_INTERVAL_MS))
+            {
+                continue;
+            }
+
+            Socket connection;
+            listener.acceptConnection(connection);
+            handleConnection(connection);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error serving metrics: " << e.what() << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Reads an HTTP request from a connection and answers it.
+ *
+ * Only the request line is looked at: GET requests for / or /metrics get the metrics, anything else a 404.
+ * The connection is closed after the response.
+ *
+ * @param connection The accepted connection.
+ */
+void MetricsExporter::handleConnection(Socket &connection)
+{
+    connection.setReceiveTimeoutMillis(Constants::METRICS_REQUEST_TIMEOUT_MS);
+
+    char recvBuffer[Constants::BUFFER_SIZE];
+    struct sockaddr_in peerAddr;
+    std::string request;
+
+    // Read until the end of the headers, the request body of a GET is ignored
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < static_cast<size_t>(Constants::BUFFER_SIZE))
+    {
+        int bytesReceived = connection.receiveDataFrom(recvBuffer, Constants::BUFFER_SIZE, peerAddr);
+        if (bytesReceived <= 0)
+        {
+            break;
+        }
+        request.append(recvBuffer, bytesReceived);
+    }
+
+    std::string requestLine = request.substr(0, request.find("\r\n"));
+    bool isScrape = requestLine.rfind("GET / ", 0) == 0 || requestLine.rfind("GET /metrics ", 0) == 0;
+
+    std::string status = isScrape ? "200 OK" : "404 Not Found";
+    std::string body = isScrape ? render() : "Not found\n";
+    std::string contentType = isScrape ? "text/plain; version=0.0.4; charset=utf-8" : "text/plain; charset=utf-8";
+
+    connection.sendAll(
+        "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: " + contentType + "\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n"
+        "\r\n" + body
+    );
+}
+
+/**
+ * @brief Appends the HELP and TYPE lines of a metric.
+ *
+ * @param out The text to append to.
+ * @param name The metric name.
+ * @param help The description of the metric.
+ * @param type The metric type.
+ */
+void MetricsExporter::appendHeader(std::string &out, const std::string &name, const std::string &help, const std::string &type)
+{
+    out += "# HELP " + name + " " + help + "\n";
+    out += "# TYPE " + name + " " + type + "\n";
+}
+
+/**
+ * @brief Appends a sample of a metric.
+ *
+ * Whole numbers are written without an exponent, so that large counters keep every digit.
+ *
+ * @param out The text to append to.
+ * @param name The metric name, with any suffix.
+ * @param labels The labels without braces, e.g. type="READ", or an empty string.
+ * @param value The value.
+ */
+void MetricsExporter::appendSample(std::string &out, const std::string &name, const std::string &labels, double value)
+{
+    char formatted[32];
+    if (std::isnan(value))
+    {
+        snprintf(formatted, sizeof(formatted), "NaN");
+    }
+    else if (std::isinf(value))
+    {
+        snprintf(formatted, sizeof(formatted), value > 0 ? "+Inf" : "-Inf");
+    }
+    else if (value == std::floor(value) && std::fabs(value) < 1e15)
+    {
+        snprintf(formatted, sizeof(formatted), "%.0f", value);
+    }
+    else
+    {
+        snprintf(formatted, sizeof(formatted), "%.9g", value);
+    }
+
+    out += name;
+    if (!labels.empty())
+    {
+        out += "{" + labels + "}";
+    }
+    out += " ";
+    out += formatted;
+    out += "\n";
+}
+
+/**
+ * @brief Appends the bucket, sum and count samples of a latency histogram.
+ *
+ * Each bucket counts the durations up to its bound, to the bucket precision of LatencyHistogram. The sum is
+ * derived from the mean, so it has the same precision.
+ *
+ * @param out The text to append to.
+ * @param name The metric name.
+ * @param labels The labels of the histogram without braces.
+ * @param histogram The histogram of durations in nanoseconds.
+ */
+void MetricsExporter::appendHistogram(std::string &out, const std::string &name, const std::string &labels, const LatencyHistogram &histogram)
+{
+    for (double bound : Constants::METRICS_LATENCY_BUCKETS)
+    {
+        char formattedBound[32];
+        snprintf(formattedBound, sizeof(formattedBound), "%g", bound);
+
+        int64_t count = histogram.getCountAtOrBelow(static_cast<int64_t>(bound * 1e9));
+        appendSample(out, name + "_bucket", labels + ",le=\"" + formattedBound + "\"", static_cast<double>(count));
+    }
+    appendSample(out, name + "_bucket", labels + ",le=\"+Inf\"", static_cast<double>(histogram.getCount()));
+    appendSample(out, name + "_sum", labels, histogram.getMean() * static_cast<double>(histogram.getCount()) / 1e9);
+    appendSample(out, name + "_count", labels, static_cast<double>(histogram.getCount()));
+}
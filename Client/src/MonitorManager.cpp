@@ -0,0 +1,482 @@
+#include "MonitorManager.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief Constructs a MonitorManager that uses the given client for registrations and updates.
+ *
+ * The manager installs itself as the client's push handler, so that updates arriving while a lease is being renewed are not lost.
+ * Updates queued outside of run() are delivered once run() is next called.
+ *
+ * @param client Reference to the Client object for server communication.
+ * @param leaseSeconds The duration of each registration with the server in seconds.
+ */
+MonitorManager::MonitorManager(Client &client, int leaseSeconds)
+    : client(client), leaseSeconds(leaseSeconds), nextSubscriptionID(1), duplicateCount(0),
+      deliveryQueue(Constants::MONITOR_MAX_FACILITIES, Constants::MONITOR_QUEUE_CAPACITY)
+{
+    // Hand out low keys first
+    for (size_t key = Constants::MONITOR_MAX_FACILITIES; key > 0; key--)
+    {
+        freeQueueKeys.push_back(key - 1);
+    }
+
+    client.setPushHandler([this](const RequestMessage &update)
+    {
+        handleUpdate(update);
+    });
+}
+
+/**
+ * @brief Detaches the manager from the client.
+ *
+ * Registrations held with the server are left to expire on their own.
+ */
+MonitorManager::~MonitorManager()
+{
+    client.setPushHandler(nullptr);
+
+    if (deliveryThread.joinable())
+    {
+        deliveryQueue.close();
+        deliveryThread.join();
+    }
+}
+
+/**
+ * @brief Subscribes to the availability updates of a facility.
+ *
+ * The first subscription for a facility registers it with the server.
+ * Further subscriptions for the same facility share that registration, which is extended as needed while any of them is active.
+ *
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration of the subscription in seconds.
+ * @param onUpdate Callback function to handle updates for the facility.
+ *
+ * @return The ID of the new subscription, or -1 if the facility could not be registered.
+ */
+int MonitorManager::subscribe(const std::string &facilityName, int durationSeconds, const UpdateCallback &onUpdate)
+{
+    Subscription subscription;
+    subscription.onUpdate = onUpdate;
+    subscription.endTime = Clock::now() + std::chrono::seconds(durationSeconds);
+
+    std::unique_lock<std::mutex> lock(watchesMutex);
+    if (watches.find(facilityName) == watches.end())
+    {
+        if (freeQueueKeys.empty())
+        {
+            std::cerr << "Cannot monitor more than " << Constants::MONITOR_MAX_FACILITIES << " facilities" << std::endl;
+            return -1;
+        }
+
+        FacilityWatch watch;
+        watch.queueKey = freeQueueKeys.back();
+        freeQueueKeys.pop_back();
+        watches.emplace(facilityName, watch);
+
+        // The lock is not held while waiting for the server, and the watch is looked up again afterwards
+        lock.unlock();
+        bool registered = registerLease(facilityName, subscription.endTime);
+        lock.lock();
+
+        if (!registered)
+        {
+            auto failed = watches.find(facilityName);
+            if (failed != watches.end() && failed->second.subscriptions.empty())
+            {
+                removeWatch(failed);
+            }
+            return -1;
+        }
+    }
+
+    auto it = watches.find(facilityName);
+    if (it == watches.end())
+    {
+        return -1;
+    }
+
+    subscription.id = nextSubscriptionID++;
+    it->second.subscriptions.push_back(subscription);
+
+    return subscription.id;
+}
+
+/**
+ * @brief Cancels a subscription.
+ *
+ * The facility's registration with the server is not renewed once it has no subscriptions left.
+ * May be called from callbacks. An update queued before the call may still be delivered to the subscription.
+ *
+ * @param subscriptionID The ID returned by subscribe().
+ */
+void MonitorManager::unsubscribe(int subscriptionID)
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    for (auto it = watches.begin(); it != watches.end(); ++it)
+    {
+        std::vector<Subscription> &subscriptions = it->second.subscriptions;
+        auto match = std::find_if(subscriptions.begin(), subscriptions.end(), [subscriptionID](const Subscription &s)
+        {
+            return s.id == subscriptionID;
+        });
+
+        if (match != subscriptions.end())
+        {
+            subscriptions.erase(match);
+            if (subscriptions.empty())
+            {
+                removeWatch(it);
+            }
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Receives and dispatches updates until the duration elapses or no subscriptions remain.
+ *
+ * Between updates, ended subscriptions are removed and leases about to expire are renewed.
+ * The receive timeout is set to the next such deadline, so the loop never waits longer than necessary.
+ * Callbacks are invoked on a separate delivery thread, which is drained and stopped before this method returns.
+ *
+ * @param durationSeconds The maximum duration to run in seconds.
+ */
+void MonitorManager::run(int durationSeconds)
+{
+    Clock::time_point runEndTime = Clock::now() + std::chrono::seconds(durationSeconds);
+
+    deliveryQueue.reopen();
+    deliveryThread = std::thread(&MonitorManager::deliverUpdates, this);
+
+    while (true)
+    {
+        removeEndedSubscriptions();
+        if (getSubscriptionCount() == 0 || Clock::now() >= runEndTime)
+        {
+            break;
+        }
+
+        renewExpiringLeases();
+
+        auto waitMillis = std::chrono::duration_cast<std::chrono::milliseconds>(getNextDeadline(runEndTime) - Clock::now()).count();
+
+        RequestMessage update;
+        if (client.receiveMonitorUpdate(update, static_cast<int>(std::max<long long>(waitMillis, 1))))
+        {
+            handleUpdate(update);
+        }
+    }
+
+    deliveryQueue.close();
+    deliveryThread.join();
+}
+
+/**
+ * @brief Gets the number of active subscriptions.
+ *
+ * @return The number of active subscriptions.
+ */
+size_t MonitorManager::getSubscriptionCount() const
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    size_t count = 0;
+    for (const auto &entry : watches)
+    {
+        count += entry.second.subscriptions.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Gets the number of repeated updates that were not delivered.
+ *
+ * @return The number of suppressed duplicate updates.
+ */
+uint64_t MonitorManager::getDuplicateCount() const
+{
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    return duplicateCount;
+}
+
+/**
+ * @brief Gets the counters of the delivery queue.
+ *
+ * @return The numbers of enqueued, delivered, coalesced and dropped updates.
+ */
+MonitorManager::DeliveryStats MonitorManager::getDeliveryStats() const
+{
+    return deliveryQueue.getStats();
+}
+
+/**
+ * @brief Registers a facility with the server for the next lease.
+ *
+ * The lease is capped at the end of the facility's longest subscription, so that the server does not keep pushing updates nobody waits for.
+ * A registration that timed out may succeed later, while any other error would be repeated by the server, so the
+ * watch is then no longer renewed and its subscriptions run out on what their last lease still covers.
+ * Callbacks may unsubscribe, and so remove the watch, while the reply is awaited without holding the lock; the watch
+ * is therefore looked up by name only once the reply has arrived, and a registration of a removed watch is ignored.
+ *
+ * @param facilityName The name of the facility to register, which must be watched.
+ * @param lastEndTime The end time of the longest subscription for the facility.
+ *
+ * @return True if the registration succeeded and the facility is still watched, false otherwise.
+ */
+bool MonitorManager::registerLease(const std::string &facilityName, Clock::time_point lastEndTime)
+{
+    Clock::time_point now = Clock::now();
+    auto remainingSeconds = std::chrono::duration_cast<std::chrono::seconds>(lastEndTime - now).count() + 1; // Round up
+    int lease = static_cast<int>(std::min<long long>(leaseSeconds, std::max<long long>(remainingSeconds, 1)));
+
+    ResponseParser::Error error = ResponseParser::parseStatus(client.registerMonitor(facilityName, lease));
+    if (error.failed())
+    {
+        std::cerr << "Failed to register monitoring for " << facilityName << ": " << error.message << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    auto it = watches.find(facilityName);
+    if (it == watches.end())
+    {
+        return false;
+    }
+
+    if (error.failed())
+    {
+        it->second.renewable = error.retryable();
+        return false;
+    }
+    it->second.leaseExpiry = now + std::chrono::seconds(lease);
+    return true;
+}
+
+/**
+ * @brief Re-registers every facility whose lease is about to expire while still subscribed.
+ *
+ * Renewal starts MONITOR_RENEW_MARGIN_SEC before the lease expires. Watches whose registration was rejected are skipped.
+ * The old and new registrations overlap briefly, so the server may push the same update twice; handleUpdate() drops the repeat.
+ * The lock is released while a lease is registered, during which callbacks may unsubscribe and so change the set of
+ * watches. Facility names are therefore collected first and each watch is looked up again by name, and no reference
+ * to a watch is held across a registration.
+ */
+void MonitorManager::renewExpiringLeases()
+{
+    std::vector<std::string> facilityNames;
+    {
+        std::lock_guard<std::mutex> lock(watchesMutex);
+        for (const auto &entry : watches)
+        {
+            facilityNames.push_back(entry.first);
+        }
+    }
+
+    for (const std::string &facilityName : facilityNames)
+    {
+        Clock::time_point lastEndTime;
+        {
+            std::lock_guard<std::mutex> lock(watchesMutex);
+            auto it = watches.find(facilityName);
+            if (it == watches.end())
+            {
+                continue;
+            }
+
+            const FacilityWatch &watch = it->second;
+            lastEndTime = getLastEndTime(watch);
+            Clock::time_point renewTime = watch.leaseExpiry - std::chrono::seconds(Constants::MONITOR_RENEW_MARGIN_SEC);
+            if (!watch.renewable || Clock::now() < renewTime || watch.leaseExpiry >= lastEndTime)
+            {
+                continue;
+            }
+        }
+
+        registerLease(facilityName, lastEndTime);
+    }
+}
+
+/**
+ * @brief Removes subscriptions that have ended, and facilities without subscriptions.
+ */
+void MonitorManager::removeEndedSubscriptions()
+{
+    Clock::time_point now = Clock::now();
+
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    for (auto it = watches.begin(); it != watches.end();)
+    {
+        std::vector<Subscription> &subscriptions = it->second.subscriptions;
+        subscriptions.erase(
+            std::remove_if(subscriptions.begin(), subscriptions.end(), [now](const Subscription &s)
+            {
+                return s.endTime <= now;
+            }),
+            subscriptions.end());
+
+        if (subscriptions.empty())
+        {
+            it = removeWatch(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Gets the time at which the run loop next needs to wake up.
+ *
+ * @param runEndTime The end time of the run loop.
+ *
+ * @return The earliest of the run end time, the next subscription end and the next lease renewal.
+ */
+MonitorManager::Clock::time_point MonitorManager::getNextDeadline(Clock::time_point runEndTime) const
+{
+    Clock::time_point deadline = runEndTime;
+
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    for (const auto &entry : watches)
+    {
+        const FacilityWatch &watch = entry.second;
+        Clock::time_point lastEndTime = getLastEndTime(watch);
+
+        for (const Subscription &subscription : watch.subscriptions)
+        {
+            deadline = std::min(deadline, subscription.endTime);
+        }
+
+        if (watch.renewable && watch.leaseExpiry < lastEndTime)
+        {
+            deadline = std::min(deadline, watch.leaseExpiry - std::chrono::seconds(Constants::MONITOR_RENEW_MARGIN_SEC));
+        }
+    }
+
+    return deadline;
+}
+
+/**
+ * @brief Routes an update to the subscriptions of its facility.
+ *
+ * Updates for facilities without subscriptions are ignored.
+ * An update identical to the last one received for the same facility is counted as a duplicate and dropped.
+ * Otherwise the update is queued for the delivery thread together with a copy of the facility's callbacks,
+ * replacing any update of the same facility that has not been delivered yet.
+ *
+ * @param update The update pushed by the server.
+ */
+void MonitorManager::handleUpdate(const RequestMessage &update)
+{
+    const std::string data = update.getData();
+    const std::string facilityName = extractFacilityName(data);
+
+    // A facility being subscribed has no subscriptions until its registration succeeds
+    std::lock_guard<std::mutex> lock(watchesMutex);
+    auto it = watches.find(facilityName);
+    if (it == watches.end() || it->second.subscriptions.empty())
+    {
+        return;
+    }
+
+    FacilityWatch &watch = it->second;
+    size_t updateHash = std::hash<std::string>{}(data);
+    if (watch.hasLastUpdate && watch.lastUpdateHash == updateHash)
+    {
+        duplicateCount++;
+        return;
+    }
+    watch.lastUpdateHash = updateHash;
+    watch.hasLastUpdate = true;
+
+    Delivery delivery;
+    delivery.facilityName = facilityName;
+    delivery.data = data;
+    for (const Subscription &subscription : watch.subscriptions)
+    {
+        delivery.callbacks.push_back(subscription.onUpdate);
+    }
+
+    if (!deliveryQueue.push(watch.queueKey, std::move(delivery)))
+    {
+        std::cerr << "Delivery queue full, dropping update for " << facilityName << std::endl;
+    }
+}
+
+/**
+ * @brief Invokes callbacks for queued updates until the queue is closed and drained.
+ *
+ * The thread blocks while the queue is empty and wakes on the next push, so that an idle delivery thread costs
+ * no CPU. Callbacks run without the lock, so they may unsubscribe.
+ */
+void MonitorManager::deliverUpdates()
+{
+    Delivery delivery;
+    while (deliveryQueue.waitPop(delivery))
+    {
+        for (const UpdateCallback &callback : delivery.callbacks)
+        {
+            callback(delivery.facilityName, delivery.data);
+        }
+    }
+}
+
+/**
+ * @brief Removes a facility's watch and returns its delivery queue key.
+ *
+ * An update of the facility still waiting in the queue is delivered as usual.
+ * If the key is reassigned before then, that update may be coalesced away by the new facility's updates.
+ *
+ * @param it Iterator to the watch to remove.
+ *
+ * @return Iterator to the watch following the removed one.
+ */
+std::unordered_map<std::string, MonitorManager::FacilityWatch>::iterator MonitorManager::removeWatch(
+    std::unordered_map<std::string, FacilityWatch>::iterator it)
+{
+    freeQueueKeys.push_back(it->second.queueKey);
+    return watches.erase(it);
+}
+
+/**
+ * @brief Gets the end time of the longest subscription of a facility.
+ *
+ * @param watch The watch state of the facility.
+ *
+ * @return The latest subscription end time.
+ */
+MonitorManager::Clock::time_point MonitorManager::getLastEndTime(const FacilityWatch &watch)
+{
+    Clock::time_point lastEndTime = Clock::time_point::min();
+    for (const Subscription &subscription : watch.subscriptions)
+    {
+        lastEndTime = std::max(lastEndTime, subscription.endTime);
+    }
+    return lastEndTime;
+}
+
+/**
+ * @brief Extracts the facility name from an update's data string.
+ *
+ * Updates have the same format as availability query responses, where the facility name follows the "facility:" prefix on its own line.
+ *
+ * @param data The data string of the update.
+ *
+ * @return The facility name, or an empty string if there is none.
+ */
+std::string MonitorManager::extractFacilityName(const std::string &data)
+{
+    const std::string facilityPrefix = "facility:";
+    size_t pos = data.find(facilityPrefix);
+
+    if (pos != std::string::npos)
+    {
+        size_t start = pos + facilityPrefix.length();
+        size_t end = data.find('\n', start);
+        return data.substr(start, end - start);
+    }
+
+    return "";
+}
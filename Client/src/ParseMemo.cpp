@@ -0,0 +1,253 @@
+#include "ParseMemo.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if !defined(__SIZEOF_INT128__) && defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    #include <intrin.h>
+#endif
+
+/**
+ * @brief Constructs an empty table.
+ *
+ * @param capacity The maximum number of replies kept, at least 1.
+ */
+ParseMemo::ParseMemo(size_t capacity)
+    : capacity(std::max<size_t>(capacity, 1)), hitCount(0), missCount(0), evictionCount(0)
+{
+    index.reserve(this->capacity);
+}
+
+/**
+ * @brief Parses an availability reply, or returns the result of an identical reply parsed before.
+ *
+ * A hit moves the entry to the front and costs a hash and a comparison of the text. A miss parses the reply
+ * and stores it, replacing an entry whose hash collided, or else the least recently used entry if the table is full.
+ *
+ * @param response The raw server response.
+ * @param dayMask The days to parse, with the bit of each day set.
+ *
+ * @return The availability of the listed days of the mask or the error, shared with other callers.
+ */
+std::shared_ptr<const ResponseParser::Availability> ParseMemo::parseQueryAvailabilityResponse(std::string_view response, uint8_t dayMask)
+{
+    uint64_t key = hash(response, dayMask);
+
+    auto found = index.find(key);
+    if (found != index.end())
+    {
+        const Entry &entry = *found->second;
+        if (entry.dayMask == dayMask && entry.response == response)
+        {
+            entries.splice(entries.begin(), entries, found->second);
+            hitCount.fetch_add(1, std::memory_order_relaxed);
+            return entry.availability;
+        }
+
+        // Another reply has the same hash; the newer one takes its place
+        entries.erase(found->second);
+        index.erase(found);
+    }
+
+    missCount.fetch_add(1, std::memory_order_relaxed);
+    auto availability = std::make_shared<const ResponseParser::Availability>(ResponseParser::parseQueryAvailabilityResponse(response, dayMask));
+
+    if (entries.size() >= capacity)
+    {
+        index.erase(entries.back().key);
+        entries.pop_back();
+        evictionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    entries.push_front({key, std::string(response), dayMask, availability});
+    index.emplace(key, entries.begin());
+
+    return availability;
+}
+
+/**
+ * @brief Removes every entry. The counters are kept.
+ */
+void ParseMemo::clear()
+{
+    entries.clear();
+    index.clear();
+}
+
+/**
+ * @brief Gets the number of replies kept.
+ *
+ * @return The number of entries.
+ */
+size_t ParseMemo::size() const
+{
+    return entries.size();
+}
+
+/**
+ * @brief Gets the counters of the table.
+ *
+ * @return The numbers of hits, misses and evictions.
+ */
+ParseMemo::Stats ParseMemo::getStats() const
+{
+    return {hitCount.load(std::memory_order_relaxed), missCount.load(std::memory_order_relaxed), evictionCount.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Hashes text with a seed, in the manner of wyhash.
+ *
+ * The text is read in 8-byte words, three lanes of 48 bytes at a time, and each pair of words is combined by a
+ * 64x64 to 128-bit multiplication whose halves are folded together. Texts up to 16 bytes are read as two
+ * overlapping pairs of 4-byte words. Availability replies of a few hundred bytes hash in a few dozen
+ * multiplications, far less than parsing them.
+ *
+ * @param data The text.
+ * @param seed The seed, which changes the hash of every text.
+ *
+ * @return The 64-bit hash.
+ */
+uint64_t ParseMemo::hash(std::string_view data, uint64_t seed)
+{
+    const char *p = data.data();
+    size_t length = data.size();
+    seed ^= mix(seed ^ HASH_SECRETS[0], HASH_SECRETS[1]);
+
+    uint64_t a;
+    uint64_t b;
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            size_t step = (length >> 3) << 2;
+            a = (read32(p) << 32) | read32(p + step);
+            b = (read32(p + length - 4) << 32) | read32(p + length - 4 - step);
+        }
+        else if (length > 0)
+        {
+            a = (static_cast<uint64_t>(static_cast<uint8_t>(p[0])) << 16) | (static_cast<uint64_t>(static_cast<uint8_t>(p[length >> 1])) << 8) |
+                static_cast<uint8_t>(p[length - 1]);
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t remaining = length;
+        if (remaining > 48)
+        {
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do
+            {
+                seed = mix(read64(p) ^ HASH_SECRETS[1], read64(p + 8) ^ seed);
+                lane1 = mix(read64(p + 16) ^ HASH_SECRETS[2], read64(p + 24) ^ lane1);
+                lane2 = mix(read64(p + 32) ^ HASH_SECRETS[3], read64(p + 40) ^ lane2);
+                p += 48;
+                remaining -= 48;
+            } while (remaining > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (remaining > 16)
+        {
+            seed = mix(read64(p) ^ HASH_SECRETS[1], read64(p + 8) ^ seed);
+            p += 16;
+            remaining -= 16;
+        }
+        a = read64(p + remaining - 16);
+        b = read64(p + remaining - 8);
+    }
+
+    uint64_t high;
+    uint64_t low = multiply(a ^ HASH_SECRETS[1], b ^ seed, high);
+    return mix(low ^ HASH_SECRETS[0] ^ length, high ^ HASH_SECRETS[1]);
+}
+
+/**
+ * @brief Multiplies two words to 128 bits and folds the halves together.
+ *
+ * @param a The first word.
+ * @param b The second word.
+ *
+ * @return The low half of the product XOR its high half.
+ */
+uint64_t ParseMemo::mix(uint64_t a, uint64_t b)
+{
+    uint64_t high;
+    uint64_t low = multiply(a, b, high);
+    return low ^ high;
+}
+
+/**
+ * @brief Multiplies two words to 128 bits.
+ *
+ * Uses the 128-bit integers of GCC and Clang, or the intrinsics of MSVC, which both compile to a single
+ * multiplication on 64-bit targets. Other compilers multiply the 32-bit halves of the words and add up the
+ * partial products, as wyhash does.
+ *
+ * @param a The first word.
+ * @param b The second word.
+ * @param high Set to the high half of the product.
+ *
+ * @return The low half of the product.
+ */
+uint64_t ParseMemo::multiply(uint64_t a, uint64_t b, uint64_t &high)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 product = static_cast<unsigned __int128>(a) * b;
+    high = static_cast<uint64_t>(product >> 64);
+    return static_cast<uint64_t>(product);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, &high);
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+    high = __umulh(a, b);
+    return a * b;
+#else
+    uint64_t aHigh = a >> 32;
+    uint64_t aLow = static_cast<uint32_t>(a);
+    uint64_t bHigh = b >> 32;
+    uint64_t bLow = static_cast<uint32_t>(b);
+
+    uint64_t lowLow = aLow * bLow;
+    uint64_t highLow = aHigh * bLow;
+    uint64_t lowHigh = aLow * bHigh;
+
+    uint64_t sum = lowLow + (highLow << 32);
+    uint64_t carry = sum < lowLow;
+    uint64_t low = sum + (lowHigh << 32);
+    carry += low < sum;
+
+    high = aHigh * bHigh + (highLow >> 32) + (lowHigh >> 32) + carry;
+    return low;
+#endif
+}
+
+/**
+ * @brief Reads 8 bytes in native byte order.
+ *
+ * @param p The bytes.
+ *
+ * @return The word.
+ */
+uint64_t ParseMemo::read64(const char *p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * @brief Reads 4 bytes in native byte order.
+ *
+ * @param p The bytes.
+ *
+ * @return The word, zero-extended.
+ */
+uint64_t ParseMemo::read32(const char *p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
@@ -0,0 +1,190 @@
+#include "RequestFactory.hpp"
+
+#include <array>
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Builds a request for the names of all available facilities.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::queryFacilityNames()
+{
+    std::string messageData = "facility,ALL"; // Request all facility name
+
+    return RequestMessage(RequestMessage::READ, 0, messageData); // READ operation
+}
+
+/**
+ * @brief Builds a request for the availability of a facility on specific days.
+ * 
+ * The days are listed by name in the order of the week.
+ * 
+ * @param facilityName The name of the facility to query availability for.
+ * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::queryAvailability(const std::string &facilityName, uint8_t dayMask)
+{
+    std::string messageData = "facility," + facilityName + ","; // Request availability for the specified facility and days
+    Days::appendMask(dayMask, messageData);
+
+    return RequestMessage(RequestMessage::READ, 0, messageData); // READ operation
+}
+
+/**
+ * @brief Builds a request to book a facility for a specific day and time range.
+ * 
+ * The server expects the hours and minutes of the start and end times as separate two-digit fields.
+ * 
+ * @param facilityName The name of the facility.
+ * @param dayOfWeek The day of the week.
+ * @param startTime The start time.
+ * @param endTime The end time.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::bookFacility(
+    const std::string &facilityName,
+    DayOfWeek dayOfWeek,
+    MinuteOfDay startTime,
+    MinuteOfDay endTime
+)
+{
+    std::array<char, 4> start = startTime.digits();
+    std::array<char, 4> end = endTime.digits();
+    std::string_view dayName = Days::name(dayOfWeek);
+
+    // Booking request for the specified facility, day, and times, as facility,DAY,HH,MM,HH,MM
+    std::string messageData;
+    messageData.reserve(facilityName.size() + dayName.size() + 14);
+    messageData.append(facilityName).append(1, ',').append(dayName);
+    messageData.append({',', start[0], start[1], ',', start[2], start[3], ',', end[0], end[1], ',', end[2], end[3]});
+
+    return RequestMessage(RequestMessage::WRITE, 0, messageData); // WRITE operation
+}
+
+/**
+ * @brief Builds a request for the details of an existing booking.
+ * 
+ * @param bookingID The ID of the booking to query.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::queryBooking(const std::string &bookingID)
+{
+    std::string messageData = "booking," + bookingID; // Request booking details for the specified ID
+
+    return RequestMessage(RequestMessage::READ, 0, messageData); // READ operation
+}
+
+/**
+ * @brief Builds a request to shift an existing booking by a time offset.
+ * 
+ * The new start and end times are calculated from the decoded times of the old booking and the offset.
+ * The request contains the old booking ID, facility name, day of the week, and new times.
+ * 
+ * @param oldBooking The booking to update, as parsed from its details.
+ * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+ * 
+ * @return The request message.
+ * 
+ * @throws std::runtime_error if the booking has no valid day, start or end time.
+ */
+RequestMessage RequestFactory::updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes)
+{
+    if (!oldBooking.day || !oldBooking.start || !oldBooking.end)
+    {
+        throw std::runtime_error("Booking has no valid day, start or end time");
+    }
+
+    // Apply offset
+    int totalStartMinutes = oldBooking.start->minutes() + offsetMinutes;
+    int totalEndMinutes = oldBooking.end->minutes() + offsetMinutes;
+
+    std::string messageData = (
+        "booking," +
+        oldBooking.bookingID + "," +
+        oldBooking.facility + "," +
+        std::string(Days::name(*oldBooking.day)) + "," +
+        std::to_string(totalStartMinutes / 60) + "," +
+        std::to_string(totalStartMinutes % 60) + "," +
+        std::to_string(totalEndMinutes / 60) + "," +
+        std::to_string(totalEndMinutes % 60)
+    );
+
+    return RequestMessage(RequestMessage::UPDATE, 0, messageData); // UPDATE operation
+}
+
+/**
+ * @brief Builds a request to delete an existing booking.
+ * 
+ * @param booking The booking to delete, as parsed from its details.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::deleteBooking(const ResponseParser::Booking &booking)
+{
+    // The facility name of the existing booking is required for the delete booking request
+    std::string messageData = booking.bookingID + "," + booking.facility; // Request to delete the booking with the specified ID and facility name
+
+    return RequestMessage(RequestMessage::DELETE_REQUEST, 0, messageData); // DELETE (enum named as DELETE_REQUEST) operation
+}
+
+/**
+ * @brief Builds a request to register for the availability updates of a facility.
+ * 
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration of the registration in seconds.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::registerMonitor(const std::string &facilityName, int durationSeconds)
+{
+    std::string messageData = "register," + facilityName + "," + std::to_string(durationSeconds); // Request to register for monitoring the specified facility for the specified duration
+
+    return RequestMessage(RequestMessage::MONITOR, 0, messageData); // MONITOR operation
+}
+
+/**
+ * @brief Builds a request to rate a facility.
+ * 
+ * @param facilityName The name of the facility to rate.
+ * @param rating The rating value (e.g., 4.5).
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::rateFacility(const std::string &facilityName, float rating)
+{
+    std::string messageData = "rating," + facilityName + "," + std::to_string(rating); // Request to rate the facility with the specified name and rating
+
+    return RequestMessage(RequestMessage::UPDATE, 0, messageData); // UPDATE operation
+}
+
+/**
+ * @brief Builds a request for the rating of a facility.
+ * 
+ * @param facilityName The name of the facility to query.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::queryRating(const std::string &facilityName)
+{
+    std::string messageData = "rating," + facilityName;
+
+    return RequestMessage(RequestMessage::READ, 0, messageData);
+}
+
+/**
+ * @brief Builds an echo request.
+ * 
+ * @param messageData The message data to be echoed.
+ * 
+ * @return The request message.
+ */
+RequestMessage RequestFactory::echoMessage(const std::string &messageData)
+{
+    return RequestMessage(RequestMessage::ECHO, 0, messageData);
+}
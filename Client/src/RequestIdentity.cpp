@@ -0,0 +1,115 @@
+#include "RequestIdentity.hpp"
+
+#include <chrono>
+#include <random>
+
+/**
+ * @brief Constructs a source with a random nonce, starting at epoch 1.
+ */
+RequestIdentitySource::RequestIdentitySource() : RequestIdentitySource(generateNonce(), 1)
+{
+}
+
+/**
+ * @brief Constructs a source that resumes a known nonce in a given epoch.
+ *
+ * @param clientNonce The nonce of the client instance. Must not be 0.
+ * @param epoch The epoch of the new run, which must be higher than that of any earlier run with the nonce.
+ */
+RequestIdentitySource::RequestIdentitySource(int64_t clientNonce, int32_t epoch)
+    : clientNonce(clientNonce), epoch(epoch), sequence(1), ackedSequence(0)
+{
+}
+
+/**
+ * @brief Allocates the identity of a new request.
+ *
+ * @return The identity.
+ */
+RequestIdentity RequestIdentitySource::next()
+{
+    return {clientNonce, epoch, sequence.fetch_add(1, std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Gets the nonce of the client instance.
+ *
+ * @return The nonce.
+ */
+int64_t RequestIdentitySource::getClientNonce() const
+{
+    return clientNonce;
+}
+
+/**
+ * @brief Gets the current epoch.
+ *
+ * @return The epoch.
+ */
+int32_t RequestIdentitySource::getEpoch() const
+{
+    return epoch;
+}
+
+/**
+ * @brief Records that a request will not be sent again, because it was answered or given up.
+ *
+ * Requests may complete out of order, e.g. when they are pipelined. A completion directly above the watermark
+ * advances it past every consecutive completion recorded earlier; any other completion is kept until the
+ * gap below it closes.
+ *
+ * @param sequence The sequence number of the request.
+ */
+void RequestIdentitySource::complete(int64_t sequence)
+{
+    std::lock_guard<std::mutex> lock(completionMutex);
+
+    int64_t watermark = ackedSequence.load(std::memory_order_relaxed);
+    if (sequence <= watermark)
+    {
+        return;
+    }
+
+    completedAhead.insert(sequence);
+    while (!completedAhead.empty() && *completedAhead.begin() == watermark + 1)
+    {
+        completedAhead.erase(completedAhead.begin());
+        watermark++;
+    }
+
+    ackedSequence.store(watermark, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the acknowledged watermark.
+ *
+ * @return The highest sequence up to which every request has completed, or 0 if there is none.
+ */
+int64_t RequestIdentitySource::getAckedSequence() const
+{
+    return ackedSequence.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Generates a random non-zero nonce.
+ *
+ * The random device is mixed with the clock, as some platforms implement it deterministically.
+ *
+ * @return The nonce.
+ */
+int64_t RequestIdentitySource::generateNonce()
+{
+    std::random_device device;
+    std::seed_seq seed{
+        device(), device(), device(), device(),
+        static_cast<unsigned int>(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+    };
+    std::mt19937_64 generator(seed);
+
+    int64_t nonce = 0;
+    while (nonce == 0)
+    {
+        nonce = static_cast<int64_t>(generator());
+    }
+    return nonce;
+}
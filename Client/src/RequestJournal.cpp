@@ -0,0 +1,480 @@
+#include "RequestJournal.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#include "Constants.hpp"
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Opens the journal at the given path, creating it if needed, and starts a new epoch.
+ *
+ * A new journal gets a random nonce and splits the mapping into two regions of records. Opening an existing
+ * journal increments its epoch, so that the requests of this run never share an identity with those of an
+ * earlier run, including the ones still pending in the journal. The header is written through to disk before
+ * any request is sent in the new epoch.
+ *
+ * @param path The path of the journal file.
+ *
+ * @throws std::runtime_error if the file cannot be opened or mapped, or is not a journal.
+ */
+RequestJournal::RequestJournal(const std::string &path)
+    : mapping(nullptr), capacity(Constants::JOURNAL_CAPACITY), fileHeader{}, regionBegin(sizeof(FileHeader)), regionEnd(sizeof(FileHeader)),
+      tail(sizeof(FileHeader)), syncedOffset(sizeof(FileHeader)), unsyncedRecords(0), clientNonce(0), epoch(0)
+{
+    static_assert(sizeof(FileHeader) % RECORD_ALIGNMENT == 0, "Records must start aligned");
+    static_assert(sizeof(RecordHeader) % RECORD_ALIGNMENT == 0, "Record data must start aligned");
+
+    map(path);
+
+    std::memcpy(&fileHeader, mapping, sizeof(fileHeader));
+
+    if (fileHeader.magic == 0)
+    {
+        uint64_t regionSize = (capacity - sizeof(FileHeader)) / 2 / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+        fileHeader = {FILE_MAGIC, FILE_VERSION, RequestIdentitySource::generateNonce(), 0, 0, regionSize};
+    }
+    else if (fileHeader.magic != FILE_MAGIC || fileHeader.version != FILE_VERSION || fileHeader.regionSize % RECORD_ALIGNMENT != 0 ||
+             fileHeader.regionSize > (capacity - sizeof(FileHeader)) / 2)
+    {
+        unmap();
+        throw std::runtime_error("Not a request journal: " + path);
+    }
+
+    fileHeader.epoch++;
+    writeFileHeader();
+
+    clientNonce = fileHeader.clientNonce;
+    epoch = fileHeader.epoch;
+    selectRegion();
+
+    scan();
+    syncedOffset = tail;
+}
+
+/**
+ * @brief Flushes and unmaps the journal.
+ */
+RequestJournal::~RequestJournal()
+{
+    sync();
+    unmap();
+}
+
+/**
+ * @brief Gets the nonce of the client instance.
+ *
+ * @return The nonce.
+ */
+int64_t RequestJournal::getClientNonce() const
+{
+    return clientNonce;
+}
+
+/**
+ * @brief Gets the epoch started when the journal was opened.
+ *
+ * @return The epoch.
+ */
+int32_t RequestJournal::getEpoch() const
+{
+    return epoch;
+}
+
+/**
+ * @brief Records a request before it is first sent.
+ *
+ * The record lands in the shared mapping, so it survives a crash of the process as soon as this method
+ * returns. It is only handed to the OS for writing to disk every JOURNAL_SYNC_BATCH records, without waiting,
+ * which keeps an append in the order of microseconds; call sync() to also survive a crash of the machine.
+ *
+ * @param requestID The request ID of the request.
+ * @param identity The identity of the request.
+ * @param data The serialized request.
+ *
+ * @throws std::runtime_error if the request does not fit in the journal.
+ */
+void RequestJournal::append(int32_t requestID, const RequestIdentity &identity, const std::vector<uint8_t> &data)
+{
+    RecordHeader header{0, REQUEST, static_cast<uint32_t>(data.size()), requestID, identity.epoch, 0, identity.sequence};
+    size_t offset = writeRecord(header, data.data());
+    pending[{identity.epoch, identity.sequence}] = offset;
+}
+
+/**
+ * @brief Records that a request will not be sent again.
+ *
+ * Requests that were never journaled are ignored.
+ *
+ * @param identity The identity of the request.
+ *
+ * @throws std::runtime_error if the record does not fit in the journal.
+ */
+void RequestJournal::complete(const RequestIdentity &identity)
+{
+    auto it = pending.find({identity.epoch, identity.sequence});
+    if (it == pending.end())
+    {
+        return;
+    }
+
+    pending.erase(it);
+
+    RecordHeader header{0, COMPLETION, 0, 0, identity.epoch, 0, identity.sequence};
+    writeRecord(header, nullptr);
+}
+
+/**
+ * @brief Gets the requests that have not completed, in the order they were recorded.
+ *
+ * @return The requests.
+ */
+std::vector<RequestJournal::Entry> RequestJournal::getPending() const
+{
+    std::vector<size_t> offsets;
+    for (const auto &[key, offset] : pending)
+    {
+        offsets.push_back(offset);
+    }
+    std::sort(offsets.begin(), offsets.end());
+
+    std::vector<Entry> entries;
+    for (size_t offset : offsets)
+    {
+        RecordHeader header;
+        std::memcpy(&header, mapping + offset, sizeof(header));
+
+        const uint8_t *data = mapping + offset + sizeof(header);
+        entries.push_back({header.requestID, {clientNonce, header.epoch, header.sequence}, std::vector<uint8_t>(data, data + header.length)});
+    }
+    return entries;
+}
+
+/**
+ * @brief Writes the records appended so far to disk and waits for the write to finish.
+ */
+void RequestJournal::sync()
+{
+    flush(regionBegin, tail, true);
+    syncedOffset = tail;
+    unsyncedRecords = 0;
+}
+
+/**
+ * @brief Maps the file at the given path, extending it to the journal capacity.
+ *
+ * The bytes added by extending the file read as zero, which marks the end of the records.
+ * Files larger than the capacity, e.g. from a build with a larger JOURNAL_CAPACITY, are mapped whole.
+ *
+ * @param path The path of the journal file.
+ *
+ * @throws std::runtime_error if the file cannot be opened, extended or mapped.
+ */
+void RequestJournal::map(const std::string &path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        throw std::runtime_error("Error opening request journal " + path + ": " + std::to_string(GetLastError()));
+    }
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && static_cast<uint64_t>(size.QuadPart) > capacity)
+    {
+        capacity = static_cast<size_t>(size.QuadPart);
+    }
+
+    uint64_t mappingSize = capacity;
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, static_cast<DWORD>(mappingSize >> 32), static_cast<DWORD>(mappingSize), nullptr);
+    if (fileMapping == nullptr)
+    {
+        DWORD error = GetLastError();
+        CloseHandle(file);
+        throw std::runtime_error("Error mapping request journal " + path + ": " + std::to_string(error));
+    }
+
+    void *view = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, capacity);
+    if (view == nullptr)
+    {
+        DWORD error = GetLastError();
+        CloseHandle(fileMapping);
+        CloseHandle(file);
+        throw std::runtime_error("Error mapping request journal " + path + ": " + std::to_string(error));
+    }
+
+    fileHandle = file;
+    mappingHandle = fileMapping;
+    mapping = static_cast<uint8_t *>(view);
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Error opening request journal " + path + ": " + std::strerror(errno));
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) != 0)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Error opening request journal " + path + ": " + std::strerror(error));
+    }
+
+    if (static_cast<size_t>(status.st_size) > capacity)
+    {
+        capacity = static_cast<size_t>(status.st_size);
+    }
+    else if (static_cast<size_t>(status.st_size) < capacity && ftruncate(fd, static_cast<off_t>(capacity)) != 0)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Error extending request journal " + path + ": " + std::strerror(error));
+    }
+
+    void *view = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED)
+    {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Error mapping request journal " + path + ": " + std::strerror(error));
+    }
+
+    mapping = static_cast<uint8_t *>(view);
+#endif
+}
+
+/**
+ * @brief Unmaps and closes the file.
+ */
+void RequestJournal::unmap()
+{
+    if (mapping == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+#else
+    munmap(mapping, capacity);
+    ::close(fd);
+#endif
+
+    mapping = nullptr;
+}
+
+/**
+ * @brief Reads the records, rebuilding the set of pending requests and finding the tail.
+ *
+ * A request is pending until a completion record with the same epoch and sequence follows it. The scan stops
+ * at the first header without a marker, which is either the cleared space past the last record or a record
+ * torn by a crash; the next record overwrites it.
+ */
+void RequestJournal::scan()
+{
+    pending.clear();
+
+    size_t offset = regionBegin;
+    while (offset + sizeof(RecordHeader) <= regionEnd)
+    {
+        RecordHeader header;
+        std::memcpy(&header, mapping + offset, sizeof(header));
+
+        if (header.marker != RECORD_MARKER || recordSize(header.length) > regionEnd - offset)
+        {
+            break;
+        }
+
+        if (header.type == REQUEST)
+        {
+            pending[{header.epoch, header.sequence}] = offset;
+        }
+        else if (header.type == COMPLETION)
+        {
+            pending.erase({header.epoch, header.sequence});
+        }
+
+        offset += recordSize(header.length);
+    }
+
+    tail = offset;
+}
+
+/**
+ * @brief Writes a record at the tail, compacting the journal first if it does not fit.
+ *
+ * The marker is written last, after a release fence, so a record torn by a crash is never read back. The
+ * header after the record is cleared first, as it may hold bytes of such a torn record.
+ *
+ * @param header The header of the record. Its marker is set by this method.
+ * @param data The serialized request, or nullptr for a completion.
+ *
+ * @return The offset of the record.
+ *
+ * @throws std::runtime_error if the record does not fit even after compacting.
+ */
+size_t RequestJournal::writeRecord(RecordHeader header, const uint8_t *data)
+{
+    size_t size = recordSize(header.length);
+    if (size > regionEnd - tail)
+    {
+        compact();
+        if (size > regionEnd - tail)
+        {
+            throw std::runtime_error("Request journal is full");
+        }
+    }
+
+    size_t offset = tail;
+    header.marker = 0;
+    std::memcpy(mapping + offset, &header, sizeof(header));
+    if (header.length > 0)
+    {
+        std::memcpy(mapping + offset + sizeof(header), data, header.length);
+    }
+
+    if (offset + size + sizeof(uint32_t) <= regionEnd)
+    {
+        std::memset(mapping + offset + size, 0, sizeof(uint32_t));
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    const uint32_t marker = RECORD_MARKER;
+    std::memcpy(mapping + offset, &marker, sizeof(marker));
+
+    tail = offset + size;
+
+    if (++unsyncedRecords >= Constants::JOURNAL_SYNC_BATCH)
+    {
+        flush(syncedOffset, tail, false);
+        syncedOffset = tail;
+        unsyncedRecords = 0;
+    }
+
+    return offset;
+}
+
+/**
+ * @brief Copies the pending requests to the other region and switches to it, dropping every other record.
+ *
+ * Only happens when the region is full, which takes thousands of requests as completed ones are dropped
+ * here. The copies are written through to disk before the generation in the file header is incremented, and
+ * the header is written through before any further record is appended. A crash before the header reaches the
+ * disk leaves the old region in use, with every record intact; the header is smaller than a disk sector, so
+ * it is never written in part.
+ */
+void RequestJournal::compact()
+{
+    size_t otherBegin = regionBegin == sizeof(FileHeader) ? regionEnd : sizeof(FileHeader);
+
+    std::vector<std::pair<size_t, std::pair<int32_t, int64_t>>> records;
+    for (const auto &[key, offset] : pending)
+    {
+        records.push_back({offset, key});
+    }
+    std::sort(records.begin(), records.end());
+
+    std::vector<uint8_t> image;
+    std::map<std::pair<int32_t, int64_t>, size_t> moved;
+    for (const auto &[offset, key] : records)
+    {
+        RecordHeader header;
+        std::memcpy(&header, mapping + offset, sizeof(header));
+
+        moved[key] = otherBegin + image.size();
+        image.insert(image.end(), mapping + offset, mapping + offset + recordSize(header.length));
+    }
+
+    // The other region still holds the records of two generations ago; clearing the marker past the copies ends them
+    size_t newTail = otherBegin + image.size();
+    size_t clearedEnd = std::min<size_t>(newTail + sizeof(uint32_t), otherBegin + fileHeader.regionSize);
+    std::memcpy(mapping + otherBegin, image.data(), image.size());
+    std::memset(mapping + newTail, 0, clearedEnd - newTail);
+    flush(otherBegin, clearedEnd, true);
+
+    fileHeader.generation++;
+    writeFileHeader();
+    selectRegion();
+
+    pending = std::move(moved);
+    tail = newTail;
+    syncedOffset = tail;
+    unsyncedRecords = 0;
+}
+
+/**
+ * @brief Selects the region of the generation in the file header.
+ */
+void RequestJournal::selectRegion()
+{
+    regionBegin = sizeof(FileHeader) + (fileHeader.generation & 1) * fileHeader.regionSize;
+    regionEnd = regionBegin + fileHeader.regionSize;
+}
+
+/**
+ * @brief Writes the file header through to disk.
+ */
+void RequestJournal::writeFileHeader()
+{
+    std::memcpy(mapping, &fileHeader, sizeof(fileHeader));
+    flush(0, sizeof(fileHeader), true);
+}
+
+/**
+ * @brief Hands the given range of the mapping to the OS for writing.
+ *
+ * Failures are reported but not thrown: the records are still in the shared mapping, and the OS writes them
+ * back eventually.
+ *
+ * @param begin The offset of the first byte.
+ * @param end The offset past the last byte.
+ * @param wait Whether to wait for the write to finish.
+ */
+void RequestJournal::flush(size_t begin, size_t end, bool wait)
+{
+    if (mapping == nullptr || end <= begin)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    bool flushed = FlushViewOfFile(mapping + begin, end - begin) && (!wait || FlushFileBuffers(fileHandle));
+#else
+    // msync() takes a page-aligned address
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t alignedBegin = begin - begin % pageSize;
+    bool flushed = msync(mapping + alignedBegin, end - alignedBegin, wait ? MS_SYNC : MS_ASYNC) == 0;
+#endif
+
+    if (!flushed)
+    {
+        std::cerr << "Error flushing request journal" << std::endl;
+    }
+}
+
+/**
+ * @brief Gets the size a record occupies in the journal.
+ *
+ * @param length The number of bytes of serialized request.
+ *
+ * @return The size including the header and the alignment padding.
+ */
+size_t RequestJournal::recordSize(size_t length)
+{
+    return (sizeof(RecordHeader) + length + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
@@ -3,21 +3,22 @@
 /**
  * @brief Default constructor for RequestMessage.
  * 
- * Initializes the request type and ID to 0 and the data to an empty string.
+ * Initializes the request type and ID to 0, the data to an empty string and the identity and acknowledgement to none.
  */
-RequestMessage::RequestMessage() : requestType(0), requestID(0), data("") {}
+RequestMessage::RequestMessage() : requestType(0), requestID(0), data(""), clientNonce(0), epoch(0), sequence(0), ackedSequence(0) {}
 
 /**
  * @brief Parameterized constructor for RequestMessage.
  * 
  * This constructor is used to create request messages with specific parameters.
+ * The identity is left empty until the client assigns one with setIdentity().
  * 
  * @param requestType The type of request (e.g., READ, WRITE, etc.).
  * @param requestID The unique identifier for the request.
  * @param data The associated data for the request.
  */
 RequestMessage::RequestMessage(int requestType, int requestID, const std::string &data)
-    : requestType(requestType), requestID(requestID), data(data) {}
+    : requestType(requestType), requestID(requestID), data(data), clientNonce(0), epoch(0), sequence(0), ackedSequence(0) {}
 
 /**
  * @brief Gets the Java class name for serialization.
@@ -43,7 +44,11 @@ std::vector<std::pair<std::string, std::string>> RequestMessage::getFieldMetadat
     return {
         {"requestType", "int"},
         {"requestID", "int"},
-        {"data", "java.lang.String"}
+        {"data", "java.lang.String"},
+        {"clientNonce", "long"},
+        {"epoch", "int"},
+        {"sequence", "long"},
+        {"ackedSequence", "long"}
     };
 }
 
@@ -68,6 +73,11 @@ void RequestMessage::serializeFieldValues(ByteBuffer &buffer) const
         buffer.writeByte(1);
         buffer.writeString(data);
     }
+
+    buffer.writeLong(clientNonce);
+    buffer.writeInt(epoch);
+    buffer.writeLong(sequence);
+    buffer.writeLong(ackedSequence);
 }
 
 /**
@@ -91,6 +101,11 @@ void RequestMessage::deserializeFields(ByteReader &reader)
     {
         data = "";
     }
+
+    clientNonce = reader.readLong();
+    epoch = reader.readInt();
+    sequence = reader.readLong();
+    ackedSequence = reader.readLong();
 }
 
 /**
@@ -123,6 +138,26 @@ std::string RequestMessage::getData() const
     return data;
 }
 
+/**
+ * @brief Gets the globally unique identity of the request.
+ * 
+ * @return The identity, with a client nonce of 0 if the request has none.
+ */
+RequestIdentity RequestMessage::getIdentity() const
+{
+    return {clientNonce, epoch, sequence};
+}
+
+/**
+ * @brief Gets the cumulative acknowledgement carried by the request.
+ * 
+ * @return The sequence up to which the client has received or given up every reply, or 0 if there is none.
+ */
+int64_t RequestMessage::getAckedSequence() const
+{
+    return ackedSequence;
+}
+
 /**
  * @brief Sets the request type.
  * 
@@ -152,3 +187,25 @@ void RequestMessage::setData(const std::string &d)
 {
     data = d;
 }
+
+/**
+ * @brief Sets the globally unique identity of the request.
+ * 
+ * @param identity The identity.
+ */
+void RequestMessage::setIdentity(const RequestIdentity &identity)
+{
+    clientNonce = identity.clientNonce;
+    epoch = identity.epoch;
+    sequence = identity.sequence;
+}
+
+/**
+ * @brief Sets the cumulative acknowledgement carried by the request.
+ * 
+ * @param sequence The sequence up to which the client has received or given up every reply.
+ */
+void RequestMessage::setAckedSequence(int64_t sequence)
+{
+    ackedSequence = sequence;
+}
@@ -1,598 +1,498 @@
 #include "ResponseParser.hpp"
 
-#include <iostream>
-#include <sstream>
-#include <unordered_set>
-
-#include "Constants.hpp"
-#include "Serializer.hpp"
+#include <algorithm>
+#include <charconv>
 
 /**
- * @brief Parses the response for querying facility names.
- * 
- * This function takes the raw server response as input and parses it to extract facility names.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed facility names.
- * 
+ * @brief Parses only the status of a response, for callers that need nothing else of it.
+ *
+ * Only the status line and, for errors, the message line are read.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed facility names or an error message.
+ *
+ * @return The error, or no error if the response reports success.
+ */
+ResponseParser::Error ResponseParser::parseStatus(std::string_view response)
+{
+    Error error;
+    ResponseTokenizer lines(response);
+    parseError(lines, error);
+    return error;
+}
+
+/**
+ * @brief Maps the message of an error to its code.
+ *
+ * The messages are those the server sends and those the clients return in its format. Messages are compared
+ * whole, apart from those into which the server formats details, which are compared up to the details.
+ *
+ * @param message The message of the server or of the client.
+ *
+ * @return The code, or SERVER_ERROR for messages that are not known.
  */
-std::vector<std::string> ResponseParser::parseQueryFacilityNamesResponse(const std::string &response)
+ResponseParser::Error::Code ResponseParser::classifyError(std::string_view message)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
+    struct KnownMessage
+    {
+        std::string_view text; ///< The message, or its start if isPrefix is set.
+        bool isPrefix; ///< Whether the message continues with details.
+        Error::Code code; ///< The code of the message.
+    };
 
-    if (isErrorResponse(responseStream))
+    static const KnownMessage KNOWN_MESSAGES[] = {
+        {Constants::REQUEST_FAILED_MESSAGE, false, Error::TIMEOUT},
+        {Constants::SLOT_UNAVAILABLE_MESSAGE, false, Error::SLOT_UNAVAILABLE},
+        {"Facility not found", false, Error::FACILITY_NOT_FOUND},
+        {"Booking not found", false, Error::BOOKING_NOT_FOUND},
+        {"Booking not successful or booking by ", true, Error::BOOKING_NOT_FOUND},
+        {"Bad request", false, Error::INVALID_REQUEST},
+        {"Invalid request format", false, Error::INVALID_REQUEST},
+        {"Invalid update type", false, Error::INVALID_REQUEST},
+        {"Invalid facilityName provided", false, Error::INVALID_REQUEST},
+        {"Unknown operation", false, Error::INVALID_REQUEST},
+        {"Error parsing booking details", true, Error::INVALID_REQUEST},
+        {"Request already acknowledged", false, Error::ALREADY_ACKNOWLEDGED},
+    };
+
+    for (const KnownMessage &known : KNOWN_MESSAGES)
     {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
+        if (known.isPrefix ? message.starts_with(known.text) : message == known.text)
         {
-            errorMessage = line.substr(8); // Remove "message:" prefix
+            return known.code;
         }
-
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
     }
-    else
+    return Error::SERVER_ERROR;
+}
+
+/**
+ * @brief Parses the response for querying facility names.
+ *
+ * This function takes the raw server response as input and parses it to extract facility names.
+ * If the response indicates an error, it extracts the error message instead.
+ *
+ * @param response The raw server response.
+ *
+ * @return The facility names or the error.
+ */
+ResponseParser::FacilityList ResponseParser::parseQueryFacilityNamesResponse(std::string_view response)
+{
+    FacilityList facilityList;
+    ResponseTokenizer lines(response);
+
+    if (parseError(lines, facilityList.error))
     {
-        parsedResponse.push_back("Facility Names");
+        return facilityList;
+    }
 
-        // Add comma-separated facility names to the parsed response
-        std::string line;
-        while (std::getline(responseStream, line))
+    std::string_view line;
+    while (lines.next(line))
+    {
+        if (ResponseTokenizer::stripKey(line, "facilityNames:"))
         {
-            if (line.find("facilityNames:") == 0)
+            // Split the facility names by comma
+            ResponseTokenizer facilityNames(line, ',');
+            std::string_view facilityName;
+            while (facilityNames.next(facilityName))
             {
-                // Extract the list of facility names
-                std::string facilityNames = line.substr(14); // Remove "facilityNames:" prefix
-                std::istringstream facilityNamesStream(facilityNames);
-                std::string facilityName;
-
-                // Split the facility names by comma
-                while (std::getline(facilityNamesStream, facilityName, ','))
+                if (!facilityName.empty())
                 {
-                    if (!facilityName.empty())
-                    {
-                        parsedResponse.push_back(facilityName);
-                    }
+                    facilityList.names.emplace_back(facilityName);
                 }
             }
         }
     }
 
-    return parsedResponse;
+    return facilityList;
 }
 
 /**
  * @brief Parses the response for querying facility availability.
- * 
- * This function takes the raw server response and an optional list of requested days as input.
- * It parses the response to extract availability information for the specified days.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed availability information.
- * 
+ *
+ * This function takes the raw server response as input and parses it to extract the facility name and
+ * the free periods of the listed days of the mask. Lines of other days are skipped once their day name
+ * is read, and lines of unknown days are ignored. The timeslot lists of the remaining days are copied
+ * without being split, and are decoded by Availability::timeslots() when they are used.
+ * If the response indicates an error, it extracts the error message instead.
+ * Monitoring updates have the same format and are parsed by this function too.
+ *
  * @param response The raw server response.
- * @param daysRequested A comma-separated list of days to filter availability (optional).
- * 
- * @return A vector of strings containing the parsed availability information or an error message.
+ * @param dayMask The days to parse, with the bit of each day set.
+ *
+ * @return The availability of the listed days of the mask or the error.
  */
-std::vector<std::string> ResponseParser::parseQueryAvailabilityResponse(
-    const std::string &response,
-    const std::string &daysRequested
-)
+ResponseParser::Availability ResponseParser::parseQueryAvailabilityResponse(std::string_view response, uint8_t dayMask)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
-
-    bool filterDays = !daysRequested.empty(); // Only filter if daysRequested is not empty
-    std::unordered_set<std::string> requestedDaysSet;
+    Availability availability;
+    availability.requestedDays = dayMask & Constants::ALL_DAYS_MASK;
+    ResponseTokenizer lines(response);
 
-    if (filterDays)
+    if (parseError(lines, availability.error))
     {
-        std::istringstream daysStream(daysRequested);
-        std::string dayToken;
-        while (std::getline(daysStream, dayToken, ','))
-        {
-            requestedDaysSet.insert(dayToken);
-        }
+        return availability;
     }
 
-    std::unordered_map<std::string, std::string> availabilityMap;
-
-    if (isErrorResponse(responseStream))
+    std::string_view line;
+    while (lines.next(line))
     {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
+        // Extract facility name
+        if (ResponseTokenizer::stripKey(line, "facility:"))
         {
-            errorMessage = line.substr(8); // Remove "message:" prefix
+            availability.facility = line;
+            continue;
         }
 
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
-    }
-    else
-    {
-        parsedResponse.push_back("Facility Availability");
-
-        std::string line;
-        while (std::getline(responseStream, line))
+        // Each day line starts with the day name, which is all that is read of the lines of other days
+        size_t colonPos = std::min(line.find(':'), line.size());
+        std::optional<DayOfWeek> day = Days::parse(line.substr(0, colonPos));
+        if (!day || !(availability.requestedDays & Days::bit(*day)))
         {
-            // Extract facility name
-            if (line.find("facility:") == 0)
-            {
-                // Remove "facility:" prefix
-                parsedResponse.push_back("Facility: " + line.substr(9));
-                continue;
-            }
-
-            // Skip the header line
-            if (line.find("availableTimeslots:") == 0)
-            {
-                continue;
-            }
-
-            // Parse each day's availability
-            std::istringstream lineStream(line);
-            std::string day, timeslot, formattedTimeslots;
-            if (std::getline(lineStream, day, ':'))
-            {
-                formattedTimeslots = day + ": ";
+            continue;
+        }
 
-                while (std::getline(lineStream, timeslot, ','))
-                {
-                    if (!timeslot.empty())
-                    {
-                        size_t dashPos = timeslot.find('-');
-                        if (dashPos != std::string::npos)
-                        {
-                            timeslot.replace(dashPos, 1, "to");
-                        }
-
-                        formattedTimeslots += (timeslot + ", ");
-                    }
-                }
+        std::string_view timeslots = line.substr(std::min(colonPos + 1, line.size()));
+        availability.listedDays |= Days::bit(*day);
+        availability.dayText[Days::index(*day)] = {static_cast<uint32_t>(availability.timeslotText.size()), static_cast<uint32_t>(timeslots.size())};
+        availability.timeslotText.append(timeslots);
+    }
 
-                // Remove trailing comma and space
-                if (formattedTimeslots.size() > 2)
-                {
-                    formattedTimeslots.erase(formattedTimeslots.size() - 2, 2);
-                }
+    return availability;
+}
 
-                // Add formatted timeslots to parsed response
-                availabilityMap[day] = formattedTimeslots;
-                // parsedResponse.push_back(formattedTimeslots);
-            }
-        }
+/**
+ * @brief Decodes the free periods of a day.
+ *
+ * The timeslot list of the day is split and its times converted on every call, so callers that use a day
+ * more than once should keep the result. Timeslots without a valid start and end are left out.
+ *
+ * @param day The day.
+ *
+ * @return The free periods in the order of the server, or none if the day was not listed.
+ */
+std::vector<ResponseParser::Timeslot> ResponseParser::Availability::timeslots(DayOfWeek day) const
+{
+    std::vector<Timeslot> decoded;
+    if (!isListed(day))
+    {
+        return decoded;
+    }
 
-        // Only filter days if requested by user
-        if (filterDays)
-        {
-            for (const std::string &day : Constants::DAYS_OF_WEEK)
-            {
-                if (requestedDaysSet.count(day))
-                {
-                    if (availabilityMap.find(day) != availabilityMap.end())
-                    {
-                        parsedResponse.push_back(availabilityMap[day]);
-                    }
-                    else
-                    {
-                        parsedResponse.push_back(day + ": Closed");
-                    }
-                }
-            }
-        }
-        else
+    const std::pair<uint32_t, uint32_t> &range = dayText[Days::index(day)];
+    ResponseTokenizer timeslotList(std::string_view(timeslotText).substr(range.first, range.second), ',');
+    std::string_view text;
+    Timeslot timeslot;
+    while (timeslotList.next(text))
+    {
+        if (parseTimeslot(text, timeslot))
         {
-            for (const std::string &day : Constants::DAYS_OF_WEEK)
-            {
-                if (availabilityMap.find(day) != availabilityMap.end())
-                {
-                    parsedResponse.push_back(availabilityMap[day]);
-                }
-            }
+            decoded.push_back(timeslot);
         }
     }
-
-    return parsedResponse;
+    return decoded;
 }
 
 /**
  * @brief Parses the response for booking a facility.
- * 
+ *
  * The server returns the same message structure upon successful booking and querying booking details.
  * Hence, this function is identical to parseQueryBookingResponse() and serves only as a wrapper.
- * 
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed booking details or an error message.
+ *
+ * @return The booking or the error.
  */
-std::vector<std::string> ResponseParser::parseBookFacilityResponse(const std::string &response)
+ResponseParser::Booking ResponseParser::parseBookFacilityResponse(std::string_view response)
 {
     // Both queryBooking and bookFacility responses are the same
-    return parseQueryBookingResponse(response);
+    return parseBooking(response);
 }
 
 /**
  * @brief Parses the response for querying booking details.
- * 
+ *
  * This function takes the raw server response as input and parses it to extract booking details.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed booking details.
- * 
+ * If the response indicates an error, it extracts the error message instead.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed booking details or an error message.
+ *
+ * @return The booking or the error.
  */
-std::vector<std::string> ResponseParser::parseQueryBookingResponse(const std::string &response)
+ResponseParser::Booking ResponseParser::parseQueryBookingResponse(std::string_view response)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
-
-    if (isErrorResponse(responseStream))
-    {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
-        {
-            errorMessage = line.substr(8); // Remove "message:" prefix
-        }
-
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
-    }
-    else
-    {
-        std::string line, bookingID, userInfo, facility, day, startTime, endTime;
-        while (std::getline(responseStream, line))
-        {
-            if (line.find("bookingID:") == 0)
-            {
-                bookingID = line.substr(10); // Remove "bookingID:" prefix
-            }
-            else if (line.find("user:") == 0)
-            {
-                userInfo = line.substr(5); // Remove "user:" prefix
-            }
-            else if (line.find("facility:") == 0)
-            {
-                facility = line.substr(9); // Remove "facility:" prefix
-            }
-            else if (line.find("day:") == 0)
-            {
-                day = line.substr(4); // Remove "day:" prefix
-            }
-            else if (line.find("startTime:") == 0)
-            {
-                startTime = line.substr(10); // Remove "startTime:" prefix
-            }
-            else if (line.find("endTime:") == 0)
-            {
-                endTime = line.substr(8);// Remove "endTime:" prefix
-            }
-        }
-
-        // Push elements into parsedResponse in the desired order
-        parsedResponse.push_back("Booking Details");
-        parsedResponse.push_back("Booking ID: " + bookingID);
-        parsedResponse.push_back("User: " + userInfo);
-        parsedResponse.push_back("Facility: " + facility);
-        parsedResponse.push_back("Day: " + day);
-        parsedResponse.push_back("Start Time: " + startTime);
-        parsedResponse.push_back("End Time: " + endTime);
-    }
-
-    return parsedResponse;
+    return parseBooking(response);
 }
 
 /**
  * @brief Parses the response for updating a booking.
- * 
+ *
  * This function takes the raw server response as input and parses it to extract updated booking details.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed updated booking details.
- * 
+ * The new booking ID is stored as the booking ID and the replaced one as the old booking ID.
+ * If the response indicates an error, it extracts the error message instead.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed updated booking details or an error message.
+ *
+ * @return The updated booking or the error.
  */
-std::vector<std::string> ResponseParser::parseUpdateBookingResponse(const std::string &response)
+ResponseParser::Booking ResponseParser::parseUpdateBookingResponse(std::string_view response)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
+    return parseBooking(response);
+}
 
-    if (isErrorResponse(responseStream))
-    {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
-        {
-            errorMessage = line.substr(8); // Remove "message:" prefix
-        }
+/**
+ * @brief Parses the response for deleting a booking.
+ *
+ * This function takes the raw server response as input and parses it to extract the ID and user of the
+ * deleted booking. If the response indicates an error, it extracts the error message instead.
+ *
+ * @param response The raw server response.
+ *
+ * @return The ID and user of the deleted booking or the error.
+ */
+ResponseParser::Booking ResponseParser::parseDeleteBookingResponse(std::string_view response)
+{
+    return parseBooking(response);
+}
+
+/**
+ * @brief Parses the response for monitoring facility availability.
+ *
+ * This function takes the raw server response as input and parses it to extract monitoring registration details.
+ * If the response indicates an error, it extracts the error message instead.
+ *
+ * @param response The raw server response.
+ *
+ * @return The registration or the error.
+ */
+ResponseParser::MonitorRegistration ResponseParser::parseMonitorAvailabilityResponse(std::string_view response)
+{
+    MonitorRegistration registration;
+    ResponseTokenizer lines(response);
 
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
+    if (parseError(lines, registration.error))
+    {
+        return registration;
     }
-    else
+
+    std::string_view line;
+    while (lines.next(line))
     {
-        std::string line, oldBookingID, newBookingID, userInfo, facility, day, startTime, endTime;
-        while (std::getline(responseStream, line))
+        if (ResponseTokenizer::stripKey(line, "facility:"))
         {
-            if (line.find("oldBookingID:") == 0)
-            {
-                oldBookingID = line.substr(13); // Remove "oldBookingID:" prefix
-            }
-            else if (line.find("newBookingID:") == 0)
-            {
-                newBookingID = line.substr(13); // Remove "newBookingID:" prefix
-            }
-            else if (line.find("user:") == 0)
-            {
-                userInfo = line.substr(5); // Remove "user:" prefix
-            }
-            else if (line.find("facility:") == 0)
-            {
-                facility = line.substr(9); // Remove "facility:" prefix
-            }
-            else if (line.find("day:") == 0)
-            {
-                day = line.substr(4); // Remove "day:" prefix
-            }
-            else if (line.find("startTime:") == 0)
-            {
-                startTime = line.substr(10); // Remove "startTime:" prefix
-            }
-            else if (line.find("endTime:") == 0)
-            {
-                endTime = line.substr(8); // Remove "endTime:" prefix
-            }
+            registration.facility = line;
+        }
+        else if (ResponseTokenizer::stripKey(line, "interval:"))
+        {
+            std::from_chars(line.data(), line.data() + line.size(), registration.intervalSeconds);
         }
-
-        parsedResponse.push_back("New Booking Details");
-        parsedResponse.push_back("New Booking ID: " + newBookingID);
-        parsedResponse.push_back("User: " + userInfo);
-        parsedResponse.push_back("Facility: " + facility);
-        parsedResponse.push_back("New Day: " + day);
-        parsedResponse.push_back("New Start Time: " + startTime);
-        parsedResponse.push_back("New End Time: " + endTime);
     }
 
-    return parsedResponse;
+    return registration;
 }
 
 /**
- * @brief Parses the response for deleting a booking.
- * 
- * This function takes the raw server response as input and parses it to extract deletion confirmation.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed deletion confirmation.
- * 
+ * @brief Parses the response for adding a rating to a facility.
+ *
+ * The confirmation carries the user in addition to the fields of a rating query,
+ * so this function is identical to parseQueryRatingResponse() and serves only as a wrapper.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed deletion confirmation or an error message.
+ *
+ * @return The rating added or the error.
  */
-std::vector<std::string> ResponseParser::parseDeleteBookingResponse(const std::string &response)
+ResponseParser::Rating ResponseParser::parseRateFacilityResponse(std::string_view response)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
+    return parseQueryRatingResponse(response);
+}
 
-    if (isErrorResponse(responseStream))
-    {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
-        {
-            errorMessage = line.substr(8); // Remove "message:" prefix
-        }
+/**
+ * @brief Parses the response for querying the rating of a facility.
+ *
+ * This function takes the raw server response as input and parses it to extract the rating.
+ * If the response indicates an error, it extracts the error message instead.
+ *
+ * @param response The raw server response.
+ *
+ * @return The rating or the error.
+ */
+ResponseParser::Rating ResponseParser::parseQueryRatingResponse(std::string_view response)
+{
+    Rating rating;
+    ResponseTokenizer lines(response);
 
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
+    if (parseError(lines, rating.error))
+    {
+        return rating;
     }
-    else
+
+    std::string_view line;
+    while (lines.next(line))
     {
-        std::string line, oldBookingID, userInfo;
-        while (std::getline(responseStream, line))
+        if (ResponseTokenizer::stripKey(line, "user:"))
         {
-            if (line.find("bookingID:") == 0)
-            {
-                oldBookingID = line.substr(10); // Remove "bookingID:" prefix
-            }
-            else if (line.find("user:") == 0)
-            {
-                userInfo = line.substr(5); // Remove "user:" prefix
-            }
+            rating.user = line;
+        }
+        else if (ResponseTokenizer::stripKey(line, "facility:"))
+        {
+            rating.facility = line;
+        }
+        else if (ResponseTokenizer::stripKey(line, "rating:"))
+        {
+            std::from_chars(line.data(), line.data() + line.size(), rating.rating);
         }
-
-        parsedResponse.push_back("Booking Deleted");
-        parsedResponse.push_back("Old Booking ID: " + oldBookingID);
-        parsedResponse.push_back("User: " + userInfo);
     }
 
-    return parsedResponse;
+    return rating;
 }
 
 /**
- * @brief Parses the response for monitoring facility availability.
- * 
- * This function takes the raw server response as input and parses it to extract monitoring registration details.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed monitoring registration details.
- * 
+ * @brief Parses the response for echoing a message.
+ *
+ * The server returns the message as it was sent, so the response is the message.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed monitoring registration details or an error message.
+ *
+ * @return The echoed message.
  */
-std::vector<std::string> ResponseParser::parseMonitorAvailabilityResponse(const std::string &response)
+std::string ResponseParser::parseEchoMessageResponse(std::string_view response)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
+    return std::string(response);
+}
 
-    if (isErrorResponse(responseStream))
+/**
+ * @brief Checks if the response indicates an error and parses it if so.
+ *
+ * This function reads the first line of the response, its status line, and checks if it indicates an error.
+ * The line after the status line of an error carries the error message, from which the code of the error is
+ * mapped. If it is missing, the message is empty and the code is SERVER_ERROR.
+ *
+ * @param lines The tokenizer over the lines of the response, advanced past the status line and, for errors, the message.
+ * @param error Set to the error if the response indicates one.
+ *
+ * @return True if the response indicates an error, false otherwise.
+ */
+bool ResponseParser::parseError(ResponseTokenizer &lines, Error &error)
+{
+    std::string_view line;
+    if (!lines.next(line) || !line.starts_with(Constants::STATUS_ERROR))
     {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
-        {
-            errorMessage = line.substr(8); // Remove "message:" prefix
-        }
-
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
+        return false;
     }
-    else
-    {
-        std::string line, facility, duration;
-        while (std::getline(responseStream, line))
-        {
-            if (line.find("facility:") == 0)
-            {
-                facility = line.substr(9); // Remove "facility:" prefix
-            }
-            else if (line.find("interval:") == 0)
-            {
-                duration = line.substr(9); // Remove "interval:" prefix
-            }
-        }
 
-        parsedResponse.push_back("Monitoring Registration");
-        parsedResponse.push_back("Facility: " + facility);
-        parsedResponse.push_back("Duration: " + duration + "s");
+    error.code = Error::SERVER_ERROR;
+    if (lines.next(line) && ResponseTokenizer::stripKey(line, "message:"))
+    {
+        error.message = line;
+        error.code = classifyError(line);
     }
-
-    return parsedResponse;
+    return true;
 }
 
 /**
- * @brief Parses the response for adding a rating to a facility.
- * 
- * This function takes the raw server response as input and parses it to extract rating confirmation.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed rating confirmation.
- * 
+ * @brief Parses any booking reply in a single pass.
+ *
+ * Bookings, queries, updates and deletions are answered with subsets of the same keys, so one decoder serves
+ * them all. Each line is split once at its colon and dispatched on its key, and the day and times are
+ * decoded as they are read. The new booking ID of an update is stored as the booking ID.
+ *
  * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed rating confirmation or an error message.
+ *
+ * @return The fields of the booking the response carries, or the error.
  */
-std::vector<std::string> ResponseParser::parseRateFacilityResponse(const std::string &response)
+ResponseParser::Booking ResponseParser::parseBooking(std::string_view response)
 {
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
+    Booking booking;
+    ResponseTokenizer lines(response);
 
-    if (isErrorResponse(responseStream))
+    if (parseError(lines, booking.error))
     {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
-        {
-            errorMessage = line.substr(8); // Remove "message:" prefix
-        }
-
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
+        return booking;
     }
-    else
+
+    std::string_view line;
+    while (lines.next(line))
     {
-        std::string line, userInfo, facility, rating;
-        while (std::getline(responseStream, line))
+        size_t colonPos = line.find(':');
+        if (colonPos == std::string_view::npos)
         {
-            if (line.find("user:") == 0)
-            {
-                userInfo = line.substr(5); // Remove "user:" prefix
-            }
-            else if (line.find("facility:") == 0)
-            {
-                facility = line.substr(9); // Remove "facility:" prefix
-            }
-            else if (line.find("rating:") == 0)
-            {
-                rating = line.substr(7); // Remove "rating:" prefix
-            }
+            continue;
         }
 
-        parsedResponse.push_back("Rating Added");
-        parsedResponse.push_back("User: " + userInfo);
-        parsedResponse.push_back("Facility: " + facility);
-        parsedResponse.push_back("Rating: " + rating);
-    }
+        std::string_view key = line.substr(0, colonPos);
+        std::string_view value = line.substr(colonPos + 1);
 
-    return parsedResponse;
-}
-
-std::vector<std::string> ResponseParser::parseQueryRatingResponse(const std::string &response)
-{
-    std::vector<std::string> parsedResponse;
-    std::istringstream responseStream(response);
-
-    if (isErrorResponse(responseStream))
-    {
-        std::string line, errorMessage;
-        if (std::getline(responseStream, line) && line.find("message:") == 0)
+        if (key == "bookingID" || key == "newBookingID")
         {
-            errorMessage = line.substr(8); // Remove "message:" prefix
+            booking.bookingID = value;
         }
-
-        parsedResponse.push_back("Error");
-        parsedResponse.push_back(errorMessage);
-    }
-    else
-    {
-        std::string line, facility, rating;
-        while (std::getline(responseStream, line))
+        else if (key == "oldBookingID")
         {
-            if (line.find("facility:") == 0)
-            {
-                facility = line.substr(9); // Remove "facility:" prefix
-            }
-            else if (line.find("rating:") == 0)
-            {
-                rating = line.substr(7); // Remove "rating:" prefix
-            }
+            booking.oldBookingID = value;
+        }
+        else if (key == "user")
+        {
+            booking.user = value;
+        }
+        else if (key == "facility")
+        {
+            booking.facility = value;
+        }
+        else if (key == "day")
+        {
+            booking.day = Days::parse(value);
+        }
+        else if (key == "startTime")
+        {
+            booking.start = MinuteOfDay::parse(value);
+        }
+        else if (key == "endTime")
+        {
+            booking.end = MinuteOfDay::parse(value);
         }
-
-        parsedResponse.push_back("Facility Rating");
-        parsedResponse.push_back("Facility: " + facility);
-        parsedResponse.push_back("Rating: " + rating);
     }
 
-    return parsedResponse;
+    return booking;
 }
 
 /**
- * @brief Parses the response for echoing a message.
- * 
- * This function takes the raw server response as input and parses it to extract the echoed message.
- * If the response indicates an error, it extracts the error message and returns it in a vector.
- * Otherwise, it returns a vector containing the parsed echoed message.
- * 
- * @param response The raw server response.
- * 
- * @return A vector of strings containing the parsed echoed message or an error message.
+ * @brief Parses a timeslot of the form "HHMM - HHMM".
+ *
+ * @param text The timeslot.
+ * @param timeslot Set to the timeslot if it is valid.
+ *
+ * @return True if the timeslot has a valid start and end.
  */
-std::vector<std::string> ResponseParser::parseEchoMessageResponse(const std::string &response)
+bool ResponseParser::parseTimeslot(std::string_view text, Timeslot &timeslot)
 {
-    std::vector<std::string> parsedResponse;
+    size_t dashPos = text.find('-');
+    if (dashPos == std::string_view::npos)
+    {
+        return false;
+    }
 
-    parsedResponse = {
-        "Response from Server",
-        "Message: " + response
-    };
+    std::optional<MinuteOfDay> start = MinuteOfDay::parse(trim(text.substr(0, dashPos)));
+    std::optional<MinuteOfDay> end = MinuteOfDay::parse(trim(text.substr(dashPos + 1)));
+    if (!start || !end)
+    {
+        return false;
+    }
 
-    return parsedResponse;
+    timeslot = {*start, *end};
+    return true;
 }
 
 /**
- * @brief Checks if the response indicates an error.
- * 
- * This function takes an input stream containing the server response and checks if it indicates an error.
- * It returns true if the response indicates an error, false otherwise.
- * 
- * @param responseStream The input stream containing the server response.
- * 
- * @return True if the response indicates an error, false otherwise.
+ * @brief Removes spaces from both ends of a field.
+ *
+ * @param field The field.
+ *
+ * @return The field without surrounding spaces.
  */
-bool ResponseParser::isErrorResponse(std::istringstream &responseStream)
+std::string_view ResponseParser::trim(std::string_view field)
 {
-    std::string line;
-
-    if (std::getline(responseStream, line) && line.find(Constants::STATUS_ERROR) == 0)
+    size_t start = field.find_first_not_of(' ');
+    if (start == std::string_view::npos)
     {
-        return true;
+        return {};
     }
-    return false;
+
+    return field.substr(start, field.find_last_not_of(' ') - start + 1);
 }
@@ -0,0 +1,67 @@
+#include "RttEstimator.hpp"
+
+#include "Constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructs an estimator with no samples.
+ *
+ * @param initialTimeout The retransmission timeout to use until the first sample is added.
+ */
+RttEstimator::RttEstimator(std::chrono::milliseconds initialTimeout)
+    : smoothedRttMicros(0), rttVarianceMicros(0), timeoutMicros(static_cast<double>(initialTimeout.count()) * 1000), hasSample(false)
+{
+}
+
+/**
+ * @brief Updates the estimate with a measured round trip.
+ *
+ * The first sample initializes SRTT to the sample and RTTVAR to half of it (RFC 6298).
+ * Later samples are folded in with gains of 1/8 for SRTT and 1/4 for RTTVAR.
+ *
+ * @param rtt The time between sending a request and receiving its reply.
+ */
+void RttEstimator::addSample(std::chrono::microseconds rtt)
+{
+    double sample = static_cast<double>(rtt.count());
+
+    if (!hasSample)
+    {
+        smoothedRttMicros = sample;
+        rttVarianceMicros = sample / 2;
+        hasSample = true;
+    }
+    else
+    {
+        double error = sample - smoothedRttMicros;
+        rttVarianceMicros += (std::abs(error) - rttVarianceMicros) / 4;
+        smoothedRttMicros += error / 8;
+    }
+
+    timeoutMicros = std::clamp(
+        smoothedRttMicros + 4 * rttVarianceMicros,
+        static_cast<double>(Constants::MIN_RTO_MS) * 1000,
+        static_cast<double>(Constants::MAX_RTO_MS) * 1000);
+}
+
+/**
+ * @brief Gets the current retransmission timeout.
+ *
+ * @return The retransmission timeout.
+ */
+std::chrono::milliseconds RttEstimator::getTimeout() const
+{
+    return std::chrono::milliseconds(static_cast<long long>(timeoutMicros / 1000));
+}
+
+/**
+ * @brief Gets the smoothed round-trip time.
+ *
+ * @return The smoothed round-trip time, or zero if no sample has been added.
+ */
+std::chrono::microseconds RttEstimator::getSmoothedRtt() const
+{
+    return std::chrono::microseconds(static_cast<long long>(smoothedRttMicros));
+}
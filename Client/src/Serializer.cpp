@@ -9,16 +9,18 @@
 #include <string>
 #include <vector>
 
+#include "BatchMessage.hpp"
 #include "ByteBuffer.hpp"
 #include "ByteReader.hpp"
 #include "Parity.hpp"
+#include "RequestMessage.hpp"
 
-// Initialize static members
-std::map<int, std::shared_ptr<JavaSerializable>> JavaDeserializer::deserializedObjects;
-int JavaDeserializer::objectCounter = 0;
+// Initialize static members, the serialization state is per thread so that event loops on several threads can serialize concurrently
+thread_local std::map<int, std::shared_ptr<JavaSerializable>> JavaDeserializer::deserializedObjects;
+thread_local int JavaDeserializer::objectCounter = 0;
 std::map<std::string, std::function<std::shared_ptr<JavaSerializable>()>> ObjectFactory::creators;
-std::map<const void *, int> JavaSerializer::serializedObjects;
-int JavaSerializer::objectCounter = 0;
+thread_local std::map<const void *, int> JavaSerializer::serializedObjects;
+thread_local int JavaSerializer::objectCounter = 0;
 
 /* JavaSerializer */
 /**
@@ -117,6 +119,17 @@ std::shared_ptr<JavaSerializable> ObjectFactory::createObject(const std::string
     return it->second();
 }
 
+/**
+ * @brief Registers the message classes the server sends, which every program must do before receiving.
+ *
+ * Replies are single messages, or batch envelopes of several messages when requests were batched.
+ */
+void ObjectFactory::registerMessageClasses()
+{
+    registerClass<RequestMessage>("Server.RequestMessage");
+    registerClass<BatchMessage>("Server.BatchMessage");
+}
+
 /* JavaDeserializer */
 /**
  * @brief Deserializes a JavaSerializable object from a byte buffer.
@@ -0,0 +1,453 @@
+#include "SharedClient.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "Constants.hpp"
+#include "RequestFactory.hpp"
+#include "Serializer.hpp"
+
+/**
+ * @brief Constructs a SharedClient and starts its receive thread.
+ *
+ * The socket is bound to any available port. The receive thread does not block in recvfrom; it polls the
+ * socket with a short timeout so that it can expire slots and notice when the client is destroyed.
+ *
+ * @param serverIp The IP address or hostname of the server.
+ * @param serverPort The port number of the server.
+ *
+ * @throws std::runtime_error if the socket cannot be set up or the server address cannot be resolved.
+ */
+SharedClient::SharedClient(const std::string &serverIp, int serverPort)
+    : serverAddr(Socket::resolveAddress(serverIp, serverPort)), requestID(1),
+      slots(new Slot[Constants::SHARED_CLIENT_MAX_IN_FLIGHT]), freeSlots(Constants::SHARED_CLIENT_MAX_IN_FLIGHT),
+      rttEstimator(std::chrono::seconds(Constants::TIMEOUT_SEC)), running(true)
+{
+    socket.create(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    socket.bind(0);
+    socket.setReceiveTimeout(Constants::TIMEOUT_SEC);
+
+    receiveThread = std::thread(&SharedClient::receiveLoop, this);
+}
+
+/**
+ * @brief Stops the receive thread and closes the socket.
+ */
+SharedClient::~SharedClient()
+{
+    running.store(false, std::memory_order_release);
+    if (receiveThread.joinable())
+    {
+        receiveThread.join();
+    }
+    socket.closeSocket();
+}
+
+/**
+ * @brief Queries the names of all available facilities.
+ *
+ * @return A string containing the list of facility names or an error message.
+ */
+std::string SharedClient::queryFacilityNames()
+{
+    return sendWithRetry(RequestFactory::queryFacilityNames());
+}
+
+/**
+ * @brief Queries the availability of a facility for specific days.
+ *
+ * @param facilityName The name of the facility to query availability for.
+ * @param dayMask The days to query, with the bit of each day set (e.g., Days::bit(DayOfWeek::MONDAY)).
+ *
+ * @return A string containing the availability information or an error message.
+ */
+std::string SharedClient::queryAvailability(const std::string &facilityName, uint8_t dayMask)
+{
+    return sendWithRetry(RequestFactory::queryAvailability(facilityName, dayMask));
+}
+
+/**
+ * @brief Books a facility for a specific day and time range.
+ *
+ * @param facilityName The name of the facility.
+ * @param dayOfWeek The day of the week.
+ * @param startTime The start time.
+ * @param endTime The end time.
+ *
+ * @return A string containing the booking confirmation or an error message.
+ */
+std::string SharedClient::bookFacility(
+    const std::string &facilityName,
+    DayOfWeek dayOfWeek,
+    MinuteOfDay startTime,
+    MinuteOfDay endTime
+)
+{
+    return sendWithRetry(RequestFactory::bookFacility(facilityName, dayOfWeek, startTime, endTime));
+}
+
+/**
+ * @brief Queries the details of an existing booking.
+ *
+ * @param bookingID The ID of the booking to query.
+ *
+ * @return A string containing the booking details or an error message.
+ */
+std::string SharedClient::queryBooking(const std::string &bookingID)
+{
+    return sendWithRetry(RequestFactory::queryBooking(bookingID));
+}
+
+/**
+ * @brief Updates an existing booking by applying a time offset.
+ *
+ * @param oldBooking The booking to update, as parsed from its details.
+ * @param offsetMinutes The time offset in minutes (positive for later, negative for earlier).
+ *
+ * @return A string containing the updated booking details or an error message.
+ */
+std::string SharedClient::updateBooking(const ResponseParser::Booking &oldBooking, int offsetMinutes)
+{
+    return sendWithRetry(RequestFactory::updateBooking(oldBooking, offsetMinutes));
+}
+
+/**
+ * @brief Deletes an existing booking.
+ *
+ * @param booking The booking to delete, as parsed from its details.
+ *
+ * @return A string containing the deletion confirmation or an error message.
+ */
+std::string SharedClient::deleteBooking(const ResponseParser::Booking &booking)
+{
+    return sendWithRetry(RequestFactory::deleteBooking(booking));
+}
+
+/**
+ * @brief Registers interest in a facility. Updates are passed to the push handler.
+ *
+ * @param facilityName The name of the facility to monitor.
+ * @param durationSeconds The duration of the registration in seconds.
+ *
+ * @return A string containing the registration confirmation or an error message.
+ */
+std::string SharedClient::registerMonitor(const std::string &facilityName, int durationSeconds)
+{
+    return sendWithRetry(RequestFactory::registerMonitor(facilityName, durationSeconds));
+}
+
+/**
+ * @brief Sets the callback for monitoring updates.
+ *
+ * The callback runs on the receive thread, so it should return quickly; replies to other callers are not
+ * dispatched while it runs.
+ *
+ * @param handler The callback, or an empty function to discard updates.
+ */
+void SharedClient::setPushHandler(const std::function<void(const RequestMessage &)> &handler)
+{
+    std::lock_guard<std::mutex> lock(pushHandlerMutex);
+    pushHandler = handler;
+}
+
+/**
+ * @brief Rates a facility.
+ *
+ * @param facilityName The name of the facility to rate.
+ * @param rating The rating value (e.g., 4.5).
+ *
+ * @return A string containing the rating confirmation or an error message.
+ */
+std::string SharedClient::rateFacility(const std::string &facilityName, float rating)
+{
+    return sendWithRetry(RequestFactory::rateFacility(facilityName, rating));
+}
+
+/**
+ * @brief Queries the rating of a facility.
+ *
+ * @param facilityName The name of the facility to query.
+ *
+ * @return A string containing the rating information or an error message.
+ */
+std::string SharedClient::queryRating(const std::string &facilityName)
+{
+    return sendWithRetry(RequestFactory::queryRating(facilityName));
+}
+
+/**
+ * @brief Sends an echo message to the server.
+ *
+ * @param messageData The message data to send.
+ *
+ * @return A string containing the echoed message or an error message.
+ */
+std::string SharedClient::echoMessage(const std::string &messageData)
+{
+    return sendWithRetry(RequestFactory::echoMessage(messageData));
+}
+
+/**
+ * @brief Gets the retransmission timeout derived from the round trips of all callers.
+ *
+ * @return The retransmission timeout.
+ */
+std::chrono::milliseconds SharedClient::getTimeout()
+{
+    std::lock_guard<std::mutex> lock(rttMutex);
+    return rttEstimator.getTimeout();
+}
+
+/**
+ * @brief Builds the word of a slot.
+ *
+ * @param requestID The owning request ID.
+ * @param state The state of the slot.
+ *
+ * @return The slot word.
+ */
+uint64_t SharedClient::makeWord(int requestID, SlotState state)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(requestID)) << 32) | state;
+}
+
+/**
+ * @brief Gets the current steady-clock time, the time base of slot deadlines.
+ *
+ * @return The current time in nanoseconds.
+ */
+int64_t SharedClient::steadyNanos()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Allocates a request ID whose slot is free and takes the slot, waiting while every slot is taken.
+ *
+ * A slot is first reserved from the count of free slots, blocking on the count while it is 0, so that callers
+ * beyond SHARED_CLIENT_MAX_IN_FLIGHT sleep until a request completes. IDs are then handed out by an atomic
+ * counter. If the slot of an ID is still owned by an older request, e.g. one that is retransmitting, the ID is
+ * skipped and the next one is tried; as a slot is reserved, this ends within one pass over the table. The slot
+ * is taken in the IDLE state.
+ *
+ * @return The request ID.
+ */
+int SharedClient::claimSlot()
+{
+    int available = freeSlots.load(std::memory_order_relaxed);
+    while (true)
+    {
+        if (available == 0)
+        {
+            freeSlots.wait(0, std::memory_order_relaxed);
+            available = freeSlots.load(std::memory_order_relaxed);
+        }
+        else if (freeSlots.compare_exchange_weak(available, available - 1, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            break;
+        }
+    }
+
+    while (true)
+    {
+        int id = requestID.fetch_add(1, std::memory_order_relaxed);
+        if (id <= 0)
+        {
+            continue; // ID 0 is reserved for server-initiated messages
+        }
+
+        Slot &slot = slots[id % Constants::SHARED_CLIENT_MAX_IN_FLIGHT];
+        uint64_t word = slot.word.load(std::memory_order_relaxed);
+
+        if ((word & 0xFFFFFFFF) == FREE
+            && slot.word.compare_exchange_strong(word, makeWord(id, IDLE), std::memory_order_acquire))
+        {
+            return id;
+        }
+    }
+}
+
+/**
+ * @brief Frees the slot of a request and wakes a thread waiting for one.
+ *
+ * @param slot The slot.
+ * @param id The request ID owning the slot.
+ */
+void SharedClient::releaseSlot(Slot &slot, int id)
+{
+    slot.word.store(makeWord(id, FREE), std::memory_order_release);
+    freeSlots.fetch_add(1, std::memory_order_release);
+    freeSlots.notify_one();
+}
+
+/**
+ * @brief Sends a request and waits for its reply, retransmitting on timeout.
+ *
+ * Each attempt arms the slot with a deadline before sending, so that the receive thread can complete it as soon
+ * as the reply arrives, and then blocks on the slot's word until the receive thread changes it. The timeout
+ * starts at the shared retransmission timeout and doubles with each retransmission. Only replies to the first
+ * transmission are used as round-trip samples (Karn's algorithm). The request carries the acknowledged watermark
+ * of all callers at the time it is first sent.
+ *
+ * @param request The request to send. Its request ID and identity are assigned here.
+ *
+ * @return The reply data or an error message.
+ */
+std::string SharedClient::sendWithRetry(RequestMessage request)
+{
+    int id = claimSlot();
+    Slot &slot = slots[id % Constants::SHARED_CLIENT_MAX_IN_FLIGHT];
+
+    request.setRequestID(id);
+    request.setIdentity(identitySource.next());
+    request.setAckedSequence(identitySource.getAckedSequence());
+    std::vector<uint8_t> serializedData = JavaSerializer::serialize(&request);
+
+    std::chrono::milliseconds timeout = getTimeout();
+    const uint64_t waitingWord = makeWord(id, WAITING);
+
+    for (int attempt = 0; attempt < Constants::MAX_RETRIES; ++attempt)
+    {
+        auto attemptTimeout = std::min<std::chrono::milliseconds>(timeout * (1LL << attempt), std::chrono::milliseconds(Constants::MAX_RTO_MS));
+        int64_t sentAt = steadyNanos();
+
+        slot.deadline.store(sentAt + std::chrono::duration_cast<std::chrono::nanoseconds>(attemptTimeout).count(), std::memory_order_relaxed);
+        slot.word.store(waitingWord, std::memory_order_release);
+
+        try
+        {
+            socket.sendDataTo(serializedData, serverAddr);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error sending data: " << e.what() << std::endl;
+        }
+
+        slot.word.wait(waitingWord, std::memory_order_acquire);
+
+        if (slot.word.load(std::memory_order_acquire) == makeWord(id, READY))
+        {
+            std::string response = std::move(slot.response);
+            releaseSlot(slot, id);
+            identitySource.complete(request.getIdentity().sequence);
+
+            if (attempt == 0)
+            {
+                std::lock_guard<std::mutex> lock(rttMutex);
+                rttEstimator.addSample(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::nanoseconds(steadyNanos() - sentAt)));
+            }
+
+            return response;
+        }
+
+        std::cerr << "No response received. Retrying... (" << (attempt + 1) << "/" << Constants::MAX_RETRIES << ")" << std::endl;
+    }
+
+    releaseSlot(slot, id);
+    identitySource.complete(request.getIdentity().sequence);
+
+    return Constants::STATUS_ERROR + "\nmessage:" + Constants::REQUEST_FAILED_MESSAGE;
+}
+
+/**
+ * @brief Reads the socket and completes slots until the client is destroyed.
+ *
+ * This is the only thread that moves a slot out of the WAITING state, either to READY when the reply arrives or
+ * to IDLE when the deadline passes. Expired slots are checked every SHARED_CLIENT_POLL_MS milliseconds.
+ */
+void SharedClient::receiveLoop()
+{
+    std::vector<char> recvBuffer(Constants::MAX_DATAGRAM_SIZE);
+    const int64_t pollNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::milliseconds(Constants::SHARED_CLIENT_POLL_MS)).count();
+    int64_t nextExpiry = steadyNanos() + pollNanos;
+
+    while (running.load(std::memory_order_acquire))
+    {
+        try
+        {
+            if (socket.waitReadable(Constants::SHARED_CLIENT_POLL_MS))
+            {
+                struct sockaddr_in senderAddr;
+                int bytesReceived = socket.receiveDataFrom(recvBuffer.data(), static_cast<int>(recvBuffer.size()), senderAddr);
+                std::vector<uint8_t> receivedData(recvBuffer.begin(), recvBuffer.begin() + bytesReceived);
+
+                std::shared_ptr<RequestMessage> message = std::dynamic_pointer_cast<RequestMessage>(JavaDeserializer::deserialize(receivedData));
+                if (message)
+                {
+                    dispatch(message);
+                }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            std::cerr << e.what() << std::endl; // Corrupted datagram, keep receiving
+        }
+
+        int64_t now = steadyNanos();
+        if (now >= nextExpiry)
+        {
+            expireSlots(now);
+            nextExpiry = now + pollNanos;
+        }
+    }
+}
+
+/**
+ * @brief Hands a received message to the waiting caller or the push handler.
+ *
+ * Monitoring updates (request ID 0) go to the push handler. A reply is written into its slot only if the slot is
+ * still owned by the same request and waiting; replies to requests that have finished or are between attempts,
+ * such as duplicates of retransmitted requests, are discarded.
+ *
+ * @param message The received message.
+ */
+void SharedClient::dispatch(const std::shared_ptr<RequestMessage> &message)
+{
+    int id = message->getRequestID();
+
+    if (id == 0)
+    {
+        std::lock_guard<std::mutex> lock(pushHandlerMutex);
+        if (pushHandler)
+        {
+            pushHandler(*message);
+        }
+        return;
+    }
+
+    if (id < 0)
+    {
+        return;
+    }
+
+    Slot &slot = slots[id % Constants::SHARED_CLIENT_MAX_IN_FLIGHT];
+    if (slot.word.load(std::memory_order_acquire) != makeWord(id, WAITING))
+    {
+        return;
+    }
+
+    slot.response = message->getData();
+    slot.word.store(makeWord(id, READY), std::memory_order_release);
+    slot.word.notify_one();
+}
+
+/**
+ * @brief Wakes the callers whose deadline has passed.
+ *
+ * @param nowNanos The current steady-clock time in nanoseconds.
+ */
+void SharedClient::expireSlots(int64_t nowNanos)
+{
+    for (int i = 0; i < Constants::SHARED_CLIENT_MAX_IN_FLIGHT; ++i)
+    {
+        Slot &slot = slots[i];
+        uint64_t word = slot.word.load(std::memory_order_acquire);
+
+        if ((word & 0xFFFFFFFF) == WAITING && slot.deadline.load(std::memory_order_relaxed) <= nowNanos)
+        {
+            slot.word.store((word & ~static_cast<uint64_t>(0xFFFFFFFF)) | IDLE, std::memory_order_release);
+            slot.word.notify_one();
+        }
+    }
+}
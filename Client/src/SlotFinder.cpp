@@ -0,0 +1,171 @@
+#include "SlotFinder.hpp"
+
+#include <algorithm>
+
+#include "RequestFactory.hpp"
+#include "ResponseParser.hpp"
+
+/**
+ * @brief Constructs a SlotFinder that uses the given client for its queries and bookings.
+ *
+ * @param client Reference to the Client object for server communication.
+ */
+SlotFinder::SlotFinder(Client &client) : client(client)
+{
+}
+
+/**
+ * @brief Finds the earliest free slots matching a query.
+ *
+ * The facility names are queried first. The availability queries of the facilities that pass the filter are
+ * then pipelined, so that the search takes about two round trips whatever the number of facilities. Facilities
+ * whose query fails are left out of the search.
+ *
+ * @param query The query.
+ *
+ * @return The candidates, best first, or none if the query is invalid or nothing is free.
+ */
+std::vector<SlotFinder::Candidate> SlotFinder::findSlots(const Query &query)
+{
+    if (!isValidQuery(query))
+    {
+        return {};
+    }
+
+    ResponseParser::FacilityList facilityList = ResponseParser::parseQueryFacilityNamesResponse(client.queryFacilityNames());
+    if (facilityList.error.failed())
+    {
+        return {};
+    }
+
+    uint8_t dayMask = 0;
+    for (int day = Days::index(query.firstDay); day <= Days::index(query.lastDay); ++day)
+    {
+        dayMask |= 1 << day;
+    }
+
+    std::vector<std::string> facilities;
+    std::vector<RequestMessage> requests;
+    for (const std::string &facility : facilityList.names)
+    {
+        if (!query.facilityFilter || query.facilityFilter(facility))
+        {
+            facilities.push_back(facility);
+            requests.push_back(RequestFactory::queryAvailability(facility, dayMask));
+        }
+    }
+
+    std::vector<std::string> responses = client.submitPipelined(std::move(requests));
+
+    std::vector<std::string> indexedFacilities;
+    std::vector<AvailabilityCalendar> calendars;
+    for (size_t i = 0; i < facilities.size(); ++i)
+    {
+        std::shared_ptr<const ResponseParser::Availability> availability = client.parseAvailability(responses[i], dayMask);
+        if (!availability->error.failed())
+        {
+            indexedFacilities.push_back(facilities[i]);
+            calendars.push_back(AvailabilityCalendar::fromAvailability(*availability));
+        }
+    }
+
+    return rankCandidates(indexedFacilities, calendars, query);
+}
+
+/**
+ * @brief Books the best candidate of a query, falling back to the next one when a slot was taken.
+ *
+ * Each booking is atomic at the server, which either books the whole slot or rejects it. A candidate booked by
+ * someone else since the search is rejected as not available, and the next candidate is tried. Any other error,
+ * including a booking whose reply never arrived, ends the attempt, as trying further candidates could book twice.
+ *
+ * @param query The query.
+ *
+ * @return The outcome of the bookings.
+ */
+SlotFinder::BookingResult SlotFinder::bookBest(const Query &query)
+{
+    BookingResult result;
+
+    for (const Candidate &candidate : findSlots(query))
+    {
+        result.candidate = candidate;
+        result.attempts++;
+        result.response = client.bookFacility(candidate.facility, candidate.day, candidate.start, candidate.end);
+
+        ResponseParser::Booking booking = ResponseParser::parseBookFacilityResponse(result.response);
+        if (!booking.error.failed())
+        {
+            result.booked = true;
+            break;
+        }
+        if (booking.error.code != ResponseParser::Error::SLOT_UNAVAILABLE)
+        {
+            break;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief Ranks the free slots of indexed facilities.
+ *
+ * Every free period of the time window yields consecutive slots of the duration from its start, so that a
+ * fallback can take the next slot of the same period. Slots are ranked by day, then start, then the order of
+ * the facilities. Days are searched in order and the search stops at the first day that completes the list.
+ *
+ * @param facilities The facility names.
+ * @param calendars The calendar of each facility.
+ * @param query The query.
+ *
+ * @return The candidates, best first.
+ */
+std::vector<SlotFinder::Candidate> SlotFinder::rankCandidates(const std::vector<std::string> &facilities, const std::vector<AvailabilityCalendar> &calendars, const Query &query)
+{
+    std::vector<Candidate> candidates;
+    if (!isValidQuery(query))
+    {
+        return candidates;
+    }
+
+    for (int day = Days::index(query.firstDay); day <= Days::index(query.lastDay) && static_cast<int>(candidates.size()) < query.maxCandidates; ++day)
+    {
+        size_t dayBegin = candidates.size();
+        for (size_t i = 0; i < facilities.size() && i < calendars.size(); ++i)
+        {
+            int from = query.windowStart.minutes();
+            int start;
+            while ((start = calendars[i].findFreeWindow(day, query.durationMinutes, from, query.windowEnd.minutes())) >= 0)
+            {
+                from = start + query.durationMinutes;
+                candidates.push_back({facilities[i], static_cast<DayOfWeek>(day), *MinuteOfDay::fromMinutes(start), *MinuteOfDay::fromMinutes(from)});
+            }
+        }
+
+        // Facilities were added in order, so a stable sort keeps them in order within each start time
+        std::stable_sort(candidates.begin() + dayBegin, candidates.end(), [](const Candidate &a, const Candidate &b)
+        {
+            return a.start < b.start;
+        });
+    }
+
+    if (static_cast<int>(candidates.size()) > query.maxCandidates)
+    {
+        candidates.resize(query.maxCandidates);
+    }
+    return candidates;
+}
+
+/**
+ * @brief Checks that a query describes a non-empty search.
+ *
+ * @param query The query.
+ *
+ * @return True if the day range and time window are valid and can hold a slot of the duration.
+ */
+bool SlotFinder::isValidQuery(const Query &query)
+{
+    return query.durationMinutes > 0 && query.maxCandidates > 0 && query.firstDay <= query.lastDay &&
+           query.windowEnd.minutes() - query.windowStart.minutes() >= query.durationMinutes;
+}
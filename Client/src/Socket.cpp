@@ -97,6 +97,20 @@ void Socket::bind(int port)
     addr.sin_addr.s_addr = INADDR_ANY;
     addr.sin_port = htons(port);
 
+    bind(addr);
+}
+
+/**
+ * @brief Binds the socket to the specified local address.
+ * 
+ * This method binds the socket to one local address only, e.g. the loopback address. It throws an exception if the binding fails.
+ * 
+ * @param addr The local address and port to bind the socket to.
+ * 
+ * @throws std::runtime_error if binding fails.
+ */
+void Socket::bind(const struct sockaddr_in &addr)
+{
 #ifdef _WIN32
     if (::bind(sockfd, (struct sockaddr *)&addr, sizeof(addr)) == SOCKET_ERROR)
     {
@@ -142,6 +156,41 @@ void Socket::setReceiveTimeout(int seconds)
 #endif
 }
 
+/**
+ * @brief Sets the receive timeout for the socket with millisecond precision.
+ * 
+ * This method is used where a whole-second timeout is too coarse, e.g. when waiting for the next of several deadlines.
+ * A timeout of zero would make the socket block indefinitely, hence values below 1 are raised to 1 millisecond.
+ * 
+ * @param milliseconds The timeout duration in milliseconds.
+ * 
+ * @throws std::runtime_error if setting the timeout fails.
+ */
+void Socket::setReceiveTimeoutMillis(int milliseconds)
+{
+    if (milliseconds < 1)
+    {
+        milliseconds = 1;
+    }
+
+#ifdef _WIN32
+    DWORD timeout = milliseconds;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout)) == SOCKET_ERROR)
+    {
+        int errorCode = WSAGetLastError();
+        throw std::runtime_error("Set receive timeout failed! Error code: " + std::to_string(errorCode));
+    }
+#else
+    struct timeval timeout;
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = (milliseconds % 1000) * 1000;
+    if (setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char *)&timeout, sizeof(timeout)) == -1)
+    {
+        throw std::runtime_error("Set receive timeout failed! Error: " + std::string(strerror(errno)));
+    }
+#endif
+}
+
 /**
  * @brief Sends data to a specified address.
  * 
@@ -183,13 +232,31 @@ void Socket::sendDataTo(const std::vector<uint8_t> &data, const struct sockaddr_
  * @throws std::runtime_error if receiving fails.
  */
 int Socket::receiveDataFrom(char *buffer, struct sockaddr_in &addr)
+{
+    return receiveDataFrom(buffer, Constants::BUFFER_SIZE, addr);
+}
+
+/**
+ * @brief Receives data from a specified address into a buffer of the given size.
+ * 
+ * Datagrams longer than the buffer are truncated.
+ * 
+ * @param buffer The buffer to store the received data.
+ * @param bufferSize The size of the buffer in bytes.
+ * @param addr The source address.
+ * 
+ * @return The number of bytes received.
+ * 
+ * @throws std::runtime_error if receiving fails.
+ */
+int Socket::receiveDataFrom(char *buffer, int bufferSize, struct sockaddr_in &addr)
 {
 #ifdef _WIN32
     int addrLen = sizeof(addr);
 #else
     socklen_t addrLen = sizeof(addr);
 #endif
-    int bytesReceived = recvfrom(sockfd, buffer, Constants::BUFFER_SIZE, 0, (struct sockaddr *)&addr, &addrLen);
+    int bytesReceived = recvfrom(sockfd, buffer, bufferSize, 0, (struct sockaddr *)&addr, &addrLen);
     if (bytesReceived < 0)
     {
 #ifdef _WIN32
@@ -216,6 +283,172 @@ int Socket::receiveDataFrom(char *buffer, struct sockaddr_in &addr)
     return bytesReceived;
 }
 
+/**
+ * @brief Waits until a datagram can be received without blocking.
+ * 
+ * This method polls the socket for readability, so that an event loop can wait for datagrams and timers at the same time.
+ * 
+ * @param timeoutMillis The maximum time to wait in milliseconds, or a negative value to wait indefinitely.
+ * 
+ * @return True if a datagram is ready, false if the timeout expired.
+ * 
+ * @throws std::runtime_error if waiting fails.
+ */
+bool Socket::waitReadable(int timeoutMillis)
+{
+#ifdef _WIN32
+    WSAPOLLFD pollDescriptor = {};
+    pollDescriptor.fd = sockfd;
+    pollDescriptor.events = POLLRDNORM;
+
+    int result = WSAPoll(&pollDescriptor, 1, timeoutMillis);
+    if (result == SOCKET_ERROR)
+    {
+        int errorCode = WSAGetLastError();
+        throw std::runtime_error("Poll failed! Error code: " + std::to_string(errorCode));
+    }
+#else
+    struct pollfd pollDescriptor = {};
+    pollDescriptor.fd = sockfd;
+    pollDescriptor.events = POLLIN;
+
+    int result = poll(&pollDescriptor, 1, timeoutMillis);
+    if (result == -1)
+    {
+        if (errno == EINTR)
+        {
+            return false;
+        }
+        throw std::runtime_error("Poll failed! Error: " + std::string(strerror(errno)));
+    }
+#endif
+    return result > 0;
+}
+
+/**
+ * @brief Marks a bound stream socket as accepting connections.
+ * 
+ * @param backlog The maximum number of pending connections.
+ * 
+ * @throws std::runtime_error if listening fails.
+ */
+void Socket::listen(int backlog)
+{
+#ifdef _WIN32
+    if (::listen(sockfd, backlog) == SOCKET_ERROR)
+    {
+        int errorCode = WSAGetLastError();
+        throw std::runtime_error("Listen failed! Error code: " + std::to_string(errorCode));
+    }
+#else
+    if (::listen(sockfd, backlog) == -1)
+    {
+        throw std::runtime_error("Listen failed! Error: " + std::string(strerror(errno)));
+    }
+#endif
+}
+
+/**
+ * @brief Accepts a pending connection of a listening socket.
+ * 
+ * This method blocks until a connection is pending; use waitReadable() first to bound the wait.
+ * 
+ * @param connection The socket to hand the connection to. Any socket it held is closed.
+ * 
+ * @throws std::runtime_error if accepting fails.
+ */
+void Socket::acceptConnection(Socket &connection)
+{
+    int connectionfd = static_cast<int>(::accept(sockfd, nullptr, nullptr));
+#ifdef _WIN32
+    if (connectionfd == static_cast<int>(INVALID_SOCKET))
+    {
+        int errorCode = WSAGetLastError();
+        throw std::runtime_error("Accept failed! Error code: " + std::to_string(errorCode));
+    }
+#else
+    if (connectionfd == -1)
+    {
+        throw std::runtime_error("Accept failed! Error: " + std::string(strerror(errno)));
+    }
+#endif
+
+    connection.closeSocket();
+    connection.sockfd = connectionfd;
+}
+
+/**
+ * @brief Sends all bytes over a connected stream socket.
+ * 
+ * Stream sockets may accept only part of the data per call, so this method keeps sending the rest.
+ * 
+ * @param data The bytes to send.
+ * 
+ * @throws std::runtime_error if sending fails.
+ */
+void Socket::sendAll(const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+#ifdef _WIN32
+        int result = send(sockfd, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+        if (result == SOCKET_ERROR)
+        {
+            int errorCode = WSAGetLastError();
+            throw std::runtime_error("Send failed! Error code: " + std::to_string(errorCode));
+        }
+#else
+        ssize_t result = send(sockfd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error("Send failed! Error: " + std::string(strerror(errno)));
+        }
+#endif
+        sent += static_cast<size_t>(result);
+    }
+}
+
+/**
+ * @brief Resolves a hostname or IPv4 address into a socket address.
+ * 
+ * It first tries to convert the hostname to an IP address. If that fails, it resolves the hostname using gethostbyname.
+ * 
+ * @param hostname The hostname or IP address.
+ * @param port The port number.
+ * 
+ * @return The socket address.
+ * 
+ * @throws std::runtime_error if the hostname cannot be resolved.
+ */
+struct sockaddr_in Socket::resolveAddress(const std::string &hostname, int port)
+{
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+
+    // Try to convert IP address directly
+    addr.sin_addr.s_addr = inet_addr(hostname.c_str());
+
+    // If not an IP address, try to resolve hostname
+    if (addr.sin_addr.s_addr == INADDR_NONE)
+    {
+        struct hostent *host = gethostbyname(hostname.c_str());
+        if (host == NULL)
+        {
+            throw std::runtime_error("Unknown host: " + hostname);
+        }
+        memcpy(&(addr.sin_addr), host->h_addr, host->h_length);
+    }
+
+    return addr;
+}
+
 /**
  * @brief Retrieves the local socket name (IP address and port).
  * 
@@ -251,9 +484,15 @@ int Socket::getSocketName(struct sockaddr *addr)
  */
 void Socket::closeSocket()
 {
+    if (sockfd == -1)
+    {
+        return;
+    }
+
 #ifdef _WIN32
     closesocket(sockfd);
 #else
     close(sockfd);
 #endif
+    sockfd = -1;
 }
@@ -0,0 +1,211 @@
+#include "Tracer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+#include "ClientStats.hpp"
+#include "Constants.hpp"
+
+std::atomic<uint64_t> Tracer::nextTracerID(1);
+
+/**
+ * @brief Starts a span.
+ *
+ * Without a tracer, the clock is not read, so an untraced span costs a null check.
+ *
+ * @param tracer The tracer to record into, or null to record nothing.
+ * @param name The name of the span. It must be a string literal or otherwise outlive the tracer.
+ * @param requestID The request ID the span belongs to, or -1 if none.
+ * @param requestType The request type the span belongs to, or -1 if unknown.
+ * @param attempt The attempt the span belongs to, or -1 if none.
+ */
+Tracer::Span::Span(Tracer *tracer, const char *name, int64_t requestID, int requestType, int attempt)
+    : tracer(tracer), name(name), requestID(requestID), requestType(requestType), attempt(attempt)
+{
+    if (tracer)
+    {
+        start = Clock::now();
+    }
+}
+
+/**
+ * @brief Ends the span and records it.
+ */
+Tracer::Span::~Span()
+{
+    if (tracer)
+    {
+        tracer->record(name, start, Clock::now(), requestID, requestType, attempt);
+    }
+}
+
+/**
+ * @brief Ends the span early and records it.
+ *
+ * The span is not recorded again when it is destroyed.
+ *
+ * @param requestType The request type, for spans started before the request existed, or -1 to keep it.
+ */
+void Tracer::Span::end(int requestType)
+{
+    if (requestType >= 0)
+    {
+        this->requestType = requestType;
+    }
+
+    if (tracer)
+    {
+        tracer->record(name, start, Clock::now(), requestID, this->requestType, attempt);
+        tracer = nullptr;
+    }
+}
+
+/**
+ * @brief Constructs an empty tracer.
+ *
+ * Timestamps in the trace file are relative to the construction of the tracer.
+ */
+Tracer::Tracer() : tracerID(nextTracerID.fetch_add(1)), origin(Clock::now())
+{
+}
+
+/**
+ * @brief Records a span into the ring of the calling thread.
+ *
+ * The event is written into the slot after the last one and then published by advancing the head, so the
+ * thread never waits for writeFile(). Once the ring is full, the oldest event is overwritten.
+ *
+ * @param name The name of the span. It must be a string literal or otherwise outlive the tracer.
+ * @param start The start of the span.
+ * @param end The end of the span.
+ * @param requestID The request ID the span belongs to, or -1 if none.
+ * @param requestType The request type the span belongs to, or -1 if unknown.
+ * @param attempt The attempt the span belongs to, or -1 if none.
+ */
+void Tracer::record(const char *name, Clock::time_point start, Clock::time_point end, int64_t requestID, int requestType, int attempt)
+{
+    Ring &ring = localRing();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+
+    ring.events[head % ring.events.size()] = {name, start, end, requestID, requestType, attempt};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Writes the recorded spans of all threads as a Chrome trace-event JSON file.
+ *
+ * Each span is a complete ("X") event with its request ID, request type and attempt as arguments, and each
+ * thread is named after its number within the tracer. Threads may keep recording while the file is written,
+ * but an event they overwrite during the copy may then appear garbled, so write the file while idle for an
+ * exact trace.
+ *
+ * @param path The path of the file.
+ *
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void Tracer::writeFile(const std::string &path) const
+{
+    std::vector<std::pair<int, Event>> events;
+    std::vector<int> threadIDs;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex);
+        for (const std::unique_ptr<Ring> &ring : rings)
+        {
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            uint64_t count = std::min<uint64_t>(head, ring->events.size());
+            for (uint64_t sequence = head - count; sequence < head; ++sequence)
+            {
+                events.emplace_back(ring->threadID, ring->events[sequence % ring->events.size()]);
+            }
+            threadIDs.push_back(ring->threadID);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const std::pair<int, Event> &a, const std::pair<int, Event> &b) {
+        return a.second.start < b.second.start;
+    });
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        throw std::runtime_error("Failed to open trace file: " + path);
+    }
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    for (int threadID : threadIDs)
+    {
+        file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadID
+             << ",\"args\":{\"name\":\"client thread " << threadID << "\"}}";
+        first = false;
+    }
+
+    char timestamps[64];
+    for (const std::pair<int, Event> &entry : events)
+    {
+        const Event &event = entry.second;
+        double startMicros = std::chrono::duration<double, std::micro>(event.start - origin).count();
+        double durationMicros = std::chrono::duration<double, std::micro>(event.end - event.start).count();
+        snprintf(timestamps, sizeof(timestamps), "\"ts\":%.3f,\"dur\":%.3f", startMicros, durationMicros);
+
+        file << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"cat\":\"client\",\"ph\":\"X\","
+             << timestamps << ",\"pid\":1,\"tid\":" << entry.first << ",\"args\":{";
+
+        bool firstArgument = true;
+        if (event.requestID >= 0)
+        {
+            file << "\"requestID\":" << event.requestID;
+            firstArgument = false;
+        }
+        if (event.requestType >= 0)
+        {
+            file << (firstArgument ? "" : ",") << "\"type\":\"" << ClientStats::getRequestTypeName(event.requestType) << "\"";
+            firstArgument = false;
+        }
+        if (event.attempt >= 0)
+        {
+            file << (firstArgument ? "" : ",") << "\"attempt\":" << event.attempt;
+        }
+        file << "}}";
+        first = false;
+    }
+
+    file << "\n]}\n";
+    if (!file)
+    {
+        throw std::runtime_error("Failed to write trace file: " + path);
+    }
+}
+
+/**
+ * @brief Gets the ring of the calling thread, creating it on its first event.
+ *
+ * Each thread remembers its ring per tracer ID, so the lock is only taken the first time a thread records
+ * into a tracer. IDs are never reused, so a thread cannot mistake a new tracer for a destroyed one.
+ *
+ * @return The ring.
+ */
+Tracer::Ring &Tracer::localRing()
+{
+    thread_local std::unordered_map<uint64_t, Ring *> ringsOfThread;
+
+    auto found = ringsOfThread.find(tracerID);
+    if (found != ringsOfThread.end())
+    {
+        return *found->second;
+    }
+
+    std::lock_guard<std::mutex> lock(ringsMutex);
+    std::unique_ptr<Ring> ring = std::make_unique<Ring>();
+    ring->threadID = static_cast<int>(rings.size()) + 1;
+    ring->events.resize(Constants::TRACE_RING_CAPACITY);
+    ring->head.store(0, std::memory_order_relaxed);
+
+    rings.push_back(std::move(ring));
+    ringsOfThread[tracerID] = rings.back().get();
+    return *rings.back();
+}
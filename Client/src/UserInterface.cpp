@@ -2,7 +2,6 @@
 
 #include <cstdio>
 #include <limits>
-#include <numeric>
 #include <regex>
 
 #include "Constants.hpp"
@@ -195,11 +194,10 @@ void UserInterface::handleQueryFacilityNames()
     std::cout << "Query Facility Names selected." << std::endl;
 
     std::string response;
-    std::vector<std::string> parsedResponse;
 
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
 }
 
 /**
@@ -210,25 +208,25 @@ void UserInterface::handleQueryAvailability()
     std::cout << std::endl;
     std::cout << "Query Facility Availability selected." << std::endl;
 
-    std::string facilityName, daysOfWeek, response;
-    std::vector<std::string> parsedResponse;
+    std::string facilityName, response;
+    uint8_t dayMask;
 
     // Display list of facility names to choose from
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
+    if (isErrorResponse(facilityList.error))
     {
         return;
     }
 
     // Prompt user to enter facility name to check availability for
     facilityName = promptFacilityName("Enter facility name: ");
-    daysOfWeek = promptDaysOfWeek("Enter choice (1-7, comma-separated): ");
-    response = client.queryAvailability(facilityName, daysOfWeek);
-    parsedResponse = ResponseParser::parseQueryAvailabilityResponse(response, daysOfWeek);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    dayMask = promptDaysOfWeek("Enter choice (1-7, comma-separated): ");
+    response = client.queryAvailability(facilityName, dayMask);
+    std::shared_ptr<const ResponseParser::Availability> availability = timeParse(RequestMessage::READ, [&]() { return client.parseAvailability(response, dayMask); });
+    std::cout << generateBox(formatAvailability(*availability));
+    if (isErrorResponse(availability->error))
     {
         return;
     }
@@ -242,15 +240,15 @@ void UserInterface::handleBookFacility()
     std::cout << std::endl;
     std::cout << "Book Facility selected." << std::endl;
 
-    std::string facilityName, dayOfWeek, startTime, endTime;
-    std::string response;
-    std::vector<std::string> parsedResponse;
+    std::string facilityName, response;
+    DayOfWeek dayOfWeek;
+    MinuteOfDay startTime, endTime;
 
     // Display list of facility names to choose from
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
+    if (isErrorResponse(facilityList.error))
     {
         return;
     }
@@ -261,9 +259,9 @@ void UserInterface::handleBookFacility()
     endTime = promptTime("Enter end time (HHMM): ");
 
     response = client.bookFacility(facilityName, dayOfWeek, startTime, endTime);
-    parsedResponse = ResponseParser::parseBookFacilityResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Booking booking = timeParse(RequestMessage::WRITE, [&]() { return ResponseParser::parseBookFacilityResponse(response); });
+    std::cout << generateBox(formatBooking(booking));
+    if (isErrorResponse(booking.error))
     {
         return;
     }
@@ -278,14 +276,13 @@ void UserInterface::handleQueryBooking()
     std::cout << "Query Existing Booking selected." << std::endl;
 
     std::string bookingID, response;
-    std::vector<std::string> parsedResponse;
 
     bookingID = promptBookingID("Enter booking ID: ");
 
     response = client.queryBooking(bookingID);
-    parsedResponse = ResponseParser::parseQueryBookingResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Booking booking = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryBookingResponse(response); });
+    std::cout << generateBox(formatBooking(booking));
+    if (isErrorResponse(booking.error))
     {
         return;
     }
@@ -300,17 +297,16 @@ void UserInterface::handleUpdateBooking()
     std::cout << "Update Existing Booking selected." << std::endl;
 
     int offsetMinutes;
-    std::string bookingID, oldBookingDetails, newStartTime, newEndTime, newBookingDetails;
-    std::vector<std::string> parsedResponse;
+    std::string bookingID, oldBookingDetails, newBookingDetails;
     bool confirmation;
 
     bookingID = promptBookingID("Enter booking ID: ");
 
     // Display old booking details
     oldBookingDetails = client.queryBooking(bookingID);
-    parsedResponse = ResponseParser::parseQueryBookingResponse(oldBookingDetails);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Booking oldBooking = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryBookingResponse(oldBookingDetails); });
+    std::cout << generateBox(formatBooking(oldBooking));
+    if (isErrorResponse(oldBooking.error))
     {
         return;
     }
@@ -324,10 +320,10 @@ void UserInterface::handleUpdateBooking()
 
     offsetMinutes = promptOffset("Enter offset in minutes (positive for later, negative for earlier): ");
 
-    newBookingDetails = client.updateBooking(bookingID, offsetMinutes, oldBookingDetails);
-    parsedResponse = ResponseParser::parseUpdateBookingResponse(newBookingDetails);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    newBookingDetails = client.updateBooking(oldBooking, offsetMinutes);
+    ResponseParser::Booking newBooking = timeParse(RequestMessage::UPDATE, [&]() { return ResponseParser::parseUpdateBookingResponse(newBookingDetails); });
+    std::cout << generateBox(formatUpdatedBooking(newBooking));
+    if (isErrorResponse(newBooking.error))
     {
         return;
     }
@@ -342,16 +338,15 @@ void UserInterface::handleDeleteBooking()
     std::cout << "Delete Existing Booking selected." << std::endl;
 
     std::string bookingID, oldBookingDetails, response;
-    std::vector<std::string> parsedResponse;
     bool confirmation;
 
     bookingID = promptBookingID("Enter booking ID: ");
 
     // Display booking details
     oldBookingDetails = client.queryBooking(bookingID);
-    parsedResponse = ResponseParser::parseQueryBookingResponse(oldBookingDetails);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Booking oldBooking = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryBookingResponse(oldBookingDetails); });
+    std::cout << generateBox(formatBooking(oldBooking));
+    if (isErrorResponse(oldBooking.error))
     {
         return;
     }
@@ -363,10 +358,10 @@ void UserInterface::handleDeleteBooking()
         return;
     }
 
-    response = client.deleteBooking(bookingID, oldBookingDetails);
-    parsedResponse = ResponseParser::parseDeleteBookingResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    response = client.deleteBooking(oldBooking);
+    ResponseParser::Booking deletedBooking = timeParse(RequestMessage::DELETE_REQUEST, [&]() { return ResponseParser::parseDeleteBookingResponse(response); });
+    std::cout << generateBox(formatDeletedBooking(deletedBooking));
+    if (isErrorResponse(deletedBooking.error))
     {
         return;
     }
@@ -386,9 +381,9 @@ void UserInterface::handleMonitorAvailability()
 
     // Display list of facility names to choose from
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
+    if (isErrorResponse(facilityList.error))
     {
         return;
     }
@@ -397,16 +392,15 @@ void UserInterface::handleMonitorAvailability()
     durationSeconds = promptDuration("Enter duration in seconds: ");
 
     client.monitorAvailability(facilityName, durationSeconds, [this](const std::string &response, const bool isRegistrationResponse) {
-        std::vector<std::string> parsedResponse;
         if (isRegistrationResponse)
         {
-            parsedResponse = ResponseParser::parseMonitorAvailabilityResponse(response);
-            std::cout << generateBox(parsedResponse);
+            ResponseParser::MonitorRegistration registration = timeParse(RequestMessage::MONITOR, [&]() { return ResponseParser::parseMonitorAvailabilityResponse(response); });
+            std::cout << generateBox(formatMonitorRegistration(registration));
         }
         else
         {
-            parsedResponse = ResponseParser::parseQueryAvailabilityResponse(response);
-            std::cout << generateBox(parsedResponse);
+            std::shared_ptr<const ResponseParser::Availability> availability = timeParse(RequestMessage::MONITOR, [&]() { return client.parseAvailability(response); });
+            std::cout << generateBox(formatAvailability(*availability));
         }
     });
 
@@ -429,13 +423,12 @@ void UserInterface::handleRateFacility()
 
     std::string facilityName, response;
     float rating;
-    std::vector<std::string> parsedResponse;
 
     // Display list of facility names to choose from
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
+    if (isErrorResponse(facilityList.error))
     {
         return;
     }
@@ -444,9 +437,9 @@ void UserInterface::handleRateFacility()
     rating = promptRating("Enter rating (1-5): ");
 
     response = client.rateFacility(facilityName, rating);
-    parsedResponse = ResponseParser::parseRateFacilityResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Rating ratingAdded = timeParse(RequestMessage::UPDATE, [&]() { return ResponseParser::parseRateFacilityResponse(response); });
+    std::cout << generateBox(formatRatingAdded(ratingAdded));
+    if (isErrorResponse(ratingAdded.error))
     {
         return;
     }
@@ -461,13 +454,12 @@ void UserInterface::handleQueryRating()
     std::cout << "Query Facility Rating selected." << std::endl;
 
     std::string facilityName, response;
-    std::vector<std::string> parsedResponse;
 
     // Display list of facility names to choose from
     response = client.queryFacilityNames();
-    parsedResponse = ResponseParser::parseQueryFacilityNamesResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::FacilityList facilityList = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryFacilityNamesResponse(response); });
+    std::cout << generateBox(formatFacilityList(facilityList));
+    if (isErrorResponse(facilityList.error))
     {
         return;
     }
@@ -475,9 +467,9 @@ void UserInterface::handleQueryRating()
     facilityName = promptFacilityName("Enter facility name: ");
     
     response = client.queryRating(facilityName);
-    parsedResponse = ResponseParser::parseQueryRatingResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
+    ResponseParser::Rating facilityRating = timeParse(RequestMessage::READ, [&]() { return ResponseParser::parseQueryRatingResponse(response); });
+    std::cout << generateBox(formatRating(facilityRating));
+    if (isErrorResponse(facilityRating.error))
     {
         return;
     }
@@ -493,7 +485,6 @@ void UserInterface::handleEchoMessage()
 
     std::string messageData;
     std::string response;
-    std::vector<std::string> parsedResponse;
     bool confirmation;
 
     std::cout << "Enter message to send: ";
@@ -508,12 +499,8 @@ void UserInterface::handleEchoMessage()
     }
 
     response = client.echoMessage(messageData);
-    parsedResponse = ResponseParser::parseEchoMessageResponse(response);
-    std::cout << generateBox(parsedResponse);
-    if (isErrorResponse(parsedResponse))
-    {
-        return;
-    }
+    std::string echoedMessage = timeParse(RequestMessage::ECHO, [&]() { return ResponseParser::parseEchoMessageResponse(response); });
+    std::cout << generateBox(formatEchoMessage(echoedMessage));
 }
 
 /**
@@ -594,13 +581,13 @@ std::string UserInterface::promptFacilityName(const std::string prompt)
  * This function displays a menu of days of the week and prompts the user to select one.
  * It validates the input to ensure it is a number between 1 and 7.
  * If the input is invalid, it clears the error state and prompts again.
- * If the input is valid, it returns the corresponding day name.
+ * If the input is valid, it returns the corresponding day.
  * 
  * @param prompt The prompt message to display.
  * 
  * @return The day of the week entered by the user.
  */
-std::string UserInterface::promptDayOfWeek(const std::string prompt)
+DayOfWeek UserInterface::promptDayOfWeek(const std::string prompt)
 {
     int choice;
 
@@ -618,7 +605,7 @@ std::string UserInterface::promptDayOfWeek(const std::string prompt)
         }
         else
         {
-            return Constants::DAYS_OF_WEEK[choice - 1];
+            return static_cast<DayOfWeek>(choice - 1);
         }
     }
 }
@@ -629,13 +616,13 @@ std::string UserInterface::promptDayOfWeek(const std::string prompt)
  * This function displays a menu of days of the week and prompts the user to select multiple days.
  * It validates the input to ensure each selected day is a number between 1 and 7.
  * If the input is invalid, it clears the error state and prompts again.
- * If the input is valid, it returns a comma-separated string of the corresponding day names for the user's input.
+ * If the input is valid, it returns the mask of the corresponding days.
  * 
  * @param prompt The prompt message to display.
  * 
- * @return The days of the week entered by the user.
+ * @return The mask of the days of the week entered by the user.
  */
-std::string UserInterface::promptDaysOfWeek(const std::string prompt)
+uint8_t UserInterface::promptDaysOfWeek(const std::string prompt)
 {
     while (true)
     {
@@ -655,7 +642,7 @@ std::string UserInterface::promptDaysOfWeek(const std::string prompt)
         }
 
         // Validate each token
-        std::vector<std::string> selectedDays;
+        uint8_t selectedDays = 0;
         bool isValid = true;
         for (const auto &choiceStr : tokens)
         {
@@ -668,7 +655,7 @@ std::string UserInterface::promptDaysOfWeek(const std::string prompt)
                     isValid = false;
                     break;
                 }
-                selectedDays.push_back(Constants::DAYS_OF_WEEK[choice - 1]);
+                selectedDays |= 1 << (choice - 1);
             }
             catch (const std::invalid_argument &)
             {
@@ -678,14 +665,9 @@ std::string UserInterface::promptDaysOfWeek(const std::string prompt)
             }
         }
 
-        if (isValid)
+        if (isValid && selectedDays != 0)
         {
-            // Join the selected days into a comma-separated string
-            std::string result = std::accumulate(
-                std::next(selectedDays.begin()), selectedDays.end(), selectedDays[0],
-                [](std::string a, const std::string &b) { return a + "," + b; });
-
-            return result;
+            return selectedDays;
         }
     }
 }
@@ -699,11 +681,10 @@ std::string UserInterface::promptDaysOfWeek(const std::string prompt)
  * 
  * @param prompt The prompt message to display.
  * 
- * @return The time entered by the user in HHMM format.
+ * @return The time entered by the user, before 2400.
  */
-std::string UserInterface::promptTime(const std::string prompt)
+MinuteOfDay UserInterface::promptTime(const std::string prompt)
 {
-    std::regex timeRegex(R"(^([01]\d|2[0-3])[0-5]\d$)");
     std::string timeStr;
 
     while (true)
@@ -711,13 +692,14 @@ std::string UserInterface::promptTime(const std::string prompt)
         std::cout << prompt;
         std::cin >> timeStr;
 
-        if (!std::regex_match(timeStr, timeRegex))
+        std::optional<MinuteOfDay> time = MinuteOfDay::parse(timeStr);
+        if (!time || *time == MinuteOfDay::endOfDay())
         {
             std::cout << "Invalid time format. Please enter a valid time between 0000 and 2359." << std::endl;
         }
         else
         {
-            return timeStr;
+            return *time;
         }
     }
 }
@@ -954,19 +936,303 @@ std::string UserInterface::generateBox(const std::vector<std::string> &content)
 /**
  * @brief Checks if the response indicates an error.
  * 
- * Every parsed response vector that corresponds to an error message will have "Error" as its first element.
- * Hence, this function checks if the first element of the parsed response vector is "Error" to determine whether the response is an error.
+ * Every parsed response carries the error reported by the server, so this function checks whether there is one.
  * 
- * @param parsedResponse The parsed response vector to check.
+ * @param error The error of the parsed response.
  * 
  * @return True if the response indicates an error, false otherwise.
  */
-bool UserInterface::isErrorResponse(const std::vector<std::string> &parsedResponse)
+bool UserInterface::isErrorResponse(const ResponseParser::Error &error)
 {
-    if (!parsedResponse.empty() && parsedResponse[0] == "Error")
+    if (error.failed())
     {
         std::cout << "Returning to main menu..." << std::endl;
         return true;
     }
     return false;
 }
+
+/**
+ * @brief Formats a day of a parsed response for display.
+ *
+ * @param day The day, or nothing if the response had none or it was not a valid day.
+ *
+ * @return The day name, or an empty string.
+ */
+std::string UserInterface::formatDay(const std::optional<DayOfWeek> &day)
+{
+    return day ? std::string(Days::name(*day)) : "";
+}
+
+/**
+ * @brief Formats a time of a parsed response for display.
+ *
+ * @param time The time, or nothing if the response had none or it was not a valid time.
+ *
+ * @return The time in HHMM format, or an empty string.
+ */
+std::string UserInterface::formatTime(const std::optional<MinuteOfDay> &time)
+{
+    return time ? time->format() : "";
+}
+
+/**
+ * @brief Records the parse phase of a response in the statistics and the trace of the client.
+ * 
+ * @param requestType The request type of the operation that received the response.
+ * @param parseStart The start of the parse.
+ * @param parseEnd The end of the parse.
+ */
+void UserInterface::recordParse(int requestType, ClientStats::Clock::time_point parseStart, ClientStats::Clock::time_point parseEnd)
+{
+    if (ClientStats *stats = client.getStats())
+    {
+        stats->recordPhase(requestType, ClientStats::PARSE, parseEnd - parseStart);
+    }
+    if (Tracer *tracer = client.getTracer())
+    {
+        tracer->record(ClientStats::getPhaseName(ClientStats::PARSE), parseStart, parseEnd, -1, requestType);
+    }
+}
+
+/**
+ * @brief Formats an error for display.
+ * 
+ * @param error The error.
+ * 
+ * @return The lines of the box, headed "Error" and followed by the message of the server.
+ */
+std::vector<std::string> UserInterface::formatError(const ResponseParser::Error &error)
+{
+    return {"Error", error.message};
+}
+
+/**
+ * @brief Formats facility names for display.
+ * 
+ * @param facilityList The parsed facility names.
+ * 
+ * @return The lines of the box, one per facility, or the error.
+ */
+std::vector<std::string> UserInterface::formatFacilityList(const ResponseParser::FacilityList &facilityList)
+{
+    if (facilityList.error.failed())
+    {
+        return formatError(facilityList.error);
+    }
+
+    std::vector<std::string> content = {"Facility Names"};
+    content.insert(content.end(), facilityList.names.begin(), facilityList.names.end());
+    return content;
+}
+
+/**
+ * @brief Formats the availability of a facility for display.
+ * 
+ * Each day is shown on one line with its free periods, such as "MONDAY: 0800 to 0900, 1000 to 1200".
+ * If every day was parsed, every day the server listed is shown. If the availability was parsed for some days
+ * only, only those are shown, and those the server did not list are shown as closed.
+ * 
+ * @param availability The parsed availability.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatAvailability(const ResponseParser::Availability &availability)
+{
+    if (availability.error.failed())
+    {
+        return formatError(availability.error);
+    }
+
+    std::vector<std::string> content = {"Facility Availability"};
+    if (!availability.facility.empty())
+    {
+        content.push_back("Facility: " + availability.facility);
+    }
+
+    bool filterDays = availability.requestedDays != Constants::ALL_DAYS_MASK; // Only show closed days if some days were requested
+
+    for (int dayIndex = 0; dayIndex < Constants::DAYS_PER_WEEK; ++dayIndex)
+    {
+        DayOfWeek day = static_cast<DayOfWeek>(dayIndex);
+        if (!(availability.requestedDays & Days::bit(day)))
+        {
+            continue;
+        }
+
+        std::string line(Days::name(day));
+        if (!availability.isListed(day))
+        {
+            if (filterDays)
+            {
+                content.push_back(line + ": Closed");
+            }
+            continue;
+        }
+
+        std::vector<ResponseParser::Timeslot> timeslots = availability.timeslots(day);
+        for (size_t i = 0; i < timeslots.size(); ++i)
+        {
+            line += (i == 0 ? ": " : ", ") + timeslots[i].start.format() + " to " + timeslots[i].end.format();
+        }
+        content.push_back(line);
+    }
+
+    return content;
+}
+
+/**
+ * @brief Formats a booking for display.
+ * 
+ * @param booking The parsed booking.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatBooking(const ResponseParser::Booking &booking)
+{
+    if (booking.error.failed())
+    {
+        return formatError(booking.error);
+    }
+
+    return {
+        "Booking Details",
+        "Booking ID: " + booking.bookingID,
+        "User: " + booking.user,
+        "Facility: " + booking.facility,
+        "Day: " + formatDay(booking.day),
+        "Start Time: " + formatTime(booking.start),
+        "End Time: " + formatTime(booking.end)
+    };
+}
+
+/**
+ * @brief Formats an updated booking for display.
+ * 
+ * @param booking The parsed updated booking.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatUpdatedBooking(const ResponseParser::Booking &booking)
+{
+    if (booking.error.failed())
+    {
+        return formatError(booking.error);
+    }
+
+    return {
+        "New Booking Details",
+        "New Booking ID: " + booking.bookingID,
+        "User: " + booking.user,
+        "Facility: " + booking.facility,
+        "New Day: " + formatDay(booking.day),
+        "New Start Time: " + formatTime(booking.start),
+        "New End Time: " + formatTime(booking.end)
+    };
+}
+
+/**
+ * @brief Formats a deleted booking for display.
+ * 
+ * @param booking The parsed deleted booking.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatDeletedBooking(const ResponseParser::Booking &booking)
+{
+    if (booking.error.failed())
+    {
+        return formatError(booking.error);
+    }
+
+    return {
+        "Booking Deleted",
+        "Old Booking ID: " + booking.bookingID,
+        "User: " + booking.user
+    };
+}
+
+/**
+ * @brief Formats a monitoring registration for display.
+ * 
+ * @param registration The parsed registration.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatMonitorRegistration(const ResponseParser::MonitorRegistration &registration)
+{
+    if (registration.error.failed())
+    {
+        return formatError(registration.error);
+    }
+
+    return {
+        "Monitoring Registration",
+        "Facility: " + registration.facility,
+        "Duration: " + std::to_string(registration.intervalSeconds) + "s"
+    };
+}
+
+/**
+ * @brief Formats the confirmation of a rating for display.
+ * 
+ * @param rating The parsed rating added.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatRatingAdded(const ResponseParser::Rating &rating)
+{
+    if (rating.error.failed())
+    {
+        return formatError(rating.error);
+    }
+
+    char ratingText[32];
+    snprintf(ratingText, sizeof(ratingText), "%.1f", rating.rating);
+
+    return {
+        "Rating Added",
+        "User: " + rating.user,
+        "Facility: " + rating.facility,
+        "Rating: " + std::string(ratingText)
+    };
+}
+
+/**
+ * @brief Formats the rating of a facility for display.
+ * 
+ * @param rating The parsed rating.
+ * 
+ * @return The lines of the box, or the error.
+ */
+std::vector<std::string> UserInterface::formatRating(const ResponseParser::Rating &rating)
+{
+    if (rating.error.failed())
+    {
+        return formatError(rating.error);
+    }
+
+    char ratingText[32];
+    snprintf(ratingText, sizeof(ratingText), "%.1f", rating.rating);
+
+    return {
+        "Facility Rating",
+        "Facility: " + rating.facility,
+        "Rating: " + std::string(ratingText)
+    };
+}
+
+/**
+ * @brief Formats an echoed message for display.
+ * 
+ * @param message The echoed message.
+ * 
+ * @return The lines of the box.
+ */
+std::vector<std::string> UserInterface::formatEchoMessage(const std::string &message)
+{
+    return {
+        "Response from Server",
+        "Message: " + message
+    };
+}
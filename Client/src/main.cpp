@@ -4,15 +4,7 @@
 #include "Serializer.hpp"
 #include "UserInterface.hpp"
 
-void registerClasses()
-{
-    ObjectFactory::creators["Server.RequestMessage"] = []()
-    {
-        return std::make_shared<RequestMessage>();
-    };
-}
-
-int main()
+int main(int argc, char *argv[])
 {
     std::string serverIP;
     int serverPort;
@@ -20,11 +12,18 @@ int main()
     serverIP = UserInterface::promptServerIP("Enter server IP (IPv4 format or 'localhost'): ");
     serverPort = UserInterface::promptServerPort("Enter server port: ");
 
-    registerClasses();
+    ObjectFactory::registerMessageClasses();
 
     try
     {
-        Client client(serverIP, serverPort);
+        // An optional argument names the request journal, and requests left pending by the last run are resent
+        std::string journalPath = argc > 1 ? argv[1] : "";
+        Client client(serverIP, serverPort, journalPath);
+        for (const std::string &response : client.replayJournal())
+        {
+            std::cout << "Resent pending request:\n" << response << std::endl;
+        }
+
         UserInterface ui(client);
         ui.displayMenu();
     }
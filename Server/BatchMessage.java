@@ -0,0 +1,61 @@
+package Server;
+
+/**
+ * BatchMessage class carries several RequestMessages in a single datagram.
+ * The server replies to a batch with a BatchMessage of the same batch ID,
+ * holding the response to each request in the same order.
+ */
+public class BatchMessage {
+  private int batchID; // Unique identifier for the batch, echoed in the reply
+  private RequestMessage[] requests; // Requests carried by the batch, or their responses
+
+  /**
+   * Default constructor required for deserialization.
+   */
+  public BatchMessage() {
+  }
+
+  /**
+   * Constructor to initialize a BatchMessage with specific values.
+   * 
+   * @param batchID  The unique identifier for the batch.
+   * @param requests The requests carried by the batch.
+   */
+  public BatchMessage(int batchID, RequestMessage[] requests) {
+    this.batchID = batchID;
+    this.requests = requests;
+  }
+
+  /**
+   * Converts the BatchMessage object to a string representation.
+   * 
+   * @return A string containing the batch ID and each request.
+   */
+  public String toString() {
+    StringBuilder builder = new StringBuilder("BatchMessage: " + this.batchID);
+    if (this.requests != null) {
+      for (RequestMessage request : this.requests) {
+        builder.append("\n  ").append(request);
+      }
+    }
+    return builder.toString();
+  }
+
+  /**
+   * Gets the unique identifier for the batch.
+   * 
+   * @return The batch ID.
+   */
+  public int getBatchID() {
+    return this.batchID;
+  }
+
+  /**
+   * Gets the requests carried by the batch.
+   * 
+   * @return The requests in batch order.
+   */
+  public RequestMessage[] getRequests() {
+    return this.requests;
+  }
+}
@@ -4,11 +4,18 @@ package Server;
  * RequestMessage class represents a message sent between the client and server.
  * It contains the type of request, a unique request ID, and any associated
  * data.
+ * Requests also carry a globally unique identity made of a client nonce, an
+ * epoch and a sequence number, which the server uses to detect duplicates
+ * independently of the client's address and port.
  */
 public class RequestMessage {
   private int requestType; // Type of the request (e.g., READ, WRITE, etc.)
   private int requestID; // Unique identifier for the request
   private String data; // Additional data associated with the request
+  private long clientNonce; // Random identifier of the client instance, or 0 if the request has no identity
+  private int epoch; // Run of the client instance that sent the request
+  private long sequence; // Number of the request within the epoch
+  private long ackedSequence; // Sequence up to which the client has received or given up every reply of the epoch
 
   /**
    * Default constructor required for deserialization.
@@ -73,4 +80,51 @@ public class RequestMessage {
   public String getData() {
     return this.data;
   }
+
+  /**
+   * Gets the random identifier of the client instance that sent the request.
+   * 
+   * @return The client nonce, or 0 if the request has no identity.
+   */
+  public long getClientNonce() {
+    return this.clientNonce;
+  }
+
+  /**
+   * Gets the run of the client instance that sent the request.
+   * 
+   * @return The epoch.
+   */
+  public int getEpoch() {
+    return this.epoch;
+  }
+
+  /**
+   * Gets the number of the request within its epoch.
+   * 
+   * @return The sequence number.
+   */
+  public long getSequence() {
+    return this.sequence;
+  }
+
+  /**
+   * Gets the cumulative acknowledgement carried by the request: the client has
+   * received or given up the replies to all of its requests in the same epoch up
+   * to this sequence number, and will not send them again.
+   * 
+   * @return The acknowledged sequence number, or 0 if there is none.
+   */
+  public long getAckedSequence() {
+    return this.ackedSequence;
+  }
+
+  /**
+   * Checks whether the request carries a globally unique identity.
+   * 
+   * @return True if the client nonce is set, false otherwise.
+   */
+  public boolean hasIdentity() {
+    return this.clientNonce != 0;
+  }
 }
@@ -39,6 +39,9 @@ public class Server {
   // Simulate 6s (6000ms) processing delay
   private static final int PROCESSING_DELAY_MS = 2000;
 
+  // Largest UDP payload, so that batched requests are never truncated
+  private static final int MAX_DATAGRAM_SIZE = 65507;
+
   // Service classes for managing facilities, request history, and monitoring
   private static MonitorService facilityMonitorService;
   private static RequestHistory requestHistory;
@@ -80,7 +83,7 @@ public class Server {
     try {
       // Bind the UDP socket to port 6789
       aSocket = new DatagramSocket(6789);
-      byte[] buffer = new byte[1000]; // Buffer for receiving data
+      byte[] buffer = new byte[MAX_DATAGRAM_SIZE]; // Buffer for receiving data
 
       System.out.println("UDP Server is running on port 6789...");
       while (true) {
@@ -104,7 +107,7 @@ public class Server {
         }
 
         // Handle the request and generate a response
-        RequestMessage responseMessage = handleRequest(request);
+        Object responseMessage = handleRequest(request);
         System.out.println("\n------------CURRENT REQUEST HISTORY------------");
         System.out.println(requestHistory.toString() + "\n");
         System.out.println("------------END OF REQUEST HISTORY------------");
@@ -173,16 +176,17 @@ public class Server {
   }
 
   /**
-   * Handles incoming client requests and processes them based on the operation
-   * type.
+   * Handles an incoming datagram, which holds either a single RequestMessage or
+   * a BatchMessage of several.
+   * The processing delay is paid once per datagram, and the requests of a batch
+   * are processed in order.
    * 
    * @param request DatagramPacket containing the client's request.
-   * @return RequestMessage response to be sent back to the client.
+   * @return RequestMessage or BatchMessage response to be sent back to the
+   *         client.
    */
-  public static RequestMessage handleRequest(DatagramPacket request) {
-    RequestMessage requestMessage = null;
-    RequestMessage responseMessage = null;
-    lastUpdatedFacility = null;
+  public static Object handleRequest(DatagramPacket request) {
+    Object message = null;
 
     // Simulate processing delay to mimic real-world server behavior
     try {
@@ -197,13 +201,48 @@ public class Server {
     try {
       byte[] receivedData = new byte[request.getLength()];
       System.arraycopy(request.getData(), request.getOffset(), receivedData, 0, request.getLength());
-      requestMessage = (RequestMessage) Serializer.deserialize(receivedData);
-      System.out.println("Request received: " + requestMessage.toString());
+      message = Serializer.deserialize(receivedData);
+      System.out.println("Request received: " + message.toString());
     } catch (Exception e) {
       System.err.println("Error deserializing request: " + e.getMessage());
+    }
 
-      responseMessage = new RequestMessage(Operation.READ.getOpCode(), 0, "status:ERROR\nmessage:Bad request");
-      return responseMessage;
+    // Reply to a batch with a batch holding the response to each of its requests
+    if (message instanceof BatchMessage) {
+      BatchMessage batchMessage = (BatchMessage) message;
+      RequestMessage[] requests = batchMessage.getRequests();
+      RequestMessage[] responses = new RequestMessage[requests == null ? 0 : requests.length];
+      for (int i = 0; i < responses.length; i++) {
+        responses[i] = processRequest(requests[i], request.getAddress(), request.getPort());
+      }
+      return new BatchMessage(batchMessage.getBatchID(), responses);
+    }
+
+    if (!(message instanceof RequestMessage)) {
+      return new RequestMessage(Operation.READ.getOpCode(), 0, "status:ERROR\nmessage:Bad request");
+    }
+
+    return processRequest((RequestMessage) message, request.getAddress(), request.getPort());
+  }
+
+  /**
+   * Processes a single client request based on its operation type.
+   * 
+   * @param requestMessage The request to process.
+   * @param clientAddress  The address of the client that sent the request.
+   * @param clientPort     The port of the client that sent the request.
+   * @return RequestMessage response to be sent back to the client.
+   */
+  private static RequestMessage processRequest(RequestMessage requestMessage, InetAddress clientAddress,
+      int clientPort) {
+    RequestMessage responseMessage = null;
+    lastUpdatedFacility = null;
+
+    // Forget the replies the client has acknowledged, as it will never retransmit those requests
+    int evicted = requestHistory.acknowledge(requestMessage);
+    if (evicted > 0) {
+      System.out.println("Evicted " + evicted + " acknowledged requests from history, " + requestHistory.size()
+          + " remaining");
     }
 
     // Handle ECHO operation (no processing required)
@@ -217,9 +256,17 @@ public class Server {
       System.out.println("Checking request history...");
       RequestInfo requestInformation = new RequestInfo(
           requestMessage,
-          request.getAddress(),
-          request.getPort(),
+          clientAddress,
+          clientPort,
           null);
+      // Copies of acknowledged requests may arrive late, after their replies were evicted
+      if (requestHistory.isAcknowledged(requestMessage)) {
+        System.out.printf("EXPIRED %s request id %d rejected-------------------------------------------------------\n",
+            requestMessage.getOperation(), requestMessage.getRequestID());
+        return new RequestMessage(requestMessage.getOperation().getOpCode(), requestMessage.getRequestID(),
+            "status:ERROR\nmessage:Request already acknowledged");
+      }
+
       RequestInfo prevRequest = requestHistory.containsRequest(requestInformation);
       if (prevRequest != null) {
         System.out.printf("DUPLICATE %s request id %d detected------------------------------------------------------\n", requestMessage.getOperation(),
@@ -317,7 +364,7 @@ public class Server {
         // For book facility request, format:
         // facilityName,day,startHour,startMinute,endHour,endMinute
         try {
-          responseMessage = bookFacility(requestMessage, request.getAddress(), request.getPort());
+          responseMessage = bookFacility(requestMessage, clientAddress, clientPort);
         } catch (Exception e) {
           responseMessage = new RequestMessage(Operation.WRITE.getOpCode(), requestMessage.getRequestID(),
               "status:ERROR\nmessage:" + e.getMessage());
@@ -337,12 +384,12 @@ public class Server {
 
           // Updating an existing booking
           if (updateType.equals("booking")) {
-            responseMessage = updateBooking(requestMessage, request.getAddress(), request.getPort());
+            responseMessage = updateBooking(requestMessage, clientAddress, clientPort);
           }
 
           // Updating a Facility rating
           else if (updateType.equals("rating")) {
-            responseMessage = addRating(requestMessage, request.getAddress(), request.getPort());
+            responseMessage = addRating(requestMessage, clientAddress, clientPort);
           }
 
           // Invalid update type
@@ -365,7 +412,7 @@ public class Server {
         // Handle DELETE operations (e.g., delete booking)
         try {
           // Delete booking. Expected format: "<bookingId>,<facilityName>"
-          responseMessage = deleteBooking(requestMessage, request.getAddress(), request.getPort());
+          responseMessage = deleteBooking(requestMessage, clientAddress, clientPort);
 
         } catch (Exception e) {
           responseMessage = new RequestMessage(
@@ -398,8 +445,8 @@ public class Server {
               break;
             }
 
-            Monitor clientMonitor = new Monitor(facilityName, requestMessage.getRequestID(), request.getAddress(),
-                request.getPort(), monitorInterval);
+            Monitor clientMonitor = new Monitor(facilityName, requestMessage.getRequestID(), clientAddress,
+                clientPort, monitorInterval);
 
             facilityMonitorService.registerMonitor(clientMonitor);
             responseMessage = new RequestMessage(
@@ -430,8 +477,8 @@ public class Server {
     // Save the request and response to the history for at-most-once semantics
     RequestInfo currentRequestInformation = new RequestInfo(
         requestMessage,
-        request.getAddress(),
-        request.getPort(),
+        clientAddress,
+        clientPort,
         responseMessage);
     requestHistory.addRequest(currentRequestInformation);
 
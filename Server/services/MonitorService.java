@@ -7,6 +7,7 @@ import java.util.logging.Logger;
 
 import Server.Operation;
 import Server.RequestMessage;
+import Server.utils.Serializer;
 
 /**
  * MonitorService class manages all monitors registered by clients.
@@ -50,9 +51,15 @@ public class MonitorService {
    * @param message      The notification message to send.
    */
   public void notifyAll(DatagramSocket socket, String facilityName, String message) {
-    // Create the notification message
+    // Create the notification message, serialized like any other reply so that clients can decode it
     RequestMessage notificationMessage = new RequestMessage(Operation.READ.getOpCode(), 0, message);
-    byte[] notificationBuffer = notificationMessage.toString().getBytes();
+    byte[] notificationBuffer;
+    try {
+      notificationBuffer = Serializer.serialize(notificationMessage);
+    } catch (Exception e) {
+      LOGGER.severe("Error serializing notification for " + facilityName + ".\n" + e.getMessage());
+      return;
+    }
 
     // Send notification to all monitors
     for (Monitor monitor : this.monitors) {
@@ -1,21 +1,38 @@
 package Server.services;
 
 import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.LinkedHashMap;
+import java.util.NavigableSet;
+import java.util.TreeSet;
+
+import Server.RequestMessage;
 
 /**
  * RequestHistory class is used to store and manage client requests.
  * It prevents duplicate requests for non-idempotent operations by maintaining a
  * history of requests.
  * It supports adding, checking, and updating requests in the history.
+ * Requests are indexed by their RequestKey, so lookups take constant time
+ * regardless of the size of the history.
+ * Clients acknowledge the replies they have received cumulatively, and
+ * acknowledged requests are evicted, so the history only holds requests that
+ * may still be retransmitted. The highest acknowledged sequence of each client
+ * epoch is kept as its floor, so that a delayed or duplicated copy of an evicted
+ * request is still recognised and not run again.
  */
 public class RequestHistory {
-  private ArrayList<RequestInfo> requestHistory; // List to store request information
+  private LinkedHashMap<RequestKey, RequestInfo> requestHistory; // Request information in arrival order, by key
+  private HashMap<RequestKey, TreeSet<Long>> sequencesByClient; // Sequence numbers in the history, by client epoch
+  private HashMap<RequestKey, Long> ackedFloors; // Highest acknowledged sequence number, by client epoch
 
   /**
    * Constructor to initialize the RequestHistory object.
    */
   public RequestHistory() {
-    this.requestHistory = new ArrayList<RequestInfo>();
+    this.requestHistory = new LinkedHashMap<RequestKey, RequestInfo>();
+    this.sequencesByClient = new HashMap<RequestKey, TreeSet<Long>>();
+    this.ackedFloors = new HashMap<RequestKey, Long>();
   }
 
   /**
@@ -24,7 +41,81 @@ public class RequestHistory {
    * @param request RequestInfo object to add to the history.
    */
   public void addRequest(RequestInfo request) {
-    this.requestHistory.add(request);
+    this.requestHistory.put(RequestKey.of(request), request);
+
+    RequestMessage message = request.requestMessage;
+    if (message.hasIdentity()) {
+      RequestKey clientKey = RequestKey.forIdentity(message.getClientNonce(), message.getEpoch(), 0);
+      TreeSet<Long> sequences = this.sequencesByClient.get(clientKey);
+      if (sequences == null) {
+        sequences = new TreeSet<Long>();
+        this.sequencesByClient.put(clientKey, sequences);
+      }
+      sequences.add(message.getSequence());
+    }
+  }
+
+  /**
+   * Evict the requests acknowledged by a request from the history.
+   * These are the requests of the same client epoch with a sequence number up to
+   * the acknowledged one, which the client no longer waits for. The floor of the
+   * client epoch is raised to the acknowledged sequence number, so that copies of
+   * these requests still in the network are rejected by isAcknowledged().
+   * 
+   * @param message The request carrying the acknowledgement.
+   * @return The number of evicted requests.
+   */
+  public int acknowledge(RequestMessage message) {
+    if (!message.hasIdentity() || message.getAckedSequence() <= 0) {
+      return 0;
+    }
+
+    RequestKey clientKey = RequestKey.forIdentity(message.getClientNonce(), message.getEpoch(), 0);
+    this.ackedFloors.merge(clientKey, message.getAckedSequence(), Math::max);
+
+    TreeSet<Long> sequences = this.sequencesByClient.get(clientKey);
+    if (sequences == null) {
+      return 0;
+    }
+
+    NavigableSet<Long> acknowledged = sequences.headSet(message.getAckedSequence(), true);
+    int evicted = acknowledged.size();
+    for (long sequence : acknowledged) {
+      this.requestHistory.remove(RequestKey.forIdentity(message.getClientNonce(), message.getEpoch(), sequence));
+    }
+    acknowledged.clear();
+
+    if (sequences.isEmpty()) {
+      this.sequencesByClient.remove(clientKey);
+    }
+    return evicted;
+  }
+
+  /**
+   * Check if a request has been acknowledged by its client, i.e. if its sequence
+   * number is at most the floor of its client epoch. Such a request was already
+   * handled or given up, and its reply may have been evicted, so it must not be
+   * run again.
+   * 
+   * @param message The request to check.
+   * @return True if the request carries an identity and has been acknowledged.
+   */
+  public boolean isAcknowledged(RequestMessage message) {
+    if (!message.hasIdentity()) {
+      return false;
+    }
+
+    Long floor = this.ackedFloors.get(RequestKey.forIdentity(message.getClientNonce(), message.getEpoch(), 0));
+    return floor != null && message.getSequence() <= floor;
+  }
+
+  /**
+   * Get the number of requests in the history.
+   * 
+   * @return The number of requests.
+   */
+  public int size() {
+    return this.requestHistory.size();
   }
 
   /**
@@ -34,14 +125,7 @@ public class RequestHistory {
    * @return The matching RequestInfo object if found, null otherwise.
    */
   public RequestInfo containsRequest(RequestInfo requestInfo) {
-    for (RequestInfo r : this.requestHistory) {
-      if (r.requestMessage.getRequestID() == requestInfo.requestMessage.getRequestID() &&
-          r.clientAddress.equals(requestInfo.clientAddress) &&
-          r.clientPort == requestInfo.clientPort) {
-        return r;
-      }
-    }
-    return null;
+    return this.requestHistory.get(RequestKey.of(requestInfo));
   }
 
   /**
@@ -53,16 +137,14 @@ public class RequestHistory {
    *         otherwise.
    */
   public RequestInfo containsAndReplace(RequestInfo requestInfo) {
-    RequestInfo r = null;
-    for (int i = 0; i < this.requestHistory.size(); i++) {
-      r = this.requestHistory.get(i);
-
+    for (RequestInfo r : new ArrayList<RequestInfo>(this.requestHistory.values())) {
       // If there is a request from the same client in the history
       if (r.clientAddress.equals(requestInfo.clientAddress) &&
           r.clientPort == requestInfo.clientPort) {
         // If the new request id is higher, replace the request
         if (r.requestMessage.getRequestID() < requestInfo.requestMessage.getRequestID()) {
-          this.requestHistory.set(i, requestInfo);
+          this.requestHistory.remove(RequestKey.of(r));
+          addRequest(requestInfo);
           return null;
         }
         // If the new request id is lower, return the previous request info for handling
@@ -80,16 +162,13 @@ public class RequestHistory {
    * @return True if the update was successful, false otherwise.
    */
   public boolean updateRequestInfo(RequestInfo requestInfo) {
-    for (RequestInfo r : this.requestHistory) {
-      if (r.requestMessage.getRequestID() == requestInfo.requestMessage.getRequestID() &&
-          r.clientAddress.equals(requestInfo.clientAddress) &&
-          r.clientPort == requestInfo.clientPort) {
-        // update the previous request here.
-        r.responseMessage = requestInfo.responseMessage;
-        return true;
-      }
+    RequestInfo r = this.requestHistory.get(RequestKey.of(requestInfo));
+    if (r == null) {
+      return false;
     }
-    return false;
+    // update the previous request here.
+    r.responseMessage = requestInfo.responseMessage;
+    return true;
   }
 
   /**
@@ -99,7 +178,7 @@ public class RequestHistory {
    */
   public String toString() {
     String str = "Request History: \n";
-    for (RequestInfo r : this.requestHistory) {
+    for (RequestInfo r : this.requestHistory.values()) {
       str += r.toString() + ";\n";
     }
     return str;
@@ -0,0 +1,83 @@
+package Server.services;
+
+import java.net.InetAddress;
+import java.util.Objects;
+
+import Server.RequestMessage;
+
+/**
+ * RequestKey class is the key under which a request is stored in the
+ * RequestHistory.
+ * Requests with an identity are keyed by their client nonce, epoch and
+ * sequence number, which are unique across clients and do not wrap.
+ * Requests without one, from older clients, fall back to the client's address,
+ * port and request ID.
+ */
+public final class RequestKey {
+  private final long clientNonce; // Random identifier of the client instance, or 0 for the fallback key
+  private final int epoch; // Run of the client instance
+  private final long sequence; // Number of the request within the epoch
+  private final InetAddress clientAddress; // The address of the client, for the fallback key only
+  private final int clientPort; // The port of the client, for the fallback key only
+  private final int requestID; // The request ID, for the fallback key only
+
+  private RequestKey(long clientNonce, int epoch, long sequence, InetAddress clientAddress, int clientPort,
+      int requestID) {
+    this.clientNonce = clientNonce;
+    this.epoch = epoch;
+    this.sequence = sequence;
+    this.clientAddress = clientAddress;
+    this.clientPort = clientPort;
+    this.requestID = requestID;
+  }
+
+  /**
+   * Creates the key of the request with the given identity.
+   *
+   * @param clientNonce The random identifier of the client instance.
+   * @param epoch       The run of the client instance.
+   * @param sequence    The number of the request within the epoch, or 0 for the
+   *                    key of the client's epoch as a whole.
+   * @return The key.
+   */
+  public static RequestKey forIdentity(long clientNonce, int epoch, long sequence) {
+    return new RequestKey(clientNonce, epoch, sequence, null, 0, 0);
+  }
+
+  /**
+   * Creates the key of a request.
+   *
+   * @param requestInfo RequestInfo object holding the request and its sender.
+   * @return The key of the request.
+   */
+  public static RequestKey of(RequestInfo requestInfo) {
+    RequestMessage request = requestInfo.requestMessage;
+    if (request.hasIdentity()) {
+      return forIdentity(request.getClientNonce(), request.getEpoch(), request.getSequence());
+    }
+    return new RequestKey(0, 0, 0, requestInfo.clientAddress, requestInfo.clientPort, request.getRequestID());
+  }
+
+  @Override
+  public boolean equals(Object other) {
+    if (this == other) {
+      return true;
+    }
+    if (!(other instanceof RequestKey)) {
+      return false;
+    }
+    RequestKey key = (RequestKey) other;
+    return this.clientNonce == key.clientNonce &&
+        this.epoch == key.epoch &&
+        this.sequence == key.sequence &&
+        Objects.equals(this.clientAddress, key.clientAddress) &&
+        this.clientPort == key.clientPort &&
+        this.requestID == key.requestID;
+  }
+
+  @Override
+  public int hashCode() {
+    return Objects.hash(this.clientNonce, this.epoch, this.sequence, this.clientAddress, this.clientPort,
+        this.requestID);
+  }
+}
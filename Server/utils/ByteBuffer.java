@@ -25,6 +25,10 @@ public class ByteBuffer {
      * @param value The byte to write.
      */
     public void writeByte(byte value) {
+        // Grow the buffer so that large messages such as batches fit
+        if (position == buffer.length) {
+            buffer = java.util.Arrays.copyOf(buffer, buffer.length * 2);
+        }
         buffer[position++] = value;
     }
 